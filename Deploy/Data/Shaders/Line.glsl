@@ -0,0 +1,30 @@
+#version 330
+
+#if defined(VERTEX_SHADER)
+    layout(location = 0) in vec2 vertexPosition;
+    layout(location = 1) in vec4 vertexColor;
+
+    out vec4 fragmentColor;
+
+    layout(std140) uniform FrameConstants
+    {
+        mat4 viewTransform;
+    };
+
+    void main()
+    {
+        // Output a vertex.
+        gl_Position   = viewTransform * vec4(vertexPosition, 0.0f, 1.0f);
+        fragmentColor = vertexColor;
+    }
+#endif
+
+#if defined(FRAGMENT_SHADER)
+    in  vec4 fragmentColor;
+    out vec4 finalColor;
+
+    void main()
+    {
+        finalColor = fragmentColor;
+    }
+#endif
@@ -5,12 +5,18 @@
     layout(location = 1) in vec2 vertexTexture;
     layout(location = 2) in mat4 instanceTransform;
     layout(location = 6) in vec4 instanceRectangle;
-    layout(location = 7) in vec4 instanceColor;
+    layout(location = 7) in vec4 instanceDiffuseColor;
+    layout(location = 8) in vec4 instanceEmissiveColor;
+    layout(location = 9) in float instanceEmissivePower;
 
     out vec2 fragmentTexture;
     out vec4 fragmentColor;
 
-    uniform mat4 viewTransform;
+    layout(std140) uniform FrameConstants
+    {
+        mat4 viewTransform;
+    };
+
     uniform vec2 textureSizeInv;
 
     void main()
@@ -33,10 +39,13 @@
         // Move texture origin from top left corner to bottom left.
         texture.y -= instanceRectangle.w * textureSizeInv.y;
 
+        // Blend diffuse and emissive colors.
+        vec4 color = mix(instanceDiffuseColor, instanceEmissiveColor, instanceEmissivePower);
+
         // Output a vertex.
         gl_Position     = position;
         fragmentTexture = texture;
-        fragmentColor   = instanceColor;
+        fragmentColor   = color;
     }
 #endif
 
@@ -58,7 +58,23 @@ namespace Utility
     // Replace all occurances of text in a string with a replacement text.
     std::string StringReplace(const std::string& source, std::string search, std::string replacement);
 
+    // Calculates a hash of a string using the FNV-1a algorithm.
+    // Can be evaluated at compile time for string literals.
+    constexpr uint32_t StringHash(const char* text)
+    {
+        uint32_t hash = 2166136261u;
+
+        while(*text != '\0')
+        {
+            hash ^= (uint8_t)*text++;
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
     // Reorders a vector using given indices.
+    // Value at each position is taken from the index at the same position of the order.
     template<typename Type>
     void Reorder(std::vector<Type>& values, const std::vector<std::size_t>& order)
     {
@@ -68,23 +84,31 @@ namespace Utility
         if(values.empty())
             return;
 
-        // Create an array of indices.
-        std::vector<std::size_t> indices(order.size());
-        std::iota(indices.begin(), indices.end(), 0);
+        // Rearrange the values by following cycles of the permutation.
+        // Each value is moved once, in linear time.
+        std::vector<bool> placed(values.size(), false);
 
-        // Rearange the values.
-        for(std::size_t i = 0; i < values.size() - 1; ++i)
+        for(std::size_t i = 0; i < values.size(); ++i)
         {
-            std::size_t desired = order[i];
+            if(placed[i])
+                continue;
+
+            Type value = std::move(values[i]);
+            std::size_t current = i;
 
-            for(std::size_t j = i; j < values.size(); ++j)
+            while(true)
             {
-                if(desired == indices[j])
+                std::size_t source = order[current];
+                placed[current] = true;
+
+                if(source == i)
                 {
-                    std::swap(values[i], values[j]);
-                    std::swap(indices[i], indices[j]);
+                    values[current] = std::move(value);
                     break;
                 }
+
+                values[current] = std::move(values[source]);
+                current = source;
             }
         }
     }
@@ -0,0 +1,79 @@
+#include "Precompiled.hpp"
+#include "AnimationComponent.hpp"
+#include "RenderComponent.hpp"
+#include "Graphics/Animation.hpp"
+using namespace Game::Components;
+
+Animation::Animation() :
+    m_time(0.0f),
+    m_speed(1.0f),
+    m_frame(0),
+    m_playing(false),
+    m_frameDirty(false),
+    m_finished(false),
+    m_render(nullptr)
+{
+}
+
+Animation::~Animation()
+{
+}
+
+void Animation::SetAnimation(AnimationPtr animation)
+{
+    m_animation = animation;
+
+    m_time = 0.0f;
+    m_frame = 0;
+    m_frameDirty = true;
+}
+
+void Animation::Play()
+{
+    m_time = 0.0f;
+    m_frame = 0;
+    m_playing = true;
+    m_frameDirty = true;
+}
+
+void Animation::Pause()
+{
+    m_playing = false;
+}
+
+void Animation::Resume()
+{
+    m_playing = true;
+}
+
+void Animation::SetSpeed(float speed)
+{
+    Verify(speed >= 0.0f, "Invalid argument - \"speed\" cannot be negative!");
+
+    m_speed = speed;
+}
+
+const Animation::AnimationPtr& Animation::GetAnimation() const
+{
+    return m_animation;
+}
+
+std::size_t Animation::GetFrameIndex() const
+{
+    return m_frame;
+}
+
+float Animation::GetSpeed() const
+{
+    return m_speed;
+}
+
+bool Animation::IsPlaying() const
+{
+    return m_playing;
+}
+
+Render* Animation::GetRender()
+{
+    return m_render;
+}
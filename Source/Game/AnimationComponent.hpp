@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Component.hpp"
+
+// Forward declarations.
+namespace Graphics
+{
+    class Animation;
+}
+
+namespace Game
+{
+    class AnimationSystem;
+}
+
+/*
+    Animation Component
+
+    Plays a flipbook animation on the entity's render component. Playback
+    is advanced by the animation system, which writes the rectangle of the
+    current frame to the render component, so scripts do not have to touch
+    it every frame. Scripts are notified when an animation that does not
+    loop finishes.
+
+    void ExampleAnimationComponent(Components::Animation* animation)
+    {
+        // Play an animation from its first frame.
+        animation->SetAnimation(resourceManager.Load<Graphics::Animation>("Data/Animations/Run.anim"));
+        animation->Play();
+    }
+*/
+
+namespace Game
+{
+    namespace Components
+    {
+        // Forward declarations.
+        class Render;
+
+        // Animation component class.
+        class Animation : public Component
+        {
+        public:
+            // Type declarations.
+            typedef std::shared_ptr<const Graphics::Animation> AnimationPtr;
+
+            // Friend declarations.
+            friend AnimationSystem;
+
+        public:
+            Animation();
+            ~Animation();
+
+            // Sets the animation.
+            // Playback is rewound to the first frame.
+            void SetAnimation(AnimationPtr animation);
+
+            // Starts playing from the first frame.
+            void Play();
+
+            // Pauses playback at the current frame.
+            void Pause();
+
+            // Resumes paused playback.
+            void Resume();
+
+            // Sets the playback speed multiplier.
+            void SetSpeed(float speed);
+
+            // Gets the animation.
+            const AnimationPtr& GetAnimation() const;
+
+            // Gets the index of the current frame.
+            std::size_t GetFrameIndex() const;
+
+            // Gets the playback speed multiplier.
+            float GetSpeed() const;
+
+            // Checks if is playing.
+            bool IsPlaying() const;
+
+            // Gets the render component.
+            Render* GetRender();
+
+        private:
+            // Animation resource.
+            AnimationPtr m_animation;
+
+            // Playback state.
+            float m_time;
+            float m_speed;
+            std::size_t m_frame;
+            bool m_playing;
+
+            // Set when the current frame has to be written to the render component.
+            bool m_frameDirty;
+
+            // Set when playback has finished during the last update.
+            bool m_finished;
+
+            // Entity components.
+            Render* m_render;
+        };
+    }
+}
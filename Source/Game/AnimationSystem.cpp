@@ -0,0 +1,227 @@
+#include "Precompiled.hpp"
+#include "AnimationSystem.hpp"
+#include "AnimationComponent.hpp"
+#include "RenderComponent.hpp"
+#include "EntitySystem.hpp"
+#include "ComponentSystem.hpp"
+#include "Graphics/Animation.hpp"
+#include "System/ThreadPool.hpp"
+using namespace Game;
+
+namespace
+{
+    // Error messages.
+    #define LogInitializeError() "Failed to initialize the animation system! "
+}
+
+AnimationSystemInfo::AnimationSystemInfo() :
+    entitySystem(nullptr),
+    componentSystem(nullptr),
+    threadPool(nullptr)
+{
+}
+
+AnimationSystem::AnimationSystem() :
+    m_threadPool(nullptr),
+    m_renderComponents(nullptr),
+    m_animationComponents(nullptr),
+    m_initialized(false)
+{
+    // Bind event receivers.
+    m_entityFinalize.Bind<AnimationSystem, &AnimationSystem::FinalizeComponent>(this);
+}
+
+AnimationSystem::~AnimationSystem()
+{
+}
+
+bool AnimationSystem::Initialize(const AnimationSystemInfo& info)
+{
+    // Check if instance has been already initialized.
+    if(m_initialized)
+    {
+        Log() << LogInitializeError() << "Instance has been already initialized.";
+        return false;
+    }
+
+    // Validate arguments.
+    if(info.entitySystem == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.entitySystem\" is null.";
+        return false;
+    }
+
+    if(info.componentSystem == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.componentSystem\" is null.";
+        return false;
+    }
+
+    if(info.threadPool == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.threadPool\" is null.";
+        return false;
+    }
+
+    // Save instance references.
+    m_threadPool = info.threadPool;
+
+    SCOPE_GUARD_IF(!m_initialized, m_threadPool = nullptr);
+
+    // Retrieve component pools.
+    m_renderComponents = info.componentSystem->GetPool<Components::Render>();
+    m_animationComponents = info.componentSystem->GetPool<Components::Animation>();
+
+    SCOPE_GUARD_BEGIN(!m_initialized);
+    {
+        m_renderComponents = nullptr;
+        m_animationComponents = nullptr;
+    }
+    SCOPE_GUARD_END();
+
+    if(m_renderComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for render components.";
+        return false;
+    }
+
+    if(m_animationComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for animation components.";
+        return false;
+    }
+
+    // Subscribe to the entity system.
+    if(!m_entityFinalize.Subscribe(info.entitySystem->eventDispatchers.entityFinalize))
+    {
+        Log() << LogInitializeError() << "Could not subscribe to the entity system.";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_entityFinalize.Unsubscribe());
+
+    // Success!
+    return m_initialized = true;
+}
+
+bool AnimationSystem::FinalizeComponent(EntityHandle entity)
+{
+    Assert(m_initialized);
+
+    // Finalize an animation component.
+    auto animationComponent = m_animationComponents->Lookup(entity);
+
+    if(animationComponent != nullptr)
+    {
+        // Get the render component.
+        auto renderComponent = m_renderComponents->Lookup(entity);
+        if(renderComponent == nullptr) return false;
+
+        // Set the reference for render component.
+        animationComponent->m_render = renderComponent;
+    }
+
+    return true;
+}
+
+void AnimationSystem::Update(float timeDelta)
+{
+    if(!m_initialized)
+        return;
+
+    // Collect animations that need to be advanced or have their frame written.
+    auto componentsBegin = m_animationComponents->Begin();
+    auto componentsEnd = m_animationComponents->End();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        Components::Animation* animation = &it->second;
+        Assert(animation->GetRender() != nullptr);
+
+        if(!animation->m_playing && !animation->m_frameDirty)
+            continue;
+
+        if(animation->m_animation == nullptr || !animation->m_animation->IsValid())
+            continue;
+
+        m_animations.emplace_back(it->first, animation);
+    }
+
+    // Advance animations in parallel.
+    // Each animation only writes to its own render component.
+    m_threadPool->ParallelFor(m_animations.size(), [this, timeDelta](std::size_t index)
+    {
+        AdvanceAnimation(m_animations[index].second, timeDelta);
+    });
+
+    // Dispatch finished events.
+    // Receivers may modify components, so events are sent after all animations are advanced.
+    for(const AnimationEntry& entry : m_animations)
+    {
+        Components::Animation* animation = entry.second;
+
+        if(animation->m_finished)
+        {
+            animation->m_finished = false;
+            eventDispatchers.animationFinished(entry.first);
+        }
+    }
+
+    m_animations.clear();
+}
+
+void AnimationSystem::AdvanceAnimation(Components::Animation* animation, float timeDelta)
+{
+    const Graphics::Animation& resource = *animation->m_animation;
+    const std::size_t frameCount = resource.GetFrameCount();
+    const float duration = resource.GetDuration();
+
+    std::size_t frame = animation->m_frame;
+
+    if(animation->m_playing)
+    {
+        // Advance playback time.
+        float time = animation->m_time + timeDelta * animation->m_speed;
+
+        if(time >= duration)
+        {
+            if(resource.IsLooped())
+            {
+                // Wrap around and search for the frame from the start.
+                time = std::fmod(time, duration);
+                frame = 0;
+            }
+            else
+            {
+                // Stop at the last frame.
+                time = duration;
+                frame = frameCount - 1;
+
+                animation->m_playing = false;
+                animation->m_finished = true;
+            }
+        }
+
+        // Step forward to the frame containing the current time.
+        // Frame may be out of range if the animation has been changed.
+        frame = std::min(frame, frameCount - 1);
+
+        while(frame + 1 < frameCount && time >= resource.GetFrame(frame).endTime)
+        {
+            ++frame;
+        }
+
+        animation->m_time = time;
+    }
+
+    // Write the frame rectangle to the render component.
+    if(frame != animation->m_frame || animation->m_frameDirty)
+    {
+        Components::Render* render = animation->m_render;
+        render->m_rectangle = resource.GetFrame(frame).rectangle;
+        render->m_staticDirty |= render->m_static;
+
+        animation->m_frame = frame;
+        animation->m_frameDirty = false;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "EntityHandle.hpp"
+#include "ComponentPool.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ThreadPool;
+}
+
+/*
+    Animation System
+*/
+
+namespace Game
+{
+    // Forward declarations.
+    class EntitySystem;
+    class ComponentSystem;
+
+    namespace Components
+    {
+        class Render;
+        class Animation;
+    }
+
+    // Animation system info structure.
+    struct AnimationSystemInfo
+    {
+        AnimationSystemInfo();
+
+        EntitySystem* entitySystem;
+        ComponentSystem* componentSystem;
+        System::ThreadPool* threadPool;
+    };
+
+    // Animation system class.
+    class AnimationSystem
+    {
+    public:
+        // Public event dispatchers.
+        struct EventDispatchers
+        {
+            Dispatcher<void(EntityHandle)> animationFinished;
+        } eventDispatchers;
+
+    public:
+        AnimationSystem();
+        ~AnimationSystem();
+
+        // Initializes the animation system.
+        bool Initialize(const AnimationSystemInfo& info);
+
+        // Advances all animations in parallel.
+        // Finished events are dispatched afterwards on the calling thread.
+        void Update(float timeDelta);
+
+    private:
+        // Type declarations.
+        typedef std::pair<EntityHandle, Components::Animation*> AnimationEntry;
+        typedef std::vector<AnimationEntry> AnimationList;
+
+    private:
+        // Finalizes an animation component.
+        bool FinalizeComponent(EntityHandle entity);
+
+        // Advances playback and writes the current frame to the render component.
+        static void AdvanceAnimation(Components::Animation* animation, float timeDelta);
+
+    private:
+        // Event receivers.
+        Receiver<bool(EntityHandle)> m_entityFinalize;
+
+        // Instance references.
+        System::ThreadPool* m_threadPool;
+
+        // Component pools.
+        ComponentPool<Components::Render>*    m_renderComponents;
+        ComponentPool<Components::Animation>* m_animationComponents;
+
+        // List of animations updated in the current frame.
+        AnimationList m_animations;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
@@ -0,0 +1,65 @@
+#include "Precompiled.hpp"
+#include "CameraComponent.hpp"
+#include "TransformComponent.hpp"
+using namespace Game::Components;
+
+Camera::Camera() :
+    m_viewSize(10.0f, 10.0f),
+    m_layerMask(~0u),
+    m_order(0),
+    m_transform(nullptr)
+{
+}
+
+Camera::~Camera()
+{
+}
+
+void Camera::SetViewSize(const glm::vec2& size)
+{
+    Verify(size.x > 0.0f && size.y > 0.0f, "Invalid argument - \"size\" is invalid!");
+
+    m_viewSize = size;
+}
+
+void Camera::SetViewSize(float width, float height)
+{
+    this->SetViewSize(glm::vec2(width, height));
+}
+
+void Camera::SetLayerMask(uint32_t mask)
+{
+    m_layerMask = mask;
+}
+
+void Camera::SetOrder(int order)
+{
+    m_order = order;
+}
+
+const glm::vec2& Camera::GetViewSize() const
+{
+    return m_viewSize;
+}
+
+uint32_t Camera::GetLayerMask() const
+{
+    return m_layerMask;
+}
+
+int Camera::GetOrder() const
+{
+    return m_order;
+}
+
+bool Camera::HasLayer(int layer) const
+{
+    Verify(layer >= 0 && layer < RenderLayerCount, "Invalid argument - \"layer\" is out of range!");
+
+    return (m_layerMask & (1u << layer)) != 0;
+}
+
+Transform* Camera::GetTransform()
+{
+    return m_transform;
+}
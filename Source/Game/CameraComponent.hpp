@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Component.hpp"
+#include "RenderComponent.hpp"
+
+// Forward declarations.
+namespace Game
+{
+    class RenderSystem;
+}
+
+/*
+    Camera Component
+
+    Views the scene from the position of the entity's transform, which is
+    placed at the center of the render target. Each camera draws layers
+    selected by its mask, with each layer culled and sorted separately.
+    Cameras are drawn in ascending order over each other. If no camera
+    exists, the scene is drawn by a default camera placed at the origin.
+
+    void ExampleCameraComponent(Components::Camera* camera)
+    {
+        // View ten world units around the entity.
+        camera->SetViewSize(10.0f, 10.0f);
+
+        // Draw only the default layer and the ones above it.
+        camera->SetLayerMask(~0u << DefaultRenderLayer);
+    }
+*/
+
+namespace Game
+{
+    namespace Components
+    {
+        // Forward declarations.
+        class Transform;
+
+        // Camera component class.
+        class Camera : public Component
+        {
+        public:
+            // Friend declarations.
+            friend RenderSystem;
+
+        public:
+            Camera();
+            ~Camera();
+
+            // Sets the view size in world units.
+            // View is enclosed in the render target with its aspect ratio preserved.
+            void SetViewSize(const glm::vec2& size);
+            void SetViewSize(float width, float height);
+
+            // Sets the mask of drawn layers.
+            void SetLayerMask(uint32_t mask);
+
+            // Sets the draw order.
+            // Cameras with lower orders are drawn first.
+            void SetOrder(int order);
+
+            // Gets the view size.
+            const glm::vec2& GetViewSize() const;
+
+            // Gets the mask of drawn layers.
+            uint32_t GetLayerMask() const;
+
+            // Gets the draw order.
+            int GetOrder() const;
+
+            // Checks if a layer is drawn.
+            bool HasLayer(int layer) const;
+
+            // Gets the transform component.
+            // Returns null for the default camera.
+            Transform* GetTransform();
+
+        private:
+            // Sort input structure.
+            // Holds an entity with the values its sprite is sorted by.
+            struct SortInput
+            {
+                bool operator==(const SortInput& other) const
+                {
+                    return entity == other.entity && depth == other.depth && height == other.height &&
+                        material == other.material && transparent == other.transparent;
+                }
+
+                EntityHandle entity;
+                float depth;
+                float height;
+                uint32_t material;
+                bool transparent;
+            };
+
+            // Sort state of a layer structure.
+            // Holds inputs of the previous sort in their extraction order and indices of inputs in their sorted order.
+            // Sorting is skipped if inputs have not changed, otherwise sprites start from their previous order.
+            struct LayerSort
+            {
+                std::vector<SortInput> inputs;
+                std::vector<std::size_t> order;
+            };
+
+        private:
+            // Camera parameters.
+            glm::vec2 m_viewSize;
+            uint32_t m_layerMask;
+            int m_order;
+
+            // Sort state of each layer.
+            LayerSort m_layerSort[RenderLayerCount];
+
+            // Entity components.
+            Transform* m_transform;
+        };
+    }
+}
@@ -0,0 +1,355 @@
+#include "Precompiled.hpp"
+#include "ParticleSystem.hpp"
+#include "ParticlesComponent.hpp"
+#include "TransformComponent.hpp"
+#include "RenderSystem.hpp"
+#include "EntitySystem.hpp"
+#include "ComponentSystem.hpp"
+#include "System/ThreadPool.hpp"
+using namespace Game;
+
+namespace
+{
+    // Error messages.
+    #define LogInitializeError() "Failed to initialize the particle system! "
+}
+
+ParticleSystemInfo::ParticleSystemInfo() :
+    entitySystem(nullptr),
+    componentSystem(nullptr),
+    threadPool(nullptr)
+{
+}
+
+ParticleSystem::ParticleSystem() :
+    m_threadPool(nullptr),
+    m_transformComponents(nullptr),
+    m_particlesComponents(nullptr),
+    m_initialized(false)
+{
+    // Bind event receivers.
+    m_entityFinalize.Bind<ParticleSystem, &ParticleSystem::FinalizeComponent>(this);
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+bool ParticleSystem::Initialize(const ParticleSystemInfo& info)
+{
+    // Check if instance has been already initialized.
+    if(m_initialized)
+    {
+        Log() << LogInitializeError() << "Instance has been already initialized.";
+        return false;
+    }
+
+    // Validate arguments.
+    if(info.entitySystem == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.entitySystem\" is null.";
+        return false;
+    }
+
+    if(info.componentSystem == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.componentSystem\" is null.";
+        return false;
+    }
+
+    if(info.threadPool == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.threadPool\" is null.";
+        return false;
+    }
+
+    // Save instance references.
+    m_threadPool = info.threadPool;
+
+    SCOPE_GUARD_IF(!m_initialized, m_threadPool = nullptr);
+
+    // Retrieve component pools.
+    m_transformComponents = info.componentSystem->GetPool<Components::Transform>();
+    m_particlesComponents = info.componentSystem->GetPool<Components::Particles>();
+
+    SCOPE_GUARD_BEGIN(!m_initialized);
+    {
+        m_transformComponents = nullptr;
+        m_particlesComponents = nullptr;
+    }
+    SCOPE_GUARD_END();
+
+    if(m_transformComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for transform components.";
+        return false;
+    }
+
+    if(m_particlesComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for particles components.";
+        return false;
+    }
+
+    // Subscribe to the entity system.
+    if(!m_entityFinalize.Subscribe(info.entitySystem->eventDispatchers.entityFinalize))
+    {
+        Log() << LogInitializeError() << "Could not subscribe to the entity system.";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_entityFinalize.Unsubscribe());
+
+    // Success!
+    return m_initialized = true;
+}
+
+bool ParticleSystem::FinalizeComponent(EntityHandle entity)
+{
+    Assert(m_initialized);
+
+    // Finalize a particles component.
+    auto particlesComponent = m_particlesComponents->Lookup(entity);
+
+    if(particlesComponent != nullptr)
+    {
+        // Get the transform component.
+        auto transformComponent = m_transformComponents->Lookup(entity);
+        if(transformComponent == nullptr) return false;
+
+        // Set the reference for transform component.
+        particlesComponent->m_transform = transformComponent;
+    }
+
+    return true;
+}
+
+void ParticleSystem::Update(float timeDelta)
+{
+    if(!m_initialized)
+        return;
+
+    // Collect all emitters.
+    // Transform components are only read during the update, so emitters can be processed in parallel.
+    auto componentsBegin = m_particlesComponents->Begin();
+    auto componentsEnd = m_particlesComponents->End();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        Components::Particles* particles = &it->second;
+        Assert(particles->GetTransform() != nullptr);
+
+        m_emitters.push_back(particles);
+    }
+
+    // Update emitters in parallel.
+    m_threadPool->ParallelFor(m_emitters.size(), [this, timeDelta](std::size_t index)
+    {
+        Components::Particles* particles = m_emitters[index];
+        Components::Transform* transform = particles->GetTransform();
+
+        particles->m_depth = transform->GetPosition().z;
+
+        IntegrateParticles(particles, timeDelta);
+        RemoveDeadParticles(particles);
+        SpawnParticles(particles, glm::vec2(transform->GetPosition()), timeDelta);
+        WriteParticleInstances(particles, glm::vec2(transform->GetScale() * RenderScale));
+    });
+
+    m_emitters.clear();
+}
+
+void ParticleSystem::IntegrateParticles(Components::Particles* particles, float timeDelta)
+{
+    const Components::Particles::Emitter& emitter = particles->GetEmitter();
+
+    float* positionX = particles->m_positionX.data();
+    float* positionY = particles->m_positionY.data();
+    float* velocityX = particles->m_velocityX.data();
+    float* velocityY = particles->m_velocityY.data();
+    float* life = particles->m_life.data();
+    float* colorR = particles->m_colorR.data();
+    float* colorG = particles->m_colorG.data();
+    float* colorB = particles->m_colorB.data();
+    float* colorA = particles->m_colorA.data();
+
+    const int particleCount = particles->m_particleCount;
+    const float lifetimeInv = 1.0f / emitter.lifetime;
+    const glm::vec4 colorDelta = emitter.colorEnd - emitter.colorBegin;
+
+#ifdef SSE_AVAILABLE
+    // Process four particles at once.
+    // Attribute arrays are padded, so the last iteration can read past the particle count.
+    const __m128 timeDelta4 = _mm_set1_ps(timeDelta);
+    const __m128 accelerationX4 = _mm_set1_ps(emitter.acceleration.x * timeDelta);
+    const __m128 accelerationY4 = _mm_set1_ps(emitter.acceleration.y * timeDelta);
+    const __m128 lifetimeInv4 = _mm_set1_ps(lifetimeInv);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 one4 = _mm_set1_ps(1.0f);
+
+    const __m128 colorBeginR4 = _mm_set1_ps(emitter.colorBegin.r);
+    const __m128 colorBeginG4 = _mm_set1_ps(emitter.colorBegin.g);
+    const __m128 colorBeginB4 = _mm_set1_ps(emitter.colorBegin.b);
+    const __m128 colorBeginA4 = _mm_set1_ps(emitter.colorBegin.a);
+    const __m128 colorDeltaR4 = _mm_set1_ps(colorDelta.r);
+    const __m128 colorDeltaG4 = _mm_set1_ps(colorDelta.g);
+    const __m128 colorDeltaB4 = _mm_set1_ps(colorDelta.b);
+    const __m128 colorDeltaA4 = _mm_set1_ps(colorDelta.a);
+
+    for(int i = 0; i < particleCount; i += 4)
+    {
+        // Integrate velocity and position.
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(velocityX + i), accelerationX4);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(velocityY + i), accelerationY4);
+        __m128 px = _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, timeDelta4));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, timeDelta4));
+
+        _mm_storeu_ps(velocityX + i, vx);
+        _mm_storeu_ps(velocityY + i, vy);
+        _mm_storeu_ps(positionX + i, px);
+        _mm_storeu_ps(positionY + i, py);
+
+        // Decrease remaining life.
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), timeDelta4);
+        _mm_storeu_ps(life + i, l);
+
+        // Interpolate color by the elapsed fraction of lifetime.
+        __m128 t = _mm_sub_ps(one4, _mm_mul_ps(l, lifetimeInv4));
+        t = _mm_min_ps(_mm_max_ps(t, zero4), one4);
+
+        _mm_storeu_ps(colorR + i, _mm_add_ps(colorBeginR4, _mm_mul_ps(colorDeltaR4, t)));
+        _mm_storeu_ps(colorG + i, _mm_add_ps(colorBeginG4, _mm_mul_ps(colorDeltaG4, t)));
+        _mm_storeu_ps(colorB + i, _mm_add_ps(colorBeginB4, _mm_mul_ps(colorDeltaB4, t)));
+        _mm_storeu_ps(colorA + i, _mm_add_ps(colorBeginA4, _mm_mul_ps(colorDeltaA4, t)));
+    }
+#else
+    for(int i = 0; i < particleCount; ++i)
+    {
+        // Integrate velocity and position.
+        velocityX[i] += emitter.acceleration.x * timeDelta;
+        velocityY[i] += emitter.acceleration.y * timeDelta;
+        positionX[i] += velocityX[i] * timeDelta;
+        positionY[i] += velocityY[i] * timeDelta;
+
+        // Decrease remaining life.
+        life[i] -= timeDelta;
+
+        // Interpolate color by the elapsed fraction of lifetime.
+        float t = glm::clamp(1.0f - life[i] * lifetimeInv, 0.0f, 1.0f);
+
+        colorR[i] = emitter.colorBegin.r + colorDelta.r * t;
+        colorG[i] = emitter.colorBegin.g + colorDelta.g * t;
+        colorB[i] = emitter.colorBegin.b + colorDelta.b * t;
+        colorA[i] = emitter.colorBegin.a + colorDelta.a * t;
+    }
+#endif
+}
+
+void ParticleSystem::RemoveDeadParticles(Components::Particles* particles)
+{
+    Components::Particles::AttributeList* attributes[] =
+    {
+        &particles->m_positionX, &particles->m_positionY,
+        &particles->m_velocityX, &particles->m_velocityY,
+        &particles->m_life,
+        &particles->m_colorR, &particles->m_colorG, &particles->m_colorB, &particles->m_colorA,
+    };
+
+    const float* life = particles->m_life.data();
+    int& particleCount = particles->m_particleCount;
+
+    int i = 0;
+
+    while(i < particleCount)
+    {
+        if(life[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+
+        // Order of particles does not matter, so the gap is filled with the last one.
+        int last = particleCount - 1;
+
+        for(Components::Particles::AttributeList* attribute : attributes)
+        {
+            (*attribute)[i] = (*attribute)[last];
+        }
+
+        --particleCount;
+    }
+}
+
+void ParticleSystem::SpawnParticles(Components::Particles* particles, const glm::vec2& origin, float timeDelta)
+{
+    const Components::Particles::Emitter& emitter = particles->GetEmitter();
+
+    if(!particles->IsEmitting())
+        return;
+
+    // Accumulate fractional particles between frames.
+    particles->m_spawnAccumulator += emitter.spawnRate * timeDelta;
+
+    int spawnCount = (int)particles->m_spawnAccumulator;
+    particles->m_spawnAccumulator -= spawnCount;
+
+    // Particles over the limit are dropped.
+    int& particleCount = particles->m_particleCount;
+    spawnCount = std::min(spawnCount, emitter.maxParticles - particleCount);
+
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    for(int i = 0; i < spawnCount; ++i)
+    {
+        int index = particleCount++;
+
+        glm::vec2 random(distribution(particles->m_random), distribution(particles->m_random));
+        glm::vec2 velocity = glm::mix(emitter.velocityMin, emitter.velocityMax, random);
+
+        particles->m_positionX[index] = origin.x;
+        particles->m_positionY[index] = origin.y;
+        particles->m_velocityX[index] = velocity.x;
+        particles->m_velocityY[index] = velocity.y;
+        particles->m_life[index] = emitter.lifetime;
+        particles->m_colorR[index] = emitter.colorBegin.r;
+        particles->m_colorG[index] = emitter.colorBegin.g;
+        particles->m_colorB[index] = emitter.colorBegin.b;
+        particles->m_colorA[index] = emitter.colorBegin.a;
+    }
+}
+
+void ParticleSystem::WriteParticleInstances(Components::Particles* particles, const glm::vec2& scale)
+{
+    const int particleCount = particles->m_particleCount;
+
+    // Calculate the world size of a particle.
+    // Size can be negative for mirrored sprites.
+    const glm::vec4& rectangle = particles->GetRectangle();
+    glm::vec2 particleScale = scale * particles->GetEmitter().scale;
+    glm::vec2 size = glm::abs(glm::vec2(rectangle.z, rectangle.w)) * particleScale;
+    glm::vec2 halfSize = size * 0.5f;
+
+    particles->m_instances.resize(particleCount);
+
+    glm::vec2 boundsMin(std::numeric_limits<float>::max());
+    glm::vec2 boundsMax(std::numeric_limits<float>::lowest());
+
+    for(int i = 0; i < particleCount; ++i)
+    {
+        // Center the sprite quad on the particle.
+        glm::vec2 position(particles->m_positionX[i] - halfSize.x, particles->m_positionY[i] - halfSize.y);
+
+        Graphics::Sprite::Data& data = particles->m_instances[i];
+        data.transform = glm::mat4(1.0f);
+        data.transform[0][0] = particleScale.x;
+        data.transform[1][1] = particleScale.y;
+        data.transform[3] = glm::vec4(position, particles->m_depth, 1.0f);
+        data.rectangle = rectangle;
+        data.diffuseColor = glm::packUnorm4x8(glm::vec4(particles->m_colorR[i], particles->m_colorG[i], particles->m_colorB[i], particles->m_colorA[i]));
+
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position + size);
+    }
+
+    particles->m_bounds = glm::vec4(boundsMin.x, boundsMax.x, boundsMin.y, boundsMax.y);
+}
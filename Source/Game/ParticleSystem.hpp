@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "EntityHandle.hpp"
+#include "ComponentPool.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ThreadPool;
+}
+
+/*
+    Particle System
+*/
+
+namespace Game
+{
+    // Forward declarations.
+    class EntitySystem;
+    class ComponentSystem;
+
+    namespace Components
+    {
+        class Transform;
+        class Particles;
+    }
+
+    // Particle system info structure.
+    struct ParticleSystemInfo
+    {
+        ParticleSystemInfo();
+
+        EntitySystem* entitySystem;
+        ComponentSystem* componentSystem;
+        System::ThreadPool* threadPool;
+    };
+
+    // Particle system class.
+    class ParticleSystem
+    {
+    public:
+        ParticleSystem();
+        ~ParticleSystem();
+
+        // Initializes the particle system.
+        bool Initialize(const ParticleSystemInfo& info);
+
+        // Updates all particle emitters in parallel.
+        void Update(float timeDelta);
+
+    private:
+        // Type declarations.
+        typedef std::vector<Components::Particles*> EmitterList;
+
+    private:
+        // Finalizes a particles component.
+        bool FinalizeComponent(EntityHandle entity);
+
+        // Advances particle attributes by a time step.
+        static void IntegrateParticles(Components::Particles* particles, float timeDelta);
+
+        // Removes dead particles by moving the last alive particle into their place.
+        static void RemoveDeadParticles(Components::Particles* particles);
+
+        // Spawns new particles at the emitter's position.
+        static void SpawnParticles(Components::Particles* particles, const glm::vec2& origin, float timeDelta);
+
+        // Writes sprite instances of alive particles and calculates their bounds.
+        static void WriteParticleInstances(Components::Particles* particles, const glm::vec2& scale);
+
+    private:
+        // Event receivers.
+        Receiver<bool(EntityHandle)> m_entityFinalize;
+
+        // Instance references.
+        System::ThreadPool* m_threadPool;
+
+        // Component pools.
+        ComponentPool<Components::Transform>* m_transformComponents;
+        ComponentPool<Components::Particles>* m_particlesComponents;
+
+        // List of emitters updated in the current frame.
+        EmitterList m_emitters;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
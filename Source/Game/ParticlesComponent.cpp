@@ -0,0 +1,131 @@
+#include "Precompiled.hpp"
+#include "ParticlesComponent.hpp"
+#include "TransformComponent.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/Material.hpp"
+using namespace Game::Components;
+
+namespace
+{
+    // Width of vector registers in floats.
+    const int VectorWidth = 4;
+}
+
+Particles::Emitter::Emitter() :
+    spawnRate(100.0f),
+    lifetime(1.0f),
+    velocityMin(-1.0f, -1.0f),
+    velocityMax(1.0f, 1.0f),
+    acceleration(0.0f, 0.0f),
+    colorBegin(1.0f, 1.0f, 1.0f, 1.0f),
+    colorEnd(1.0f, 1.0f, 1.0f, 0.0f),
+    scale(1.0f),
+    maxParticles(1000)
+{
+}
+
+Particles::Particles() :
+    m_emitting(true),
+    m_rectangle(0.0f, 0.0f, 1.0f, 1.0f),
+    m_particleCount(0),
+    m_spawnAccumulator(0.0f),
+    m_bounds(0.0f, 0.0f, 0.0f, 0.0f),
+    m_depth(0.0f),
+    m_visibleFrame(0),
+    m_transform(nullptr)
+{
+    this->AllocateParticles();
+}
+
+Particles::~Particles()
+{
+}
+
+void Particles::AllocateParticles()
+{
+    // Round the size up, so vector loops can run past the last particle.
+    std::size_t size = (m_emitter.maxParticles + VectorWidth - 1) / VectorWidth * VectorWidth;
+
+    for(AttributeList* attribute : { &m_positionX, &m_positionY, &m_velocityX, &m_velocityY,
+        &m_life, &m_colorR, &m_colorG, &m_colorB, &m_colorA })
+    {
+        attribute->resize(size, 0.0f);
+    }
+
+    m_particleCount = std::min(m_particleCount, m_emitter.maxParticles);
+}
+
+void Particles::SetEmitter(const Emitter& emitter)
+{
+    Verify(emitter.maxParticles >= 0, "Invalid argument - \"maxParticles\" cannot be negative!");
+    Verify(emitter.lifetime > 0.0f, "Invalid argument - \"lifetime\" must be positive!");
+
+    m_emitter = emitter;
+
+    this->AllocateParticles();
+}
+
+void Particles::SetTexture(TexturePtr texture)
+{
+    m_texture = texture;
+    m_material = nullptr;
+}
+
+void Particles::SetRectangle(const glm::vec4& rectangle)
+{
+    m_rectangle = rectangle;
+}
+
+void Particles::SetRectangleFromTexture()
+{
+    if(m_texture != nullptr)
+    {
+        m_rectangle = glm::vec4(0.0f, 0.0f, m_texture->GetWidth(), m_texture->GetHeight());
+    }
+    else
+    {
+        m_rectangle = glm::vec4(0.0f);
+    }
+}
+
+void Particles::SetEmitting(bool emitting)
+{
+    m_emitting = emitting;
+    m_spawnAccumulator = 0.0f;
+}
+
+void Particles::Clear()
+{
+    m_particleCount = 0;
+    m_spawnAccumulator = 0.0f;
+}
+
+const Particles::Emitter& Particles::GetEmitter() const
+{
+    return m_emitter;
+}
+
+const Particles::TexturePtr& Particles::GetTexture() const
+{
+    return m_texture;
+}
+
+const glm::vec4& Particles::GetRectangle() const
+{
+    return m_rectangle;
+}
+
+int Particles::GetParticleCount() const
+{
+    return m_particleCount;
+}
+
+bool Particles::IsEmitting() const
+{
+    return m_emitting;
+}
+
+Transform* Particles::GetTransform()
+{
+    return m_transform;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Component.hpp"
+#include "Graphics/Sprite.hpp"
+
+// Forward declarations.
+namespace Graphics
+{
+    class Texture;
+    class Material;
+}
+
+namespace Game
+{
+    class ParticleSystem;
+    class RenderSystem;
+}
+
+/*
+    Particles Component
+
+    Emits particles from the entity's position. Particles live in world
+    space and are stored as separate arrays of each attribute, so they can
+    be simulated with vector instructions. They are updated by the particle
+    system and drawn by the render system from their instance list in a
+    single call, without creating entities or sorting individual particles.
+
+    void ExampleParticlesComponent(Components::Particles* particles)
+    {
+        // Describe the emitter.
+        Components::Particles::Emitter emitter;
+        emitter.spawnRate = 1000.0f;
+        emitter.lifetime = 2.0f;
+        emitter.velocityMin = glm::vec2(-1.0f, 2.0f);
+        emitter.velocityMax = glm::vec2(1.0f, 4.0f);
+        emitter.acceleration = glm::vec2(0.0f, -9.8f);
+        emitter.maxParticles = 50000;
+
+        // Set the emitter and the particle texture.
+        particles->SetEmitter(emitter);
+        particles->SetTexture(particleTexture);
+        particles->SetRectangleFromTexture();
+    }
+*/
+
+namespace Game
+{
+    namespace Components
+    {
+        // Forward declarations.
+        class Transform;
+
+        // Particles component class.
+        class Particles : public Component
+        {
+        public:
+            // Type declarations.
+            typedef std::shared_ptr<const Graphics::Texture> TexturePtr;
+            typedef std::shared_ptr<const Graphics::Material> MaterialPtr;
+
+            // Friend declarations.
+            friend ParticleSystem;
+            friend RenderSystem;
+
+            // Emitter parameters.
+            struct Emitter
+            {
+                Emitter();
+
+                // Number of particles spawned per second.
+                float spawnRate;
+
+                // Particle lifetime in seconds.
+                float lifetime;
+
+                // Range of initial velocities.
+                glm::vec2 velocityMin;
+                glm::vec2 velocityMax;
+
+                // Constant acceleration.
+                glm::vec2 acceleration;
+
+                // Colors at the beginning and the end of the lifetime.
+                glm::vec4 colorBegin;
+                glm::vec4 colorEnd;
+
+                // Particle scale relative to the rectangle.
+                float scale;
+
+                // Maximum number of alive particles.
+                int maxParticles;
+            };
+
+        public:
+            Particles();
+            ~Particles();
+
+            // Sets the emitter parameters.
+            // Alive particles are kept, unless they exceed the new limit.
+            void SetEmitter(const Emitter& emitter);
+
+            // Sets the particle texture.
+            void SetTexture(TexturePtr texture);
+
+            // Sets the particle rectangle.
+            void SetRectangle(const glm::vec4& rectangle);
+            void SetRectangleFromTexture();
+
+            // Sets the emitting state.
+            // Alive particles finish their lifetime when emitting stops.
+            void SetEmitting(bool emitting);
+
+            // Removes all alive particles.
+            void Clear();
+
+            // Gets the emitter parameters.
+            const Emitter& GetEmitter() const;
+
+            // Gets the particle texture.
+            const TexturePtr& GetTexture() const;
+
+            // Gets the particle rectangle.
+            const glm::vec4& GetRectangle() const;
+
+            // Gets the number of alive particles.
+            int GetParticleCount() const;
+
+            // Checks if is emitting.
+            bool IsEmitting() const;
+
+            // Gets the transform component.
+            Transform* GetTransform();
+
+        private:
+            // Type declarations.
+            typedef std::vector<float> AttributeList;
+            typedef std::vector<Graphics::Sprite::Data> InstanceList;
+
+        private:
+            // Resizes attribute arrays for the particle limit.
+            void AllocateParticles();
+
+        private:
+            // Emitter parameters.
+            Emitter m_emitter;
+            bool m_emitting;
+
+            // Texture resource.
+            // Material is resolved by the render system when drawn.
+            TexturePtr m_texture;
+            glm::vec4 m_rectangle;
+            MaterialPtr m_material;
+
+            // Particle attributes.
+            // Arrays are padded to a multiple of the vector width.
+            AttributeList m_positionX;
+            AttributeList m_positionY;
+            AttributeList m_velocityX;
+            AttributeList m_velocityY;
+            AttributeList m_life;
+            AttributeList m_colorR;
+            AttributeList m_colorG;
+            AttributeList m_colorB;
+            AttributeList m_colorA;
+            int m_particleCount;
+
+            // Spawning state.
+            float m_spawnAccumulator;
+            std::minstd_rand m_random;
+
+            // Instance output.
+            InstanceList m_instances;
+            glm::vec4 m_bounds;
+            float m_depth;
+
+            // Frame in which particles were last counted as visible.
+            uint32_t m_visibleFrame;
+
+            // Entity components.
+            Transform* m_transform;
+        };
+    }
+}
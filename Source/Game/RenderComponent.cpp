@@ -2,15 +2,23 @@
 #include "RenderComponent.hpp"
 #include "TransformComponent.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/Material.hpp"
 using namespace Game::Components;
 
 Render::Render() :
+    m_transform(nullptr),
+    m_packedDiffuseColor(glm::packUnorm4x8(glm::vec4(1.0f))),
+    m_packedEmissiveColor(glm::packUnorm4x8(glm::vec4(1.0f))),
+    m_emissivePower(0.0f),
     m_rectangle(0.0f, 0.0f, 1.0f, 1.0f),
+    m_layer(DefaultRenderLayer),
+    m_static(false),
+    m_staticDirty(false),
+    m_staticVersion(0),
+    m_transparent(true),
     m_diffuseColor(1.0f, 1.0f, 1.0f, 1.0f),
     m_emissiveColor(1.0f, 1.0f, 1.0f, 1.0f),
-    m_emissivePower(0.0f),
-    m_transparent(true),
-    m_transform(nullptr)
+    m_staticLayer(DefaultRenderLayer)
 {
 }
 
@@ -18,19 +26,19 @@ Render::~Render()
 {
 }
 
-glm::vec4 Render::CalculateColor() const
-{
-    return glm::mix(m_diffuseColor, m_emissiveColor, m_emissivePower);
-}
-
 void Render::SetTexture(TexturePtr texture)
 {
-    m_texture = texture;
+    m_texture = TextureHandle(texture);
+    m_material = MaterialHandle();
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetRectangle(const glm::vec4& rectangle)
 {
     m_rectangle = rectangle;
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetRectangle(float x, float y, float width, float height)
@@ -39,28 +47,40 @@ void Render::SetRectangle(float x, float y, float width, float height)
     m_rectangle.y = y;
     m_rectangle.z = width;
     m_rectangle.w = height;
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetRectangleFromTexture()
 {
-    if(m_texture != nullptr)
+    const Graphics::Texture* texture = m_texture.Get();
+
+    if(texture != nullptr)
     {
-        m_rectangle = glm::vec4(0.0f, 0.0f, m_texture->GetWidth(), m_texture->GetHeight());
+        m_rectangle = glm::vec4(0.0f, 0.0f, texture->GetWidth(), texture->GetHeight());
     }
     else
     {
         m_rectangle = glm::vec4(0.0f);
     }
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetDiffuseColor(const glm::vec3& color)
 {
     m_diffuseColor = glm::vec4(color, 1.0f);
+    m_packedDiffuseColor = glm::packUnorm4x8(m_diffuseColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetDiffuseColor(const glm::vec4& color)
 {
     m_diffuseColor = color;
+    m_packedDiffuseColor = glm::packUnorm4x8(m_diffuseColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetDiffuseColor(float r, float g, float b, float a)
@@ -69,16 +89,25 @@ void Render::SetDiffuseColor(float r, float g, float b, float a)
     m_diffuseColor.g = g;
     m_diffuseColor.b = b;
     m_diffuseColor.a = a;
+    m_packedDiffuseColor = glm::packUnorm4x8(m_diffuseColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetEmissiveColor(const glm::vec3& color)
 {
     m_emissiveColor = glm::vec4(color, 1.0f);
+    m_packedEmissiveColor = glm::packUnorm4x8(m_emissiveColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetEmissiveColor(const glm::vec4& color)
 {
     m_emissiveColor = color;
+    m_packedEmissiveColor = glm::packUnorm4x8(m_emissiveColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetEmissiveColor(float r, float g, float b, float a)
@@ -87,23 +116,64 @@ void Render::SetEmissiveColor(float r, float g, float b, float a)
     m_emissiveColor.g = g;
     m_emissiveColor.b = b;
     m_emissiveColor.a = a;
+    m_packedEmissiveColor = glm::packUnorm4x8(m_emissiveColor);
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetEmissivePower(float power)
 {
     m_emissivePower = power;
+
+    m_staticDirty |= m_static;
 }
 
 void Render::SetTransparent(bool transparent)
 {
-    m_transparent = transparent;
+    if(m_transparent != transparent)
+    {
+        m_transparent = transparent;
+        m_material = MaterialHandle();
+    }
+
+    m_staticDirty |= m_static;
+}
+
+void Render::SetLayer(int layer)
+{
+    Verify(layer >= 0 && layer < RenderLayerCount, "Invalid argument - \"layer\" is out of range!");
+
+    if(m_layer != layer)
+    {
+        m_layer = (uint8_t)layer;
+        m_staticDirty |= m_static;
+    }
+}
+
+void Render::SetStatic(bool enabled)
+{
+    if(m_static != enabled)
+    {
+        m_static = enabled;
+        m_staticDirty = true;
+    }
 }
 
 const Render::TexturePtr& Render::GetTexture() const
+{
+    return m_texture.GetResource();
+}
+
+const Render::TextureHandle& Render::GetTextureHandle() const
 {
     return m_texture;
 }
 
+const Render::MaterialHandle& Render::GetMaterialHandle() const
+{
+    return m_material;
+}
+
 const glm::vec4& Render::GetRectangle() const
 {
     return m_rectangle;
@@ -124,11 +194,31 @@ float Render::GetEmissivePower() const
     return m_emissivePower;
 }
 
+uint32_t Render::GetPackedDiffuseColor() const
+{
+    return m_packedDiffuseColor;
+}
+
+uint32_t Render::GetPackedEmissiveColor() const
+{
+    return m_packedEmissiveColor;
+}
+
 bool Render::IsTransparent() const
 {
     return m_transparent;
 }
 
+bool Render::IsStatic() const
+{
+    return m_static;
+}
+
+int Render::GetLayer() const
+{
+    return m_layer;
+}
+
 Transform* Render::GetTransform()
 {
     return m_transform;
@@ -2,16 +2,19 @@
 
 #include "Precompiled.hpp"
 #include "Component.hpp"
+#include "System/ResourceRegistry.hpp"
 
 // Forward declarations.
 namespace Graphics
 {
     class Texture;
+    class Material;
 }
 
 namespace Game
 {
     class RenderSystem;
+    class AnimationSystem;
 }
 
 /*
@@ -20,6 +23,16 @@ namespace Game
 
 namespace Game
 {
+    // Number of render layers.
+    // Layers are drawn in ascending order by each camera. Tilemaps and particles are drawn
+    // with the default layer, so lower layers can hold backgrounds and higher layers overlays.
+    const int RenderLayerCount = 32;
+    const int DefaultRenderLayer = 16;
+
+    // User interface layer.
+    // Drawn at the native resolution of the render target after the scaled scene is upscaled.
+    const int InterfaceRenderLayer = RenderLayerCount - 1;
+
     namespace Components
     {
         // Forward declarations.
@@ -31,17 +44,17 @@ namespace Game
         public:
             // Type declarations.
             typedef std::shared_ptr<const Graphics::Texture> TexturePtr;
+            typedef System::ResourceHandle<Graphics::Texture> TextureHandle;
+            typedef System::ResourceHandle<Graphics::Material> MaterialHandle;
 
             // Friend declarations.
             friend RenderSystem;
+            friend AnimationSystem;
 
         public:
             Render();
             ~Render();
 
-            // Calculates the blend of diffuse and emmisive colors.
-            glm::vec4 CalculateColor() const;
-
             // Sets the texture.
             void SetTexture(TexturePtr texture);
 
@@ -66,9 +79,25 @@ namespace Game
             // Sets transparency state.
             void SetTransparent(bool transparent);
 
+            // Sets the render layer.
+            void SetLayer(int layer);
+
+            // Sets static state.
+            // Static sprites are retained by the render system and rebuilt when modified
+            // through this component or their transform, which is meant to happen rarely.
+            void SetStatic(bool enabled);
+
             // Gets the texture.
             const TexturePtr& GetTexture() const;
 
+            // Gets the texture handle.
+            // Handle resolves to the texture without touching its reference count.
+            const TextureHandle& GetTextureHandle() const;
+
+            // Gets the material handle.
+            // Material is resolved by the render system, so it is invalid until the sprite is extracted.
+            const MaterialHandle& GetMaterialHandle() const;
+
             // Gets the rectangle.
             const glm::vec4& GetRectangle() const;
 
@@ -81,26 +110,48 @@ namespace Game
             // Gets the emissive power.
             float GetEmissivePower() const;
 
+            // Gets colors packed as normalized bytes.
+            // Colors are packed when set and blended by the sprite shader.
+            uint32_t GetPackedDiffuseColor() const;
+            uint32_t GetPackedEmissiveColor() const;
+
             // Checks if is transparent.
             bool IsTransparent() const;
 
+            // Checks if is static.
+            bool IsStatic() const;
+
+            // Gets the render layer.
+            int GetLayer() const;
+
             // Gets the transform component.
             Transform* GetTransform();
 
         private:
-            // Texture resource.
-            TexturePtr m_texture;
+            // Hot render parameters.
+            // Read for every sprite in each frame, so they are packed together at the front.
+            // Material is resolved by the render system from the texture and transparency when invalid.
+            Transform* m_transform;
+            MaterialHandle m_material;
+            uint32_t m_packedDiffuseColor;
+            uint32_t m_packedEmissiveColor;
+            float m_emissivePower;
             glm::vec4 m_rectangle;
-
-            // Render parameters.
-            glm::vec2 m_offset;
+            uint8_t m_layer;
+            bool m_static;
+            bool m_staticDirty;
+            uint32_t m_staticVersion;
+
+            // Cold render parameters.
+            // Texture and transparency are only read when the material is resolved.
+            // Colors are kept unpacked only to be returned by getters.
+            // Layer of the static buffer that holds the sprite is kept to detect layer changes.
+            // Version of the transform baked into the static buffer is kept with the hot parameters.
+            TextureHandle m_texture;
+            bool m_transparent;
             glm::vec4 m_diffuseColor;
             glm::vec4 m_emissiveColor;
-            float m_emissivePower;
-            bool m_transparent;
-
-            // Entity components.
-            Transform* m_transform;
+            uint8_t m_staticLayer;
         };
     }
 }
@@ -4,8 +4,16 @@
 #include "ComponentSystem.hpp"
 #include "TransformComponent.hpp"
 #include "RenderComponent.hpp"
+#include "CameraComponent.hpp"
+#include "TilemapComponent.hpp"
+#include "ParticlesComponent.hpp"
 #include "System/Window.hpp"
-#include "Graphics/BasicRenderer.hpp"
+#include "System/ResourceManager.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/Material.hpp"
+#include "Graphics/FrameCapture.hpp"
+#include "Graphics/Font.hpp"
+#include "Graphics/RenderThread.hpp"
 using namespace Game;
 
 namespace
@@ -13,31 +21,264 @@ namespace
     // Error messages.
     #define LogInitializeError() "Failed to initialize the render system! "
 
-    // Global render scale.
-    const glm::vec3 RenderScale(1.0f / 128.0f, 1.0f / 128.0f, 1.0f);
+    // Calculates elapsed time in milliseconds since a timer value.
+    float CalculateElapsedTime(uint64_t startTime)
+    {
+        uint64_t elapsedTime = glfwGetTimerValue() - startTime;
+        return static_cast<float>(elapsedTime * (1000.0 / glfwGetTimerFrequency()));
+    }
+
+    // Sort tuning constants.
+    // Full sort is used when more than a quarter of sprites were added or removed,
+    // or when sprites had to be shifted too many times on average.
+    const std::size_t SortChurnDivisor = 4;
+    const std::size_t SortShiftsPerSprite = 4;
+    const std::size_t InvalidSortIndex = std::numeric_limits<std::size_t>::max();
+
+    // Size of spatial cells that group static sprites in world units.
+    // About the size of the default camera view, while batches may span two cells.
+    const float StaticCellSize = 8.0f;
+    const float StaticBatchExtent = StaticCellSize * 2.0f;
+
+    // Sorts a nearly sorted range with an insertion sort.
+    // Gives up when the number of shifts exceeds the limit, leaving the range partially sorted.
+    template<typename Iterator, typename Compare>
+    bool InsertionSort(Iterator begin, Iterator end, Compare compare, std::size_t shiftLimit)
+    {
+        std::size_t shifts = 0;
+
+        for(Iterator it = begin; it != end; ++it)
+        {
+            auto value = *it;
+            Iterator hole = it;
+
+            while(hole != begin && compare(value, *(hole - 1)))
+            {
+                *hole = *(hole - 1);
+                --hole;
+
+                if(++shifts > shiftLimit)
+                {
+                    *hole = value;
+                    return false;
+                }
+            }
+
+            *hole = value;
+        }
+
+        return true;
+    }
+
+    // Type declarations.
+    typedef System::ResourceRegistry<Graphics::Material> MaterialRegistry;
+
+    // Creates a sprite from entity components.
+    // Material is resolved through the registry, which is passed in to avoid looking it up for each sprite.
+    void CreateSprite(const MaterialRegistry& materialRegistry, Components::Render* render, Graphics::Sprite::Info& info, Graphics::Sprite::Data& data)
+    {
+        Components::Transform* transform = render->GetTransform();
+        Assert(transform != nullptr);
+
+        info = Graphics::Sprite::Info(materialRegistry.Get(render->GetMaterialHandle().GetIdentifier()));
+
+        data.transform = glm::translate(glm::mat4(1.0f), transform->GetPosition());
+        //data.transform = glm::rotate(data.transform, transform->GetRotation(), glm::vec3(0.0f, 0.0f, -1.0f));
+        data.transform = glm::scale(data.transform, transform->GetScale() * RenderScale);
+        //data.transform = glm::translate(data.transform, glm::vec3(0.0f, 0.0f, 0.0f));
+        data.rectangle = render->GetRectangle();
+        data.diffuseColor = render->GetPackedDiffuseColor();
+        data.emissiveColor = render->GetPackedEmissiveColor();
+        data.emissivePower = render->GetEmissivePower();
+    }
+
+    // Compares the draw order of two sprites.
+    bool SpriteSort(const Graphics::Sprite::Info& spriteInfoA, const Graphics::Sprite::Data& spriteDataA,
+        const Graphics::Sprite::Info& spriteInfoB, const Graphics::Sprite::Data& spriteDataB)
+    {
+        // Sort by transparency (opaque first, transparent second).
+        if(spriteInfoA.transparent < spriteInfoB.transparent)
+            return true;
+
+        if(spriteInfoA.transparent == spriteInfoB.transparent)
+        {
+            if(spriteInfoA.transparent)
+            {
+                // Sort transparent by depth (back to front).
+                if(spriteDataA.transform[3][2] < spriteDataB.transform[3][2])
+                    return true;
+
+                if(spriteDataA.transform[3][2] == spriteDataB.transform[3][2])
+                {
+                    // Sort by the y position.
+                    if(spriteDataA.transform[3][1] > spriteDataB.transform[3][1])
+                        return true;
+
+                    if(spriteDataA.transform[3][1] == spriteDataB.transform[3][1])
+                    {
+                        // Sort by material.
+                        if(spriteInfoA.materialIdentifier < spriteInfoB.materialIdentifier)
+                            return true;
+                    }
+                }
+            }
+            else
+            {
+                // Sort opaque by depth (front to back).
+                if(spriteDataA.transform[3][2] > spriteDataB.transform[3][2])
+                    return true;
+
+                if(spriteDataA.transform[3][2] == spriteDataB.transform[3][2])
+                {
+                    // Sort by material.
+                    if(spriteInfoA.materialIdentifier < spriteInfoB.materialIdentifier)
+                        return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // Calculates the key of a spatial cell that contains a sprite.
+    uint64_t CalculateSpriteCell(const Graphics::Sprite::Data& spriteData)
+    {
+        int32_t x = (int32_t)std::floor(spriteData.transform[3][0] / StaticCellSize);
+        int32_t y = (int32_t)std::floor(spriteData.transform[3][1] / StaticCellSize);
+
+        return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+    }
+
+    // Compares the draw order of two static sprites.
+    // Follows the sprite order, but groups sprites by their cells before materials, so batches stay compact.
+    bool StaticSpriteSort(const Graphics::Sprite::Info& spriteInfoA, const Graphics::Sprite::Data& spriteDataA, uint64_t cellA,
+        const Graphics::Sprite::Info& spriteInfoB, const Graphics::Sprite::Data& spriteDataB, uint64_t cellB)
+    {
+        // Sort by transparency (opaque first, transparent second).
+        if(spriteInfoA.transparent != spriteInfoB.transparent)
+            return spriteInfoA.transparent < spriteInfoB.transparent;
+
+        // Sort transparent by depth (back to front) and opaque by depth (front to back).
+        float depthA = spriteDataA.transform[3][2];
+        float depthB = spriteDataB.transform[3][2];
+
+        if(depthA != depthB)
+            return spriteInfoA.transparent ? depthA < depthB : depthA > depthB;
+
+        // Sort transparent by the y position.
+        if(spriteInfoA.transparent && spriteDataA.transform[3][1] != spriteDataB.transform[3][1])
+            return spriteDataA.transform[3][1] > spriteDataB.transform[3][1];
+
+        // Sort by cell and material.
+        if(cellA != cellB)
+            return cellA < cellB;
+
+        return spriteInfoA.materialIdentifier < spriteInfoB.materialIdentifier;
+    }
+
+    // Checks if a sprite has to be drawn before a static batch.
+    // Follows the sprite sort order, with static batches drawn first among equal sprites.
+    // Transparent batches have to be split into rows, so each has a single y position.
+    bool SpriteBeforeBatch(const Graphics::Sprite::Info& spriteInfo, const Graphics::Sprite::Data& spriteData,
+        const Graphics::StaticSpriteBuffer::Batch& batch)
+    {
+        if(spriteInfo.transparent != batch.info.transparent)
+            return spriteInfo.transparent < batch.info.transparent;
+
+        if(spriteInfo.transparent)
+        {
+            // Transparent sprites are drawn back to front.
+            if(spriteData.transform[3][2] != batch.depth)
+                return spriteData.transform[3][2] < batch.depth;
+
+            // Transparent sprites of the same depth are drawn by their y position.
+            return spriteData.transform[3][1] > batch.height;
+        }
+        else
+        {
+            // Opaque sprites are drawn front to back.
+            return spriteData.transform[3][2] > batch.depth;
+        }
+    }
+}
+
+FrameStats::FrameStats() :
+    spritesSubmitted(0),
+    spritesVisible(0),
+    spritesCulled(0),
+    spritesStatic(0),
+    chunksVisible(0),
+    chunksCulled(0),
+    chunksRebuilt(0),
+    particlesVisible(0),
+    particlesCulled(0),
+    resolutionScale(1.0f),
+    stateCallsIssued(0),
+    stateCallsSkipped(0),
+    commandCount(0),
+    commandBytes(0),
+    queueDepth(0),
+    extractTime(0.0f),
+    sortTime(0.0f),
+    submitTime(0.0f),
+    stallTime(0.0f),
+    executeTime(0.0f),
+    presentTime(0.0f),
+    gpuTimesAvailable(false),
+    gpuScopesDropped(0)
+{
+}
+
+RenderSystem::Layer::Layer() :
+    staticCount(0),
+    staticExtracted(0),
+    staticDirty(false)
+{
 }
 
 RenderSystemInfo::RenderSystemInfo() :
     window(nullptr),
-    basicRenderer(nullptr),
+    resourceManager(nullptr),
+    renderThread(nullptr),
     entitySystem(nullptr),
-    componentSystem(nullptr)
+    componentSystem(nullptr),
+    framebuffer(nullptr),
+    frameCapture(nullptr),
+    dynamicResolution(false),
+    targetFrameTime(16.6f),
+    minResolutionScale(0.5f)
 {
 }
 
 RenderSystem::RenderSystem() :
     m_window(nullptr),
-    m_basicRenderer(nullptr),
+    m_resourceManager(nullptr),
+    m_renderThread(nullptr),
+    m_framebuffer(nullptr),
+    m_frameCapture(nullptr),
     m_transformComponents(nullptr),
     m_renderComponents(nullptr),
+    m_cameraComponents(nullptr),
+    m_tilemapComponents(nullptr),
+    m_particlesComponents(nullptr),
+    m_frameIndex(0),
     m_initialized(false)
 {
     // Bind event receivers.
     m_entityFinalize.Bind<RenderSystem, &RenderSystem::FinalizeComponent>(this);
+    m_entityDestroy.Bind<RenderSystem, &RenderSystem::OnEntityDestroy>(this);
 }
 
 RenderSystem::~RenderSystem()
 {
+    // Destroy the scene framebuffer with the context it has been created in.
+    if(m_sceneFramebuffer != nullptr)
+    {
+        m_renderThread->Invoke([this]()
+        {
+            m_sceneFramebuffer = nullptr;
+        });
+    }
 }
 
 bool RenderSystem::Initialize(const RenderSystemInfo& info)
@@ -56,9 +297,15 @@ bool RenderSystem::Initialize(const RenderSystemInfo& info)
         return false;
     }
 
-    if(info.basicRenderer == nullptr)
+    if(info.resourceManager == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.resourceManager\" is null.";
+        return false;
+    }
+
+    if(info.renderThread == nullptr)
     {
-        Log() << LogInitializeError() << "Invalid argument - \"info.basicRenderer\" is null.";
+        Log() << LogInitializeError() << "Invalid argument - \"info.renderThread\" is null.";
         return false;
     }
 
@@ -74,25 +321,87 @@ bool RenderSystem::Initialize(const RenderSystemInfo& info)
         return false;
     }
 
+    if(info.framebuffer != nullptr && !info.framebuffer->IsValid())
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.framebuffer\" is invalid.";
+        return false;
+    }
+
+    if(info.frameCapture != nullptr && !info.frameCapture->IsValid())
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.frameCapture\" is invalid.";
+        return false;
+    }
+
     // Save instance references.
     m_window = info.window;
-    m_basicRenderer = info.basicRenderer;
+    m_resourceManager = info.resourceManager;
+    m_renderThread = info.renderThread;
+    m_framebuffer = info.framebuffer;
+    m_frameCapture = info.frameCapture;
 
     SCOPE_GUARD_BEGIN(!m_initialized);
     {
         m_window = nullptr;
-        m_basicRenderer = nullptr;
+        m_resourceManager = nullptr;
+        m_renderThread = nullptr;
+        m_framebuffer = nullptr;
+        m_frameCapture = nullptr;
+    }
+    SCOPE_GUARD_END();
+
+    // Create a resolution scaler.
+    if(info.dynamicResolution)
+    {
+        Graphics::ResolutionScalerInfo resolutionScalerInfo;
+        resolutionScalerInfo.targetFrameTime = info.targetFrameTime;
+        resolutionScalerInfo.minScale = info.minResolutionScale;
+
+        if(!m_resolutionScaler.Initialize(resolutionScalerInfo))
+        {
+            Log() << LogInitializeError() << "Could not initialize the resolution scaler.";
+            return false;
+        }
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_resolutionScaler = Graphics::ResolutionScaler());
+
+    // Create a text renderer for the frame stats overlay.
+    if(info.overlayFont != nullptr)
+    {
+        Graphics::TextRendererInfo textRendererInfo;
+        textRendererInfo.resourceManager = info.resourceManager;
+
+        if(!m_textRenderer.Initialize(textRendererInfo))
+        {
+            Log() << LogInitializeError() << "Could not initialize the text renderer.";
+            return false;
+        }
+
+        m_overlayFont = info.overlayFont;
+    }
+
+    SCOPE_GUARD_BEGIN(!m_initialized);
+    {
+        m_textRenderer = Graphics::TextRenderer();
+        m_overlayFont = nullptr;
     }
     SCOPE_GUARD_END();
 
     // Retrieve component pools.
     m_transformComponents = info.componentSystem->GetPool<Components::Transform>();
     m_renderComponents = info.componentSystem->GetPool<Components::Render>();
+    m_cameraComponents = info.componentSystem->GetPool<Components::Camera>();
+    m_tilemapComponents = info.componentSystem->GetPool<Components::Tilemap>();
+    m_particlesComponents = info.componentSystem->GetPool<Components::Particles>();
 
     SCOPE_GUARD_BEGIN(!m_initialized);
     {
         m_transformComponents = nullptr;
         m_renderComponents = nullptr;
+        m_cameraComponents = nullptr;
+        m_tilemapComponents = nullptr;
+        m_particlesComponents = nullptr;
     }
     SCOPE_GUARD_END();
 
@@ -108,22 +417,62 @@ bool RenderSystem::Initialize(const RenderSystemInfo& info)
         return false;
     }
 
-    // Set screen space target size.
-    m_screenSpace.SetSourceSize(10.0f, 10.0f);
+    if(m_cameraComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for camera components.";
+        return false;
+    }
+
+    if(m_tilemapComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for tilemap components.";
+        return false;
+    }
+
+    if(m_particlesComponents == nullptr)
+    {
+        Log() << LogInitializeError() << "Could not get the pool for particles components.";
+        return false;
+    }
+
+    // Create empty static sprite buffers of layers.
+    for(Layer& layer : m_layers)
+    {
+        layer.staticSprites = std::make_shared<Graphics::StaticSpriteBuffer>();
+    }
 
-    SCOPE_GUARD_IF(!m_initialized, m_screenSpace = Graphics::ScreenSpace());
+    SCOPE_GUARD_BEGIN(!m_initialized);
+    {
+        for(Layer& layer : m_layers)
+        {
+            layer.staticSprites = nullptr;
+        }
+    }
+    SCOPE_GUARD_END();
 
     // Allocate initial sprite list memory.
     const int SpriteListSize = 128;
+    m_layers[DefaultRenderLayer].culler.Reserve(SpriteListSize);
+    m_layers[DefaultRenderLayer].components.reserve(SpriteListSize);
+    m_layers[DefaultRenderLayer].entities.reserve(SpriteListSize);
+    m_cullVisible.reserve(SpriteListSize);
     m_spriteInfo.reserve(SpriteListSize);
     m_spriteData.reserve(SpriteListSize);
     m_spriteSort.reserve(SpriteListSize);
+    m_spriteEntities.reserve(SpriteListSize);
+    m_staticVisible.reserve(SpriteListSize);
 
     SCOPE_GUARD_BEGIN(!m_initialized);
     {
+        m_layers[DefaultRenderLayer].culler = Graphics::SpriteCuller();
+        Utility::ClearContainer(m_layers[DefaultRenderLayer].components);
+        Utility::ClearContainer(m_layers[DefaultRenderLayer].entities);
+        Utility::ClearContainer(m_cullVisible);
+        Utility::ClearContainer(m_staticVisible);
         Utility::ClearContainer(m_spriteInfo);
         Utility::ClearContainer(m_spriteData);
         Utility::ClearContainer(m_spriteSort);
+        Utility::ClearContainer(m_spriteEntities);
     }
     SCOPE_GUARD_END();
 
@@ -136,6 +485,14 @@ bool RenderSystem::Initialize(const RenderSystemInfo& info)
 
     SCOPE_GUARD_IF(!m_initialized, m_entityFinalize.Unsubscribe());
 
+    if(!m_entityDestroy.Subscribe(info.entitySystem->eventDispatchers.entityDestroy))
+    {
+        Log() << LogInitializeError() << "Could not subscribe to the entity system.";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_entityDestroy.Unsubscribe());
+
     // Success!
     return m_initialized = true;
 }
@@ -157,139 +514,1031 @@ bool RenderSystem::FinalizeComponent(EntityHandle entity)
         renderComponent->m_transform = transformComponent;
     }
 
+    // Finalize a camera component.
+    auto cameraComponent = m_cameraComponents->Lookup(entity);
+
+    if(cameraComponent != nullptr)
+    {
+        // Get the transform component.
+        auto transformComponent = m_transformComponents->Lookup(entity);
+        if(transformComponent == nullptr) return false;
+
+        // Set the reference for transform component.
+        cameraComponent->m_transform = transformComponent;
+    }
+
+    // Finalize a tilemap component.
+    auto tilemapComponent = m_tilemapComponents->Lookup(entity);
+
+    if(tilemapComponent != nullptr)
+    {
+        // Get the transform component.
+        auto transformComponent = m_transformComponents->Lookup(entity);
+        if(transformComponent == nullptr) return false;
+
+        // Set the reference for transform component.
+        tilemapComponent->m_transform = transformComponent;
+    }
+
     return true;
 }
 
+void RenderSystem::OnEntityDestroy(EntityHandle entity)
+{
+    // Rebuild the layer that retains a static sprite of the entity.
+    // Render component may have been already destroyed, so layers are searched by the entity.
+    for(Layer& layer : m_layers)
+    {
+        if(std::binary_search(layer.staticEntities.begin(), layer.staticEntities.end(), entity))
+        {
+            layer.staticDirty = true;
+        }
+    }
+}
+
 void RenderSystem::Draw()
 {
     if(!m_initialized)
         return;
 
-    // Get window size.
-    int windowWidth = m_window->GetWidth();
-    int windowHeight = m_window->GetHeight();
+    // Reset frame stats.
+    m_frameStats = FrameStats();
+    m_frameIndex += 1;
+
+    // Get the command list of the recorded frame.
+    Graphics::RenderCommandList& commandList = m_renderThread->GetCommandList();
+
+    // Bind the render target and set the viewport to its size.
+    GLuint targetHandle = 0;
+    int targetWidth = 0;
+    int targetHeight = 0;
+
+    if(m_framebuffer != nullptr)
+    {
+        targetHandle = m_framebuffer->GetHandle();
+        targetWidth = m_framebuffer->GetWidth();
+        targetHeight = m_framebuffer->GetHeight();
+    }
+    else
+    {
+        targetWidth = m_window->GetWidth();
+        targetHeight = m_window->GetHeight();
+    }
+
+    // Choose the scene target.
+    // Scene is drawn offscreen when its resolution is scaled down.
+    GLuint sceneHandle = targetHandle;
+    int sceneWidth = targetWidth;
+    int sceneHeight = targetHeight;
 
-    // Set viewport size.
-    glViewport(0, 0, windowWidth, windowHeight);
+    bool sceneScaled = m_resolutionScaler.IsValid() && m_resolutionScaler.GetScale() < 1.0f &&
+        this->UpdateSceneFramebuffer(targetWidth, targetHeight);
 
-    // Set screen space source size.
-    m_screenSpace.SetTargetSize(windowWidth, windowHeight);
+    if(sceneScaled)
+    {
+        sceneHandle = m_sceneFramebuffer->GetHandle();
+        sceneWidth = m_resolutionScaler.CalculateSize(targetWidth);
+        sceneHeight = m_resolutionScaler.CalculateSize(targetHeight);
+
+        m_frameStats.resolutionScale = m_resolutionScaler.GetScale();
+    }
 
-    // Calculate camera view.
-    glm::mat4 view = glm::translate(glm::mat4(1.0f), -glm::vec3(m_screenSpace.GetOffset(), 0.0f));
-    glm::mat4 transform = m_screenSpace.GetTransform() * view;
+    commandList.BeginPass("Scene");
+    commandList.SetTarget(sceneHandle, sceneWidth, sceneHeight);
 
     // Clear the backbuffer.
     Graphics::ClearValues clearValues;
     clearValues.color = glm::vec4(0.0f, 0.35f, 0.35f, 1.0f);
     clearValues.depth = 1.0f;
 
-    m_basicRenderer->Clear(clearValues);
-
-    // Iterate over all render components.
-    auto componentsBegin = m_renderComponents->Begin();
-    auto componentsEnd = m_renderComponents->End();
+    commandList.Clear(clearValues);
 
-    for(auto it = componentsBegin; it != componentsEnd; ++it)
-    {
-        // Get entity components.
-        Components::Render* render = &it->second;
-        Assert(render != nullptr);
+    // Extract sprites from render components.
+    uint64_t extractStart = glfwGetTimerValue();
 
-        Components::Transform* transform = render->GetTransform();
-        Assert(transform != nullptr);
+    this->ExtractSprites();
 
-        // Add sprite to render the list.
-        Graphics::Sprite::Info info;
-        info.texture = render->GetTexture().get();
-        info.transparent = render->IsTransparent();
-        info.filter = false;
+    m_frameStats.extractTime = CalculateElapsedTime(extractStart);
 
-        Graphics::Sprite::Data data;
-        data.transform = glm::translate(data.transform, transform->GetPosition());
-        //data.transform = glm::rotate(data.transform, transform->GetRotation(), glm::vec3(0.0f, 0.0f, -1.0f));
-        data.transform = glm::scale(data.transform, transform->GetScale() * RenderScale);
-        //data.transform = glm::translate(data.transform, glm::vec3(0.0f, 0.0f, 0.0f));
-        data.rectangle = render->GetRectangle();
-        data.color = render->CalculateColor();
+    // Collect cameras in their draw order.
+    auto camerasBegin = m_cameraComponents->Begin();
+    auto camerasEnd = m_cameraComponents->End();
 
-        m_spriteInfo.push_back(info);
-        m_spriteData.push_back(data);
+    for(auto it = camerasBegin; it != camerasEnd; ++it)
+    {
+        m_cameras.push_back(&it->second);
     }
 
-    // Define sorting function.
-    auto SpriteSort = [&](const int& a, const int& b)
+    std::stable_sort(m_cameras.begin(), m_cameras.end(), [](const Components::Camera* a, const Components::Camera* b)
     {
-        // Get sprite info and data.
-        const auto& spriteInfoA = m_spriteInfo[a];
-        const auto& spriteDataA = m_spriteData[a];
+        return a->GetOrder() < b->GetOrder();
+    });
 
-        const auto& spriteInfoB = m_spriteInfo[b];
-        const auto& spriteDataB = m_spriteData[b];
+    if(m_cameras.empty())
+    {
+        m_cameras.push_back(&m_defaultCamera);
+    }
 
-        // Sort by transparency (opaque first, transparent second).
-        if(spriteInfoA.transparent < spriteInfoB.transparent)
-            return true;
+    // Draw the scene.
+    const uint32_t InterfaceLayerMask = 1u << InterfaceRenderLayer;
 
-        if(spriteInfoA.transparent == spriteInfoB.transparent)
-        {
-            if(spriteInfoA.transparent)
-            {
-                // Sort transparent by depth (back to front).
-                if(spriteDataA.transform[3][2] < spriteDataB.transform[3][2])
-                    return true;
+    this->DrawCameras(commandList, sceneWidth, sceneHeight, ~InterfaceLayerMask);
 
-                if(spriteDataA.transform[3][2] == spriteDataB.transform[3][2])
-                {
-                    // Sort by the y position.
-                    if(spriteDataA.transform[3][1] > spriteDataB.transform[3][1])
-                        return true;
+    commandList.EndPass();
 
-                    if(spriteDataA.transform[3][1] == spriteDataB.transform[3][1])
-                    {
-                        // Sort by texture.
-                        if(spriteInfoA.texture < spriteInfoB.texture)
-                            return true;
-                    }
-                }
-            }
-            else
-            {
-                // Sort opaque by depth (front to back).
-                if(spriteDataA.transform[3][2] > spriteDataB.transform[3][2])
-                    return true;
+    // Upscale the scene to the render target.
+    // Depth is cleared, as the interface is drawn on top of the upscaled scene.
+    if(sceneScaled)
+    {
+        commandList.BeginPass("Blit");
+        commandList.BlitTarget(sceneHandle, sceneWidth, sceneHeight, targetHandle, targetWidth, targetHeight);
 
-                if(spriteDataA.transform[3][2] == spriteDataB.transform[3][2])
-                {
-                    // Sort by texture.
-                    if(spriteInfoA.texture < spriteInfoB.texture)
-                        return true;
-                }
-            }
-        }
+        Graphics::ClearValues depthClearValues;
+        depthClearValues.depth = 1.0f;
 
-        return false;
-    };
+        commandList.Clear(depthClearValues);
+        commandList.EndPass();
+    }
 
-    // Render ordered sprite batches.
-    Assert(m_spriteInfo.size() == m_spriteData.size());
+    // Draw the interface at the native resolution.
+    commandList.BeginPass("Interface");
+    this->DrawCameras(commandList, targetWidth, targetHeight, InterfaceLayerMask);
+    commandList.EndPass();
 
-    if(m_spriteInfo.size() != 0)
+    // Count chunks and particles that were not visible to any camera.
+    std::size_t chunkCount = 0;
+    std::size_t particleCount = 0;
+
+    auto tilemapsBegin = m_tilemapComponents->Begin();
+    auto tilemapsEnd = m_tilemapComponents->End();
+
+    for(auto it = tilemapsBegin; it != tilemapsEnd; ++it)
+    {
+        if(it->second.GetTexture() != nullptr)
+        {
+            chunkCount += it->second.m_chunks.size();
+        }
+    }
+
+    auto particlesBegin = m_particlesComponents->Begin();
+    auto particlesEnd = m_particlesComponents->End();
+
+    for(auto it = particlesBegin; it != particlesEnd; ++it)
+    {
+        if(it->second.GetTexture() != nullptr)
+        {
+            particleCount += it->second.GetParticleCount();
+        }
+    }
+
+    m_frameStats.chunksCulled = chunkCount - m_frameStats.chunksVisible;
+    m_frameStats.particlesCulled = particleCount - m_frameStats.particlesVisible;
+
+    // Capture the finished frame.
+    if(m_frameCapture != nullptr)
+    {
+        m_frameCapture->Record(commandList, targetHandle, targetWidth, targetHeight);
+    }
+
+    m_cameras.clear();
+
+    // Clear the extracted sprites.
+    for(Layer& layer : m_layers)
+    {
+        layer.culler.Clear();
+        layer.components.clear();
+        layer.entities.clear();
+    }
+
+    // Collect renderer stats of the last executed frame.
+    Graphics::RenderThreadStats renderThreadStats = m_renderThread->GetStats();
+
+    m_frameStats.renderer = renderThreadStats.renderer;
+    m_frameStats.stateCallsIssued = renderThreadStats.stateCallsIssued;
+    m_frameStats.stateCallsSkipped = renderThreadStats.stateCallsSkipped;
+    m_frameStats.commandCount = renderThreadStats.commandCount;
+    m_frameStats.commandBytes = renderThreadStats.commandBytes;
+    m_frameStats.queueDepth = renderThreadStats.queueDepth;
+    m_frameStats.stallTime = renderThreadStats.stallTime;
+    m_frameStats.executeTime = renderThreadStats.executeTime;
+    m_frameStats.presentTime = renderThreadStats.presentTime;
+    m_frameStats.gpuTimesAvailable = renderThreadStats.gpuTimesAvailable;
+    m_frameStats.gpuTimes = std::move(renderThreadStats.gpuTimes);
+    m_frameStats.gpuScopesDropped = renderThreadStats.gpuScopesDropped;
+
+    // Update the resolution scale with the GPU time of the last executed frame.
+    // Execution time of the render thread is used when GPU timings are unavailable.
+    if(m_resolutionScaler.IsValid())
+    {
+        float frameTime = m_frameStats.executeTime;
+
+        if(m_frameStats.gpuTimesAvailable)
+        {
+            for(const auto& result : m_frameStats.gpuTimes)
+            {
+                if(std::strcmp(result.name, "Frame") == 0)
+                {
+                    frameTime = result.time;
+                    break;
+                }
+            }
+        }
+
+        m_resolutionScaler.Update(frameTime);
+    }
+
+    // Draw the overlay with stats of the finished frame.
+    // Overlay is drawn after the capture, so captured frames do not depend on it.
+    if(m_overlayFont != nullptr)
+    {
+        this->DrawOverlay(commandList, targetHandle, targetWidth, targetHeight);
+    }
+}
+
+RenderSystem::MaterialPtr RenderSystem::CreateMaterial(const TexturePtr& texture, bool transparent)
+{
+    Graphics::MaterialInfo materialInfo;
+    materialInfo.texture = texture;
+    materialInfo.blendMode = transparent ? Graphics::BlendModes::Alpha : Graphics::BlendModes::Opaque;
+    materialInfo.textureFilter = GL_NEAREST;
+
+    return Graphics::Material::Create(m_resourceManager, materialInfo);
+}
+
+bool RenderSystem::UpdateSceneFramebuffer(int width, int height)
+{
+    if(width <= 0 || height <= 0)
+        return false;
+
+    // Keep the framebuffer if the render target has not been resized.
+    // Scale changes only use a smaller part of it.
+    if(m_sceneFramebuffer != nullptr)
+    {
+        if(m_sceneFramebuffer->GetWidth() == width && m_sceneFramebuffer->GetHeight() == height)
+            return true;
+    }
+
+    // Recreate the framebuffer with the context of the render thread.
+    // Framebuffers cannot be shared between contexts.
+    Graphics::FramebufferInfo framebufferInfo;
+    framebufferInfo.width = width;
+    framebufferInfo.height = height;
+
+    bool framebufferCreated = false;
+
+    m_renderThread->Invoke([&]()
     {
-        // Create sort permutation.
-        m_spriteSort.resize(m_spriteInfo.size());
-        std::iota(m_spriteSort.begin(), m_spriteSort.end(), 0);
-        std::sort(m_spriteSort.begin(), m_spriteSort.end(), SpriteSort);
+        m_sceneFramebuffer = std::make_unique<Graphics::Framebuffer>();
+        framebufferCreated = m_sceneFramebuffer->Create(framebufferInfo);
 
-        // Sort sprite lists.
-        Utility::Reorder(m_spriteInfo, m_spriteSort);
-        Utility::Reorder(m_spriteData, m_spriteSort);
+        if(!framebufferCreated)
+        {
+            m_sceneFramebuffer = nullptr;
+        }
+    });
+
+    // Stop scaling the resolution if the framebuffer cannot be created.
+    if(!framebufferCreated)
+    {
+        LogWarning() << "Could not create a scene framebuffer, dynamic resolution has been disabled.";
+        m_resolutionScaler = Graphics::ResolutionScaler();
+        return false;
+    }
+
+    return true;
+}
+
+void RenderSystem::ExtractSprites()
+{
+    // Iterate over all render components.
+    auto componentsBegin = m_renderComponents->Begin();
+    auto componentsEnd = m_renderComponents->End();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        // Get entity components.
+        Components::Render* render = &it->second;
+        Assert(render != nullptr);
+
+        Components::Transform* transform = render->GetTransform();
+        Assert(transform != nullptr);
 
-        // Draw sprites.
-        m_basicRenderer->DrawSprites(m_spriteInfo, m_spriteData, transform);
+        Layer& layer = m_layers[render->GetLayer()];
 
-        // Clear the sprite list.
-        m_spriteInfo.clear();
-        m_spriteData.clear();
+        // Resolve the material after its texture or transparency has changed.
+        if(!render->m_material.IsValid())
+        {
+            render->m_material = Components::Render::MaterialHandle(this->CreateMaterial(render->GetTexture(), render->IsTransparent()));
+        }
+
+        // Check if static sprites have been modified.
+        // Layer that previously held the sprite has to be rebuilt too.
+        if(render->m_staticDirty)
+        {
+            render->m_staticDirty = false;
+
+            layer.staticDirty = true;
+            m_layers[render->m_staticLayer].staticDirty = true;
+        }
+
+        // Skip static sprites that are retained in the static buffer.
+        // Buffer is rebuilt if a transform has been modified since it was baked.
+        if(render->IsStatic())
+        {
+            if(transform->GetVersion() != render->m_staticVersion)
+            {
+                layer.staticDirty = true;
+            }
+
+            ++layer.staticExtracted;
+            continue;
+        }
+
+        // Calculate sprite world bounds.
+        // Sprite size can be negative for mirrored sprites.
+        glm::vec2 position = glm::vec2(transform->GetPosition());
+        glm::vec2 scale = glm::vec2(transform->GetScale() * RenderScale);
+        glm::vec2 size = glm::abs(glm::vec2(render->GetRectangle().z, render->GetRectangle().w)) * scale;
+
+        glm::vec2 boundsMin = glm::min(position, position + size);
+        glm::vec2 boundsMax = glm::max(position, position + size);
+
+        // Add sprite bounds to the culling list of its layer.
+        layer.culler.AddBounds(glm::vec4(boundsMin.x, boundsMax.x, boundsMin.y, boundsMax.y));
+        layer.components.push_back(render);
+        layer.entities.push_back(it->first);
+    }
+
+    // Rebuild static sprites of layers that had any added, removed or modified.
+    // Destroyed entities mark their layers, while components destroyed alone are detected by a change in the number of static sprites.
+    for(int layerIndex = 0; layerIndex < RenderLayerCount; ++layerIndex)
+    {
+        Layer& layer = m_layers[layerIndex];
+
+        if(layer.staticDirty || layer.staticExtracted != layer.staticCount)
+        {
+            this->RebuildStaticSprites(layerIndex);
+        }
+
+        layer.staticDirty = false;
+        layer.staticExtracted = 0;
+
+        // Count sprites once per frame, even if a layer is drawn by multiple cameras.
+        m_frameStats.spritesSubmitted += layer.components.size() + layer.staticSprites->GetSpriteCount();
+        m_frameStats.spritesStatic += layer.staticSprites->GetSpriteCount();
     }
 }
+
+void RenderSystem::DrawCameras(Graphics::RenderCommandList& commandList, int targetWidth, int targetHeight, uint32_t layerMask)
+{
+    for(Components::Camera* camera : m_cameras)
+    {
+        // Set screen space sizes.
+        Graphics::ScreenSpace screenSpace;
+        screenSpace.SetSourceSize(camera->GetViewSize().x, camera->GetViewSize().y);
+        screenSpace.SetTargetSize(targetWidth, targetHeight);
+
+        // Calculate camera view.
+        // Camera's position is placed at the center of the screen space.
+        glm::vec2 cameraCenter(0.0f, 0.0f);
+
+        if(camera->GetTransform() != nullptr)
+        {
+            cameraCenter = glm::vec2(camera->GetTransform()->GetPosition());
+        }
+
+        glm::vec2 cameraPosition = screenSpace.GetOffset() + cameraCenter;
+
+        glm::mat4 view = glm::translate(glm::mat4(1.0f), -glm::vec3(cameraPosition, 0.0f));
+        glm::mat4 transform = screenSpace.GetTransform() * view;
+
+        // Calculate the visible world rectangle.
+        // Screen space view moves the origin by its offset, while the camera view moves it back by its position.
+        glm::vec2 viewOffset = cameraPosition - screenSpace.GetOffset();
+
+        glm::vec4 cameraRectangle = screenSpace.GetRectangle();
+        cameraRectangle += glm::vec4(viewOffset.x, viewOffset.x, viewOffset.y, viewOffset.y);
+
+        // Draw layers from the lowest one.
+        uint32_t cameraMask = camera->GetLayerMask() & layerMask;
+
+        for(int layerIndex = 0; layerIndex < RenderLayerCount; ++layerIndex)
+        {
+            if(cameraMask & (1u << layerIndex))
+            {
+                this->DrawLayer(commandList, camera, layerIndex, transform, cameraRectangle);
+            }
+        }
+    }
+}
+
+void RenderSystem::DrawLayer(Graphics::RenderCommandList& commandList, Components::Camera* camera, int layerIndex, const glm::mat4& transform, const glm::vec4& cameraRectangle)
+{
+    Assert(camera != nullptr);
+    Assert(m_spriteInfo.empty() && m_spriteData.empty());
+
+    Layer& layer = m_layers[layerIndex];
+
+    // Skip layers without sprites.
+    // Default layer is always drawn, as it also holds tilemaps, particles and debug primitives.
+    if(layerIndex != DefaultRenderLayer && layer.components.empty() && layer.staticSprites->GetSpriteCount() == 0)
+        return;
+
+    // Draw tilemaps as the background of the default layer.
+    // Tilemaps are drawn before sprites are added, as chunks are rebuilt using the sprite lists.
+    float tilemapTime = 0.0f;
+
+    if(layerIndex == DefaultRenderLayer)
+    {
+        uint64_t tilemapStart = glfwGetTimerValue();
+
+        this->DrawTilemaps(commandList, transform, cameraRectangle);
+
+        tilemapTime = CalculateElapsedTime(tilemapStart);
+    }
+
+    // Cull sprites outside of the camera view.
+    uint64_t cullStart = glfwGetTimerValue();
+
+    layer.culler.Cull(cameraRectangle, m_cullVisible);
+
+    m_frameStats.spritesVisible += m_cullVisible.size();
+    m_frameStats.spritesCulled += layer.components.size() - m_cullVisible.size();
+
+    // Add visible sprites to the render list.
+    const MaterialRegistry& materialRegistry = MaterialRegistry::GetGlobal();
+
+    for(std::size_t index : m_cullVisible)
+    {
+        // Add sprite to render the list.
+        Graphics::Sprite::Info info;
+        Graphics::Sprite::Data data;
+        CreateSprite(materialRegistry, layer.components[index], info, data);
+
+        m_spriteInfo.push_back(info);
+        m_spriteData.push_back(data);
+        m_spriteEntities.push_back(layer.entities[index]);
+    }
+
+    m_cullVisible.clear();
+
+    m_frameStats.extractTime += CalculateElapsedTime(cullStart);
+
+    // Sort dynamic sprites.
+    // Each camera keeps the order of its layers from the previous frame.
+    uint64_t sortStart = glfwGetTimerValue();
+
+    this->SortSprites(camera->m_layerSort[layerIndex]);
+
+    m_frameStats.sortTime += CalculateElapsedTime(sortStart);
+
+    // Render ordered sprite batches.
+    // Retained static batches are already sorted and get merged with the dynamic sprites.
+    uint64_t submitStart = glfwGetTimerValue();
+
+    const StaticSpriteBufferPtr& staticSprites = layer.staticSprites;
+
+    const std::size_t dynamicCount = m_spriteInfo.size();
+    const std::size_t batchCount = staticSprites->GetBatchCount();
+
+    std::size_t dynamicDrawn = 0;
+    std::size_t batchIndex = 0;
+
+    while(batchIndex != batchCount)
+    {
+        // Draw dynamic sprites that come before the next static batch.
+        std::size_t dynamicNext = dynamicDrawn;
+
+        while(dynamicNext != dynamicCount && SpriteBeforeBatch(m_spriteInfo[dynamicNext], m_spriteData[dynamicNext], staticSprites->GetBatch(batchIndex)))
+        {
+            ++dynamicNext;
+        }
+
+        commandList.DrawSprites(m_spriteInfo.data() + dynamicDrawn, m_spriteData.data() + dynamicDrawn, dynamicNext - dynamicDrawn, transform);
+        dynamicDrawn = dynamicNext;
+
+        // Collect visible static batches until a dynamic sprite has to be drawn in between.
+        do
+        {
+            const auto& batch = staticSprites->GetBatch(batchIndex);
+
+            if(batch.bounds.x <= cameraRectangle.y && batch.bounds.y >= cameraRectangle.x &&
+                batch.bounds.z <= cameraRectangle.w && batch.bounds.w >= cameraRectangle.z)
+            {
+                m_staticVisible.push_back(batchIndex);
+                m_frameStats.spritesVisible += batch.count;
+            }
+            else
+            {
+                m_frameStats.spritesCulled += batch.count;
+            }
+
+            ++batchIndex;
+        }
+        while(batchIndex != batchCount && (dynamicDrawn == dynamicCount ||
+            !SpriteBeforeBatch(m_spriteInfo[dynamicDrawn], m_spriteData[dynamicDrawn], staticSprites->GetBatch(batchIndex))));
+
+        // Draw static batches.
+        commandList.DrawStaticSprites(staticSprites, m_staticVisible.data(), m_staticVisible.size(), transform);
+        m_staticVisible.clear();
+    }
+
+    // Draw remaining dynamic sprites.
+    if(dynamicDrawn != dynamicCount)
+    {
+        commandList.DrawSprites(m_spriteInfo.data() + dynamicDrawn, m_spriteData.data() + dynamicDrawn, dynamicCount - dynamicDrawn, transform);
+    }
+
+    // Draw particles and debug primitives on top of the default layer.
+    // Debug primitives are flushed by the first camera that draws it.
+    if(layerIndex == DefaultRenderLayer)
+    {
+        this->DrawParticles(commandList, transform, cameraRectangle);
+
+        m_debugDraw.Flush(commandList, transform);
+    }
+
+    // Clear the sprite list.
+    m_spriteInfo.clear();
+    m_spriteData.clear();
+    m_spriteEntities.clear();
+
+    m_frameStats.submitTime += CalculateElapsedTime(submitStart) + tilemapTime;
+}
+
+void RenderSystem::SortSprites(Components::Camera::LayerSort& layerSort)
+{
+    Assert(m_spriteInfo.size() == m_spriteData.size());
+    Assert(m_spriteInfo.size() == m_spriteEntities.size());
+
+    const std::size_t spriteCount = m_spriteInfo.size();
+
+    // Forget the previous order of a layer that has become empty.
+    if(spriteCount == 0)
+    {
+        layerSort.inputs.clear();
+        layerSort.order.clear();
+        return;
+    }
+
+    auto SpriteSortIndex = [&](const std::size_t& a, const std::size_t& b)
+    {
+        return SpriteSort(m_spriteInfo[a], m_spriteData[a], m_spriteInfo[b], m_spriteData[b]);
+    };
+
+    // Collect values that sprites are sorted by.
+    m_sortInputs.resize(spriteCount);
+
+    for(std::size_t i = 0; i < spriteCount; ++i)
+    {
+        Components::Camera::SortInput& input = m_sortInputs[i];
+        input.entity = m_spriteEntities[i];
+        input.depth = m_spriteData[i].transform[3][2];
+        input.height = m_spriteData[i].transform[3][1];
+        input.material = m_spriteInfo[i].materialIdentifier;
+        input.transparent = m_spriteInfo[i].transparent;
+    }
+
+    // Reuse the previous order if inputs have not changed.
+    if(m_sortInputs == layerSort.inputs)
+    {
+        Utility::Reorder(m_spriteInfo, layerSort.order);
+        Utility::Reorder(m_spriteData, layerSort.order);
+        return;
+    }
+
+    // Look up sprites by identifiers of their entities.
+    for(std::size_t i = 0; i < spriteCount; ++i)
+    {
+        std::size_t identifier = (std::size_t)m_spriteEntities[i].identifier;
+
+        if(identifier >= m_sortLookup.size())
+        {
+            m_sortLookup.resize(identifier + 1, InvalidSortIndex);
+        }
+
+        m_sortLookup[identifier] = i;
+    }
+
+    // Place sprites drawn in the previous frame in their previous order.
+    // Each camera keeps its own order, so sprites drawn by multiple cameras are not confused.
+    m_spriteSort.clear();
+
+    for(std::size_t previous : layerSort.order)
+    {
+        const EntityHandle& entity = layerSort.inputs[previous].entity;
+        std::size_t identifier = (std::size_t)entity.identifier;
+
+        if(identifier >= m_sortLookup.size())
+            continue;
+
+        std::size_t& index = m_sortLookup[identifier];
+
+        if(index != InvalidSortIndex && m_spriteEntities[index] == entity)
+        {
+            m_spriteSort.push_back(index);
+            index = InvalidSortIndex;
+        }
+    }
+
+    // Append sprites that were not drawn, while invalidating the lookup for the next sort.
+    for(std::size_t i = 0; i < spriteCount; ++i)
+    {
+        std::size_t& index = m_sortLookup[(std::size_t)m_spriteEntities[i].identifier];
+
+        if(index == i)
+        {
+            m_sortAdded.push_back(i);
+        }
+
+        index = InvalidSortIndex;
+    }
+
+    const std::size_t keptCount = m_spriteSort.size();
+    const std::size_t churnCount = (layerSort.order.size() - keptCount) + m_sortAdded.size();
+
+    m_spriteSort.insert(m_spriteSort.end(), m_sortAdded.begin(), m_sortAdded.end());
+    m_sortAdded.clear();
+
+    // Repair the order of kept sprites, which only changes a little between frames.
+    // Added sprites are sorted separately and merged in.
+    bool sorted = false;
+
+    if(churnCount * SortChurnDivisor <= spriteCount)
+    {
+        auto keptEnd = m_spriteSort.begin() + keptCount;
+
+        if(InsertionSort(m_spriteSort.begin(), keptEnd, SpriteSortIndex, keptCount * SortShiftsPerSprite))
+        {
+            std::sort(keptEnd, m_spriteSort.end(), SpriteSortIndex);
+            std::inplace_merge(m_spriteSort.begin(), keptEnd, m_spriteSort.end(), SpriteSortIndex);
+
+            sorted = true;
+        }
+    }
+
+    // Fall back to a full sort.
+    if(!sorted)
+    {
+        std::sort(m_spriteSort.begin(), m_spriteSort.end(), SpriteSortIndex);
+    }
+
+    // Remember inputs and their order for the next frame.
+    layerSort.inputs.swap(m_sortInputs);
+    layerSort.order.assign(m_spriteSort.begin(), m_spriteSort.end());
+
+    // Sort sprite lists.
+    Utility::Reorder(m_spriteInfo, m_spriteSort);
+    Utility::Reorder(m_spriteData, m_spriteSort);
+}
+
+void RenderSystem::RebuildStaticSprites(int layerIndex)
+{
+    Assert(m_spriteInfo.empty() && m_spriteData.empty());
+
+    Layer& layer = m_layers[layerIndex];
+
+    // Add static sprites of the layer to the render list.
+    const MaterialRegistry& materialRegistry = MaterialRegistry::GetGlobal();
+
+    auto componentsBegin = m_renderComponents->Begin();
+    auto componentsEnd = m_renderComponents->End();
+
+    layer.staticEntities.clear();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        Components::Render* render = &it->second;
+
+        if(!render->IsStatic() || render->GetLayer() != layerIndex)
+            continue;
+
+        render->m_staticLayer = (uint8_t)layerIndex;
+        render->m_staticVersion = render->GetTransform()->GetVersion();
+
+        layer.staticEntities.push_back(it->first);
+
+        Graphics::Sprite::Info info;
+        Graphics::Sprite::Data data;
+        CreateSprite(materialRegistry, render, info, data);
+
+        m_spriteInfo.push_back(info);
+        m_spriteData.push_back(data);
+    }
+
+    layer.staticCount = m_spriteInfo.size();
+
+    // Keep entities sorted for lookups on destruction.
+    std::sort(layer.staticEntities.begin(), layer.staticEntities.end());
+
+    // Sort static sprites with the same order as dynamic ones.
+    // Sprites that can be drawn in any order are grouped by spatial cells, so their batches can be culled.
+    std::vector<uint64_t> spriteCells;
+    spriteCells.reserve(m_spriteData.size());
+
+    for(const Graphics::Sprite::Data& data : m_spriteData)
+    {
+        spriteCells.push_back(CalculateSpriteCell(data));
+    }
+
+    auto SpriteSortIndex = [&](const int& a, const int& b)
+    {
+        return StaticSpriteSort(m_spriteInfo[a], m_spriteData[a], spriteCells[a], m_spriteInfo[b], m_spriteData[b], spriteCells[b]);
+    };
+
+    m_spriteSort.resize(m_spriteInfo.size());
+    std::iota(m_spriteSort.begin(), m_spriteSort.end(), 0);
+    std::sort(m_spriteSort.begin(), m_spriteSort.end(), SpriteSortIndex);
+
+    Utility::Reorder(m_spriteInfo, m_spriteSort);
+    Utility::Reorder(m_spriteData, m_spriteSort);
+
+    // Build a new static sprite buffer.
+    // Transparent batches are split into rows, so dynamic sprites can be drawn in between them.
+    // Batch bounds are limited, so batches do not span the whole level.
+    // Previous buffer is released once no recorded frame references it.
+    Graphics::StaticBatchInfo batchInfo;
+    batchInfo.maxExtent = StaticBatchExtent;
+    batchInfo.splitTransparentRows = true;
+
+    layer.staticSprites = std::make_shared<Graphics::StaticSpriteBuffer>();
+
+    if(!layer.staticSprites->Build(m_spriteInfo.data(), m_spriteData.data(), m_spriteInfo.size(), batchInfo))
+    {
+        Log() << "Could not build the static sprite buffer!";
+    }
+
+    // Clear the sprite list.
+    m_spriteInfo.clear();
+    m_spriteData.clear();
+}
+
+void RenderSystem::DrawTilemaps(Graphics::RenderCommandList& commandList, const glm::mat4& transform, const glm::vec4& cameraRectangle)
+{
+    auto componentsBegin = m_tilemapComponents->Begin();
+    auto componentsEnd = m_tilemapComponents->End();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        Components::Tilemap* tilemap = &it->second;
+
+        Components::Transform* transformComponent = tilemap->GetTransform();
+        Assert(transformComponent != nullptr);
+
+        if(tilemap->m_chunks.empty() || tilemap->GetTexture() == nullptr)
+            continue;
+
+        // Chunks are built in local tile space and placed in the world by the tilemap's transform.
+        glm::vec3 position = transformComponent->GetPosition();
+        glm::vec3 scale = transformComponent->GetScale() * RenderScale;
+
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+        model = glm::scale(model, scale);
+
+        // Calculate the world size of a chunk.
+        glm::vec2 tileSize = glm::vec2(tilemap->GetTileSize()) * glm::vec2(scale);
+        glm::vec2 chunkSize = tileSize * (float)Components::Tilemap::ChunkSize;
+
+        for(int chunkY = 0; chunkY < tilemap->m_chunksHeight; ++chunkY)
+        {
+            for(int chunkX = 0; chunkX < tilemap->m_chunksWidth; ++chunkX)
+            {
+                // Calculate chunk world bounds from the grid.
+                // Scale can be negative for mirrored tilemaps.
+                glm::vec2 chunkStart = glm::vec2(position) + glm::vec2(chunkX, chunkY) * chunkSize;
+                glm::vec2 boundsMin = glm::min(chunkStart, chunkStart + chunkSize);
+                glm::vec2 boundsMax = glm::max(chunkStart, chunkStart + chunkSize);
+
+                // Cull chunks outside of the camera view.
+                // Culled chunks are counted once all cameras have been drawn.
+                if(boundsMin.x > cameraRectangle.y || boundsMax.x < cameraRectangle.x ||
+                    boundsMin.y > cameraRectangle.w || boundsMax.y < cameraRectangle.z)
+                {
+                    continue;
+                }
+
+                // Count visible chunks once per frame.
+                Components::Tilemap::Chunk& chunk = tilemap->m_chunks[chunkY * tilemap->m_chunksWidth + chunkX];
+
+                if(chunk.visibleFrame != m_frameIndex)
+                {
+                    chunk.visibleFrame = m_frameIndex;
+                    m_frameStats.chunksVisible += 1;
+                }
+
+                // Rebuild modified chunks when they become visible.
+                // Chunks stay dirty while the tileset is pending, as its size is that of the placeholder until uploaded.
+
+                if(chunk.dirty && !tilemap->GetTexture()->IsPending())
+                {
+                    this->RebuildTilemapChunk(tilemap, chunkX, chunkY);
+                    chunk.dirty = false;
+
+                    m_frameStats.chunksRebuilt += 1;
+                }
+
+                // Draw all batches of the chunk.
+                if(chunk.sprites == nullptr)
+                    continue;
+
+                for(std::size_t i = 0; i < chunk.sprites->GetBatchCount(); ++i)
+                {
+                    m_staticVisible.push_back(i);
+                }
+
+                commandList.DrawStaticSprites(chunk.sprites, m_staticVisible.data(), m_staticVisible.size(), transform * model);
+                m_staticVisible.clear();
+            }
+        }
+    }
+}
+
+void RenderSystem::RebuildTilemapChunk(Components::Tilemap* tilemap, int chunkX, int chunkY)
+{
+    Assert(m_spriteInfo.empty() && m_spriteData.empty());
+
+    Components::Tilemap::Chunk& chunk = tilemap->m_chunks[chunkY * tilemap->m_chunksWidth + chunkX];
+
+    // Calculate the layout of tileset cells.
+    const Graphics::Texture* texture = tilemap->GetTexture().get();
+    glm::ivec2 tileSize = tilemap->GetTileSize();
+
+    int tilesetColumns = texture->GetWidth() / tileSize.x;
+    int tilesetRows = texture->GetHeight() / tileSize.y;
+
+    // Shared sprite info of all tiles.
+    // Material is kept by the tilemap, as it is referenced by batches of its chunks.
+    if(tilemap->m_material == nullptr)
+    {
+        tilemap->m_material = this->CreateMaterial(tilemap->GetTexture(), tilemap->IsTransparent());
+    }
+
+    Graphics::Sprite::Info info(tilemap->m_material.get());
+
+    // Add sprites of non empty tiles.
+    const int ChunkSize = Components::Tilemap::ChunkSize;
+
+    int tileBeginX = chunkX * ChunkSize;
+    int tileBeginY = chunkY * ChunkSize;
+    int tileEndX = std::min(tileBeginX + ChunkSize, tilemap->GetWidth());
+    int tileEndY = std::min(tileBeginY + ChunkSize, tilemap->GetHeight());
+
+    for(int y = tileBeginY; y < tileEndY; ++y)
+    {
+        for(int x = tileBeginX; x < tileEndX; ++x)
+        {
+            Components::Tilemap::TileIndex tile = tilemap->GetTile(x, y);
+
+            if(tile == Components::Tilemap::EmptyTile)
+                continue;
+
+            // Skip tiles outside of the tileset.
+            if(tilesetColumns == 0 || tile >= tilesetColumns * tilesetRows)
+                continue;
+
+            int column = tile % tilesetColumns;
+            int row = tile / tilesetColumns;
+
+            // Tile rectangle follows the sprite shader's convention,
+            // where the rectangle origin is the top left corner measured from the bottom of the texture.
+            Graphics::Sprite::Data data;
+            data.transform = glm::translate(glm::mat4(1.0f), glm::vec3(x * tileSize.x, y * tileSize.y, 0.0f));
+            data.rectangle = glm::vec4(column * tileSize.x, texture->GetHeight() - row * tileSize.y, tileSize.x, tileSize.y);
+
+            m_spriteInfo.push_back(info);
+            m_spriteData.push_back(data);
+        }
+    }
+
+    // Build a new sprite buffer for the chunk.
+    // Previous buffer is released once no recorded frame references it.
+    Graphics::StaticBatchInfo batchInfo;
+    batchInfo.maxSpriteCount = ChunkSize * ChunkSize;
+
+    chunk.sprites = std::make_shared<Graphics::StaticSpriteBuffer>();
+
+    if(!chunk.sprites->Build(m_spriteInfo.data(), m_spriteData.data(), m_spriteInfo.size(), batchInfo))
+    {
+        Log() << "Could not build a tilemap chunk!";
+    }
+
+    // Clear the sprite list.
+    m_spriteInfo.clear();
+    m_spriteData.clear();
+}
+
+void RenderSystem::DrawParticles(Graphics::RenderCommandList& commandList, const glm::mat4& transform, const glm::vec4& cameraRectangle)
+{
+    // Collect visible emitters.
+    // Bounds have been calculated by the particle system during its update.
+    auto componentsBegin = m_particlesComponents->Begin();
+    auto componentsEnd = m_particlesComponents->End();
+
+    for(auto it = componentsBegin; it != componentsEnd; ++it)
+    {
+        Components::Particles* particles = &it->second;
+
+        if(particles->GetParticleCount() == 0 || particles->GetTexture() == nullptr)
+            continue;
+
+        const glm::vec4& bounds = particles->m_bounds;
+
+        // Count visible particles once per frame.
+        // Culled particles are counted once all cameras have been drawn.
+        if(bounds.x <= cameraRectangle.y && bounds.y >= cameraRectangle.x &&
+            bounds.z <= cameraRectangle.w && bounds.w >= cameraRectangle.z)
+        {
+            m_particleEmitters.push_back(particles);
+
+            if(particles->m_visibleFrame != m_frameIndex)
+            {
+                particles->m_visibleFrame = m_frameIndex;
+                m_frameStats.particlesVisible += particles->GetParticleCount();
+            }
+        }
+    }
+
+    // Sort emitters back to front.
+    // Particles of a single emitter are drawn in their simulation order.
+    std::stable_sort(m_particleEmitters.begin(), m_particleEmitters.end(), [](const Components::Particles* a, const Components::Particles* b)
+    {
+        return a->m_depth < b->m_depth;
+    });
+
+    // Draw particle instances of each emitter.
+    // Instances are copied into the command list and uploaded when executed.
+    for(Components::Particles* particles : m_particleEmitters)
+    {
+        // Resolve the material after the texture has changed.
+        if(particles->m_material == nullptr)
+        {
+            particles->m_material = this->CreateMaterial(particles->GetTexture(), true);
+        }
+
+        Graphics::Sprite::Info info(particles->m_material.get());
+
+        commandList.DrawSpriteInstances(info, particles->m_instances.data(), particles->m_instances.size(), transform);
+    }
+
+    m_particleEmitters.clear();
+}
+
+void RenderSystem::DrawOverlay(Graphics::RenderCommandList& commandList, GLuint targetHandle, int targetWidth, int targetHeight)
+{
+    // Format stats of the frame.
+    // Renderer counters and timings are those of the last executed frame.
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    text << m_frameStats.spritesVisible << "/" << m_frameStats.spritesSubmitted << " sprites visible\n";
+    text << m_frameStats.renderer.batches << " batches, " << m_frameStats.renderer.drawCalls << " draw calls\n";
+    text << "resolution scale " << m_frameStats.resolutionScale << "\n";
+    text << "cpu extract " << m_frameStats.extractTime << " ms, sort " << m_frameStats.sortTime << " ms, submit " << m_frameStats.submitTime << " ms\n";
+    text << "render execute " << m_frameStats.executeTime << " ms, stall " << m_frameStats.stallTime << " ms";
+
+    if(m_frameStats.gpuTimesAvailable)
+    {
+        for(const auto& result : m_frameStats.gpuTimes)
+        {
+            text << "\ngpu " << result.name << " " << result.time << " ms";
+        }
+    }
+
+    // Draw the text in pixels at the native resolution.
+    // Depth is cleared, so the overlay is never hidden by the interface.
+    commandList.BeginPass("Overlay");
+    commandList.SetTarget(targetHandle, targetWidth, targetHeight);
+
+    Graphics::ClearValues depthClearValues;
+    depthClearValues.depth = 1.0f;
+
+    commandList.Clear(depthClearValues);
+
+    const float OverlayMargin = 8.0f;
+    glm::vec2 position(OverlayMargin, targetHeight - OverlayMargin);
+    glm::mat4 transform = glm::ortho(0.0f, (float)targetWidth, 0.0f, (float)targetHeight);
+
+    m_textRenderer.QueueText(m_overlayFont.get(), text.str(), position);
+    m_textRenderer.Flush(commandList, transform);
+
+    commandList.EndPass();
+}
+
+std::size_t RenderSystem::GetVisibleSpriteCount() const
+{
+    return m_frameStats.spritesVisible;
+}
+
+std::size_t RenderSystem::GetCulledSpriteCount() const
+{
+    return m_frameStats.spritesCulled;
+}
+
+const FrameStats& RenderSystem::GetFrameStats() const
+{
+    return m_frameStats;
+}
+
+Graphics::DebugDraw& RenderSystem::GetDebugDraw()
+{
+    return m_debugDraw;
+}
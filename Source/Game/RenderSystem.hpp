@@ -3,17 +3,49 @@
 #include "Precompiled.hpp"
 #include "EntityHandle.hpp"
 #include "ComponentPool.hpp"
+#include "RenderComponent.hpp"
+#include "CameraComponent.hpp"
 #include "Graphics/ScreenSpace.hpp"
-#include "Graphics/BasicRenderer.hpp"
+#include "Graphics/SpriteCuller.hpp"
+#include "Graphics/StaticSpriteBuffer.hpp"
+#include "Graphics/Framebuffer.hpp"
+#include "Graphics/ResolutionScaler.hpp"
+#include "Graphics/RenderThread.hpp"
+#include "Graphics/DebugDraw.hpp"
+#include "Graphics/TextRenderer.hpp"
 
 // Forward declarations.
 namespace System
 {
     class Window;
+    class ResourceManager;
+}
+
+namespace Graphics
+{
+    class Texture;
+    class Material;
+    class FrameCapture;
+    class Font;
 }
 
 /*
     Render System
+
+    Draws render components viewed by camera components. Sprites are
+    split into render layers, with each layer culled, sorted and drawn
+    separately by each camera that sees it. Static sprites are retained
+    per layer, so modifying one layer does not rebuild the others.
+    Sprites are drawn with materials created from their textures and
+    transparency, which are shared by all sprites with the same state.
+
+    With dynamic resolution enabled, the scene is drawn into an offscreen
+    framebuffer at a scale adjusted from measured frame times, and then
+    upscaled to the render target. Interface layer is drawn afterwards
+    at the native resolution, so text and widgets stay sharp.
+
+    When an overlay font is provided, stats of the last frame are drawn
+    as text on top of the render target after the frame is captured.
 */
 
 namespace Game
@@ -25,18 +57,95 @@ namespace Game
     namespace Components
     {
         class Transform;
-        class Render;
+        class Tilemap;
+        class Particles;
     }
 
+    // Global render scale.
+    // Converts sprite sizes in pixels to world units.
+    const glm::vec3 RenderScale(1.0f / 128.0f, 1.0f / 128.0f, 1.0f);
+
     // Render system info structure.
     struct RenderSystemInfo
     {
         RenderSystemInfo();
 
         System::Window* window;
-        Graphics::BasicRenderer* basicRenderer;
+        System::ResourceManager* resourceManager;
+        Graphics::RenderThread* renderThread;
         EntitySystem* entitySystem;
         ComponentSystem* componentSystem;
+
+        // Optional offscreen render target.
+        // Scene is drawn to the window's backbuffer if null.
+        Graphics::Framebuffer* framebuffer;
+
+        // Optional frame capture.
+        // Reads the render target after each frame is drawn.
+        Graphics::FrameCapture* frameCapture;
+
+        // Dynamic resolution parameters.
+        // Frame time is in milliseconds and the scale never goes below the minimum.
+        bool dynamicResolution;
+        float targetFrameTime;
+        float minResolutionScale;
+
+        // Optional font of the frame stats overlay.
+        // Overlay is not drawn if null.
+        std::shared_ptr<const Graphics::Font> overlayFont;
+    };
+
+    // Render frame stats structure.
+    struct FrameStats
+    {
+        FrameStats();
+
+        // Sprite counters.
+        std::size_t spritesSubmitted;
+        std::size_t spritesVisible;
+        std::size_t spritesCulled;
+        std::size_t spritesStatic;
+
+        // Tilemap chunk counters.
+        // Chunks and particles seen by several cameras are counted once.
+        std::size_t chunksVisible;
+        std::size_t chunksCulled;
+        std::size_t chunksRebuilt;
+
+        // Particle counters.
+        std::size_t particlesVisible;
+        std::size_t particlesCulled;
+
+        // Resolution scale of the scene.
+        float resolutionScale;
+
+        // Renderer counters.
+        // Counters are delayed by a frame when commands are executed on the render thread.
+        Graphics::BasicRendererStats renderer;
+        unsigned int stateCallsIssued;
+        unsigned int stateCallsSkipped;
+
+        // Render command queue counters.
+        std::size_t commandCount;
+        std::size_t commandBytes;
+        unsigned int queueDepth;
+
+        // CPU timings in milliseconds.
+        // Submit time measures recording of render commands.
+        float extractTime;
+        float sortTime;
+        float submitTime;
+
+        // Render thread timings in milliseconds.
+        float stallTime;
+        float executeTime;
+        float presentTime;
+
+        // GPU timings in milliseconds.
+        // Results are delayed by a few frames and measured per pass.
+        bool gpuTimesAvailable;
+        Graphics::GpuTimer::ResultList gpuTimes;
+        unsigned int gpuScopesDropped;
     };
 
     // Render system class.
@@ -49,38 +158,162 @@ namespace Game
         // Initializes the render system.
         bool Initialize(const RenderSystemInfo& info);
 
-        // Draws the scene.
+        // Records draw commands of the scene.
+        // Recorded frame is executed when submitted to the render thread.
         void Draw();
 
+        // Gets the number of sprites that were visible in the last frame.
+        std::size_t GetVisibleSpriteCount() const;
+
+        // Gets the number of sprites that were culled in the last frame.
+        std::size_t GetCulledSpriteCount() const;
+
+        // Gets the stats of the last frame.
+        const FrameStats& GetFrameStats() const;
+
+        // Gets the debug draw of the scene.
+        // Primitives are drawn in world space on top of the scene.
+        Graphics::DebugDraw& GetDebugDraw();
+
     private:
         // Type delcarations.
         typedef std::vector<Graphics::Sprite::Info> SpriteInfoList;
         typedef std::vector<Graphics::Sprite::Data> SpriteDataList;
         typedef std::vector<std::size_t>            SpriteSortList;
+        typedef std::vector<Components::Render*>    RenderComponentList;
+        typedef std::vector<EntityHandle>           EntityList;
+        typedef std::vector<Components::Camera*>    CameraComponentList;
+        typedef std::vector<Components::Particles*> ParticlesComponentList;
+        typedef std::shared_ptr<Graphics::StaticSpriteBuffer> StaticSpriteBufferPtr;
+        typedef std::shared_ptr<const Graphics::Texture> TexturePtr;
+        typedef std::shared_ptr<const Graphics::Material> MaterialPtr;
+
+        // Render layer structure.
+        struct Layer
+        {
+            Layer();
+
+            // Dynamic sprites extracted in the current frame.
+            Graphics::SpriteCuller culler;
+            RenderComponentList components;
+            EntityList entities;
+
+            // Retained static sprites.
+            // Buffer is replaced on rebuild, as the previous one can still be used by the render thread.
+            StaticSpriteBufferPtr staticSprites;
+            EntityList staticEntities;
+            std::size_t staticCount;
+            std::size_t staticExtracted;
+            bool staticDirty;
+        };
 
     private:
         // Finalizes a render component.
         bool FinalizeComponent(EntityHandle entity);
 
+        // Marks static sprites of a destroyed entity for a rebuild.
+        void OnEntityDestroy(EntityHandle entity);
+
+        // Creates a sprite material for a texture.
+        // Materials are shared by all sprites with the same texture and transparency.
+        MaterialPtr CreateMaterial(const TexturePtr& texture, bool transparent);
+
+        // Creates the scene framebuffer if the render target size has changed.
+        bool UpdateSceneFramebuffer(int width, int height);
+
+        // Extracts sprites of render components into their layers.
+        void ExtractSprites();
+
+        // Rebuilds the buffer of static sprites of a layer.
+        void RebuildStaticSprites(int layerIndex);
+
+        // Draws layers in a mask with each camera.
+        void DrawCameras(Graphics::RenderCommandList& commandList, int targetWidth, int targetHeight, uint32_t layerMask);
+
+        // Draws a layer viewed by a camera.
+        void DrawLayer(Graphics::RenderCommandList& commandList, Components::Camera* camera, int layerIndex, const glm::mat4& transform, const glm::vec4& cameraRectangle);
+
+        // Sorts extracted sprites, starting from their order in the previous frame.
+        void SortSprites(Components::Camera::LayerSort& layerSort);
+
+        // Draws visible chunks of all tilemaps.
+        void DrawTilemaps(Graphics::RenderCommandList& commandList, const glm::mat4& transform, const glm::vec4& cameraRectangle);
+
+        // Rebuilds the sprite buffer of a tilemap chunk.
+        void RebuildTilemapChunk(Components::Tilemap* tilemap, int chunkX, int chunkY);
+
+        // Draws visible particle emitters.
+        void DrawParticles(Graphics::RenderCommandList& commandList, const glm::mat4& transform, const glm::vec4& cameraRectangle);
+
+        // Draws the frame stats overlay on top of the render target.
+        void DrawOverlay(Graphics::RenderCommandList& commandList, GLuint targetHandle, int targetWidth, int targetHeight);
+
     private:
         // Event receivers.
         Receiver<bool(EntityHandle)> m_entityFinalize;
+        Receiver<void(EntityHandle)> m_entityDestroy;
 
         // Instance references.
         System::Window*          m_window;
-        Graphics::BasicRenderer* m_basicRenderer;
+        System::ResourceManager* m_resourceManager;
+        Graphics::RenderThread*  m_renderThread;
+        Graphics::Framebuffer*   m_framebuffer;
+        Graphics::FrameCapture*  m_frameCapture;
+
+        // Dynamic resolution.
+        // Scene framebuffer has the size of the render target, with the scaled scene drawn in its corner.
+        std::unique_ptr<Graphics::Framebuffer> m_sceneFramebuffer;
+        Graphics::ResolutionScaler m_resolutionScaler;
 
         // Component pools.
         ComponentPool<Components::Transform>* m_transformComponents;
         ComponentPool<Components::Render>*    m_renderComponents;
+        ComponentPool<Components::Camera>*    m_cameraComponents;
+        ComponentPool<Components::Tilemap>*   m_tilemapComponents;
+        ComponentPool<Components::Particles>* m_particlesComponents;
+
+        // Render layers.
+        Layer m_layers[RenderLayerCount];
+
+        // Cameras in their draw order.
+        // Default camera is used when there are no camera components.
+        CameraComponentList m_cameras;
+        Components::Camera m_defaultCamera;
+
+        // Sprite culling list.
+        SpriteSortList m_cullVisible;
 
-        // Screen space transform.
-        Graphics::ScreenSpace m_screenSpace;
+        // Frame stats.
+        // Frame index tells apart objects already counted as visible by another camera.
+        FrameStats m_frameStats;
+        uint32_t m_frameIndex;
+
+        // Static batch drawing list.
+        SpriteSortList m_staticVisible;
 
         // Sprite drawing lists.
         SpriteInfoList m_spriteInfo;
         SpriteDataList m_spriteData;
         SpriteSortList m_spriteSort;
+        EntityList m_spriteEntities;
+
+        // Sprite order restoring lists.
+        // Lookup maps entity identifiers to indices of sprites being sorted and is kept invalid between sorts.
+        SpriteSortList m_sortLookup;
+        SpriteSortList m_sortAdded;
+
+        // Sort inputs of the current layer.
+        std::vector<Components::Camera::SortInput> m_sortInputs;
+
+        // Particle drawing list.
+        ParticlesComponentList m_particleEmitters;
+
+        // Debug primitives.
+        Graphics::DebugDraw m_debugDraw;
+
+        // Frame stats overlay.
+        Graphics::TextRenderer m_textRenderer;
+        std::shared_ptr<const Graphics::Font> m_overlayFont;
 
         // Initialization state.
         bool m_initialized;
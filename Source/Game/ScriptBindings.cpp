@@ -19,7 +19,9 @@ namespace
 
 ScriptBindings::References::References() :
     inputState(nullptr),
-    componentSystem(nullptr)
+    componentSystem(nullptr),
+    renderSystem(nullptr),
+    debugDraw(nullptr)
 {
 }
 
@@ -48,6 +50,8 @@ bool ScriptBindings::Register(Scripting::State* state, const References& referen
     results &= ScriptBindings::EntityHandle::Register(*state);
     results &= ScriptBindings::TransformComponent::Register(*state);
     results &= ScriptBindings::ComponentSystem::Register(*state, references.componentSystem);
+    results &= ScriptBindings::RenderSystem::Register(*state, references.renderSystem);
+    results &= ScriptBindings::DebugDraw::Register(*state, references.debugDraw);
 
     return results;
 }
@@ -13,9 +13,15 @@ namespace System
     class InputState;
 }
 
+namespace Graphics
+{
+    class DebugDraw;
+}
+
 namespace Game
 {
     class ComponentSystem;
+    class RenderSystem;
 }
 
 /*
@@ -33,6 +39,8 @@ namespace Game
 
             System::InputState* inputState;
             Game::ComponentSystem* componentSystem;
+            Game::RenderSystem* renderSystem;
+            Graphics::DebugDraw* debugDraw;
         };
 
         // Registers all script bindings.
@@ -3,8 +3,24 @@
 #include "Scripting/State.hpp"
 #include "Scripting/Helpers.hpp"
 #include "System/InputState.hpp"
+#include "Game/RenderSystem.hpp"
+#include "Graphics/DebugDraw.hpp"
 using namespace Game;
 
+namespace
+{
+    // Gets an optional color passed as four numbers starting at an index.
+    glm::vec4 OptionalColor(Scripting::State& state, int index)
+    {
+        glm::vec4 color;
+        color.r = Scripting::Optional<float>(state, index + 0, 1.0f);
+        color.g = Scripting::Optional<float>(state, index + 1, 1.0f);
+        color.b = Scripting::Optional<float>(state, index + 2, 1.0f);
+        color.a = Scripting::Optional<float>(state, index + 3, 1.0f);
+        return color;
+    }
+}
+
 /*
     Input State Bindings
 */
@@ -81,3 +97,241 @@ int ScriptBindings::InputState::IsKeyboardKeyUp(lua_State* state)
 
     return 1;
 }
+
+/*
+    Render System Bindings
+*/
+
+bool ScriptBindings::RenderSystem::Register(Scripting::State& state, Game::RenderSystem* reference)
+{
+    Assert(state.IsValid(), "Invalid scripting state!");
+
+    // Create a stack cleanup guard.
+    Scripting::StackGuard guard(state);
+
+    // Create a type metatable.
+    luaL_newmetatable(state, typeid(Game::RenderSystem).name());
+
+    lua_pushliteral(state, "__index");
+    lua_pushvalue(state, -2);
+    lua_rawset(state, -3);
+
+    lua_pushcfunction(state, ScriptBindings::RenderSystem::GetFrameStats);
+    lua_setfield(state, -2, "GetFrameStats");
+
+    // Push a reference to the render system.
+    Scripting::Push<Game::RenderSystem*>(state, reference);
+
+    // Register as a global variable.
+    Scripting::SetGlobalField(state, "System.RenderSystem", Scripting::StackValue(-1), true);
+
+    return true;
+}
+
+int ScriptBindings::RenderSystem::GetFrameStats(lua_State* state)
+{
+    Assert(state != nullptr, "Scripting state is nullptr!");
+
+    // Create a scripting state proxy.
+    Scripting::State stateProxy(state);
+
+    // Push a render system reference as the first argument.
+    Scripting::GetGlobalField(stateProxy, "System.RenderSystem", false);
+    Scripting::Insert(stateProxy, 1);
+
+    // Get arguments from the stack.
+    Game::RenderSystem* renderSystem = *Scripting::Check<Game::RenderSystem*>(stateProxy, 1);
+
+    // Push a table with frame stats.
+    const Game::FrameStats& stats = renderSystem->GetFrameStats();
+
+    lua_createtable(stateProxy, 0, 16);
+
+    auto SetField = [&stateProxy](const char* name, double value)
+    {
+        lua_pushnumber(stateProxy, value);
+        lua_setfield(stateProxy, -2, name);
+    };
+
+    SetField("spritesSubmitted", (double)stats.spritesSubmitted);
+    SetField("spritesVisible", (double)stats.spritesVisible);
+    SetField("spritesCulled", (double)stats.spritesCulled);
+    SetField("spritesStatic", (double)stats.spritesStatic);
+    SetField("chunksVisible", (double)stats.chunksVisible);
+    SetField("chunksCulled", (double)stats.chunksCulled);
+    SetField("chunksRebuilt", (double)stats.chunksRebuilt);
+    SetField("particlesVisible", (double)stats.particlesVisible);
+    SetField("particlesCulled", (double)stats.particlesCulled);
+    SetField("batches", (double)stats.renderer.batches);
+    SetField("drawCalls", (double)stats.renderer.drawCalls);
+    SetField("programSwitches", (double)stats.renderer.programSwitches);
+    SetField("textureSwitches", (double)stats.renderer.textureSwitches);
+    SetField("blendSwitches", (double)stats.renderer.blendSwitches);
+    SetField("instanceBytes", (double)stats.renderer.instanceBytes);
+    SetField("stateCallsIssued", (double)stats.stateCallsIssued);
+    SetField("stateCallsSkipped", (double)stats.stateCallsSkipped);
+    SetField("extractTime", stats.extractTime);
+    SetField("sortTime", stats.sortTime);
+    SetField("submitTime", stats.submitTime);
+    SetField("commandCount", (double)stats.commandCount);
+    SetField("commandBytes", (double)stats.commandBytes);
+    SetField("queueDepth", (double)stats.queueDepth);
+    SetField("stallTime", stats.stallTime);
+    SetField("executeTime", stats.executeTime);
+    SetField("presentTime", stats.presentTime);
+    SetField("gpuScopesDropped", (double)stats.gpuScopesDropped);
+
+    // Push GPU timings by scope name.
+    if(stats.gpuTimesAvailable)
+    {
+        lua_createtable(stateProxy, 0, stats.gpuTimes.size());
+
+        for(const auto& result : stats.gpuTimes)
+        {
+            SetField(result.name, result.time);
+        }
+    }
+    else
+    {
+        lua_pushliteral(stateProxy, "unavailable");
+    }
+
+    lua_setfield(stateProxy, -2, "gpuTimes");
+
+    return 1;
+}
+
+/*
+    Debug Draw Bindings
+*/
+
+bool ScriptBindings::DebugDraw::Register(Scripting::State& state, Graphics::DebugDraw* reference)
+{
+    Assert(state.IsValid(), "Invalid scripting state!");
+
+    // Create a stack cleanup guard.
+    Scripting::StackGuard guard(state);
+
+    // Create a type metatable.
+    luaL_newmetatable(state, typeid(Graphics::DebugDraw).name());
+
+    lua_pushliteral(state, "__index");
+    lua_pushvalue(state, -2);
+    lua_rawset(state, -3);
+
+    lua_pushcfunction(state, ScriptBindings::DebugDraw::Line);
+    lua_setfield(state, -2, "Line");
+
+    lua_pushcfunction(state, ScriptBindings::DebugDraw::Rect);
+    lua_setfield(state, -2, "Rect");
+
+    lua_pushcfunction(state, ScriptBindings::DebugDraw::Circle);
+    lua_setfield(state, -2, "Circle");
+
+    lua_pushcfunction(state, ScriptBindings::DebugDraw::Arrow);
+    lua_setfield(state, -2, "Arrow");
+
+    // Push a reference to the debug draw.
+    Scripting::Push<Graphics::DebugDraw*>(state, reference);
+
+    // Register as a global variable.
+    Scripting::SetGlobalField(state, "System.DebugDraw", Scripting::StackValue(-1), true);
+
+    return true;
+}
+
+int ScriptBindings::DebugDraw::Line(lua_State* state)
+{
+    Assert(state != nullptr, "Scripting state is nullptr!");
+
+    // Create a scripting state proxy.
+    Scripting::State stateProxy(state);
+
+    // Push a debug draw reference as the first argument.
+    Scripting::GetGlobalField(stateProxy, "System.DebugDraw", false);
+    Scripting::Insert(stateProxy, 1);
+
+    // Get arguments from the stack.
+    // Color is passed as optional red, green, blue and alpha components.
+    Graphics::DebugDraw* debugDraw = *Scripting::Check<Graphics::DebugDraw*>(stateProxy, 1);
+    glm::vec2* begin = Scripting::Check<glm::vec2>(stateProxy, 2);
+    glm::vec2* end = Scripting::Check<glm::vec2>(stateProxy, 3);
+    glm::vec4 color = OptionalColor(stateProxy, 4);
+
+    // Call the method.
+    debugDraw->Line(*begin, *end, color);
+
+    return 0;
+}
+
+int ScriptBindings::DebugDraw::Rect(lua_State* state)
+{
+    Assert(state != nullptr, "Scripting state is nullptr!");
+
+    // Create a scripting state proxy.
+    Scripting::State stateProxy(state);
+
+    // Push a debug draw reference as the first argument.
+    Scripting::GetGlobalField(stateProxy, "System.DebugDraw", false);
+    Scripting::Insert(stateProxy, 1);
+
+    // Get arguments from the stack.
+    // Color is passed as optional red, green, blue and alpha components.
+    Graphics::DebugDraw* debugDraw = *Scripting::Check<Graphics::DebugDraw*>(stateProxy, 1);
+    glm::vec2* min = Scripting::Check<glm::vec2>(stateProxy, 2);
+    glm::vec2* max = Scripting::Check<glm::vec2>(stateProxy, 3);
+    glm::vec4 color = OptionalColor(stateProxy, 4);
+
+    // Call the method.
+    debugDraw->Rect(*min, *max, color);
+
+    return 0;
+}
+
+int ScriptBindings::DebugDraw::Circle(lua_State* state)
+{
+    Assert(state != nullptr, "Scripting state is nullptr!");
+
+    // Create a scripting state proxy.
+    Scripting::State stateProxy(state);
+
+    // Push a debug draw reference as the first argument.
+    Scripting::GetGlobalField(stateProxy, "System.DebugDraw", false);
+    Scripting::Insert(stateProxy, 1);
+
+    // Get arguments from the stack.
+    // Color is passed as optional red, green, blue and alpha components.
+    Graphics::DebugDraw* debugDraw = *Scripting::Check<Graphics::DebugDraw*>(stateProxy, 1);
+    glm::vec2* center = Scripting::Check<glm::vec2>(stateProxy, 2);
+    float radius = Scripting::Check<float>(stateProxy, 3);
+    glm::vec4 color = OptionalColor(stateProxy, 4);
+
+    // Call the method.
+    debugDraw->Circle(*center, radius, color);
+
+    return 0;
+}
+
+int ScriptBindings::DebugDraw::Arrow(lua_State* state)
+{
+    Assert(state != nullptr, "Scripting state is nullptr!");
+
+    // Create a scripting state proxy.
+    Scripting::State stateProxy(state);
+
+    // Push a debug draw reference as the first argument.
+    Scripting::GetGlobalField(stateProxy, "System.DebugDraw", false);
+    Scripting::Insert(stateProxy, 1);
+
+    // Get arguments from the stack.
+    // Color is passed as optional red, green, blue and alpha components.
+    Graphics::DebugDraw* debugDraw = *Scripting::Check<Graphics::DebugDraw*>(stateProxy, 1);
+    glm::vec2* begin = Scripting::Check<glm::vec2>(stateProxy, 2);
+    glm::vec2* end = Scripting::Check<glm::vec2>(stateProxy, 3);
+    glm::vec4 color = OptionalColor(stateProxy, 4);
+
+    // Call the method.
+    debugDraw->Arrow(*begin, *end, color);
+
+    return 0;
+}
@@ -13,6 +13,16 @@ namespace Scripting
     class State;
 }
 
+namespace Graphics
+{
+    class DebugDraw;
+}
+
+namespace Game
+{
+    class RenderSystem;
+}
+
 /*
     Input State Bindings
 */
@@ -32,3 +42,44 @@ namespace Game
         }
     }
 }
+
+/*
+    Render System Bindings
+*/
+
+namespace Game
+{
+    namespace ScriptBindings
+    {
+        namespace RenderSystem
+        {
+            // Registers bindings.
+            bool Register(Scripting::State& state, Game::RenderSystem* reference);
+
+            // Metatable methods.
+            int GetFrameStats(lua_State* state);
+        }
+    }
+}
+
+/*
+    Debug Draw Bindings
+*/
+
+namespace Game
+{
+    namespace ScriptBindings
+    {
+        namespace DebugDraw
+        {
+            // Registers bindings.
+            bool Register(Scripting::State& state, Graphics::DebugDraw* reference);
+
+            // Metatable methods.
+            int Line(lua_State* state);
+            int Rect(lua_State* state);
+            int Circle(lua_State* state);
+            int Arrow(lua_State* state);
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include "ScriptComponent.hpp"
 #include "EntitySystem.hpp"
 #include "ComponentSystem.hpp"
+#include "AnimationSystem.hpp"
 #include "Scripting/Helpers.hpp"
 using namespace Game;
 
@@ -15,7 +16,8 @@ namespace
 ScriptSystemInfo::ScriptSystemInfo() :
     scriptingState(nullptr),
     entitySystem(nullptr),
-    componentSystem(nullptr)
+    componentSystem(nullptr),
+    animationSystem(nullptr)
 {
 }
 
@@ -26,6 +28,7 @@ ScriptSystem::ScriptSystem() :
 {
     // Bind event receivers.
     m_entityFinalize.Bind<ScriptSystem, &ScriptSystem::FinalizeComponent>(this);
+    m_animationFinished.Bind<ScriptSystem, &ScriptSystem::AnimationFinished>(this);
 }
 
 ScriptSystem::~ScriptSystem()
@@ -66,6 +69,12 @@ bool ScriptSystem::Initialize(const ScriptSystemInfo& info)
         return false;
     }
 
+    if(info.animationSystem == nullptr)
+    {
+        Log() << LogInitializeError() << "Invalid argument - \"info.animationSystem\" is null.";
+        return false;
+    }
+
     // Save reference to the scripting state.
     m_scriptingState = info.scriptingState;
 
@@ -95,6 +104,15 @@ bool ScriptSystem::Initialize(const ScriptSystemInfo& info)
 
     SCOPE_GUARD_IF(!m_initialized, m_entityFinalize.Unsubscribe());
 
+    // Subscribe to the animation system.
+    if(!m_animationFinished.Subscribe(info.animationSystem->eventDispatchers.animationFinished))
+    {
+        Log() << LogInitializeError() << "Could not subscribe to the animation system.";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_animationFinished.Unsubscribe());
+
     // Success!
     return m_initialized = true;
 }
@@ -128,6 +146,29 @@ bool ScriptSystem::FinalizeComponent(EntityHandle entity)
     return true;
 }
 
+void ScriptSystem::AnimationFinished(EntityHandle entity)
+{
+    Assert(m_initialized);
+
+    auto scriptComponent = m_scriptComponents->Lookup(entity);
+
+    if(scriptComponent == nullptr)
+        return;
+
+    // Call the event method on scripts that define it.
+    for(auto& script : scriptComponent->m_scripts)
+    {
+        // Setups a stack guard
+        Scripting::StackGuard guard(m_scriptingState);
+
+        // Push a script instance on the stack.
+        Scripting::Push(*m_scriptingState, script);
+
+        // Call the script event method.
+        Scripting::Call(*m_scriptingState, "OnAnimationFinished", Scripting::StackValue(-1), entity);
+    }
+}
+
 void ScriptSystem::Update(float timeDelta)
 {
     if(!m_initialized)
@@ -14,6 +14,7 @@ namespace Game
     // Forward declarations.
     class EntitySystem;
     class ComponentSystem;
+    class AnimationSystem;
 
     namespace Components
     {
@@ -28,6 +29,7 @@ namespace Game
         Scripting::State* scriptingState;
         EntitySystem* entitySystem;
         ComponentSystem* componentSystem;
+        AnimationSystem* animationSystem;
     };
 
     // Script system class.
@@ -50,6 +52,9 @@ namespace Game
         // Finalizes a script component.
         bool FinalizeComponent(EntityHandle entity);
 
+        // Notifies scripts of an entity that its animation has finished.
+        void AnimationFinished(EntityHandle entity);
+
     private:
         // Scripting state.
         Scripting::State* m_scriptingState;
@@ -59,6 +64,7 @@ namespace Game
 
         // Event receivers.
         Receiver<bool(EntityHandle)> m_entityFinalize;
+        Receiver<void(EntityHandle)> m_animationFinished;
 
         // Initialization state.
         bool m_initialized;
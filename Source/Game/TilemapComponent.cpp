@@ -0,0 +1,130 @@
+#include "Precompiled.hpp"
+#include "TilemapComponent.hpp"
+#include "TransformComponent.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/Material.hpp"
+using namespace Game::Components;
+
+Tilemap::Chunk::Chunk() :
+    dirty(false),
+    visibleFrame(0)
+{
+}
+
+Tilemap::Tilemap() :
+    m_tileSize(0, 0),
+    m_width(0),
+    m_height(0),
+    m_chunksWidth(0),
+    m_chunksHeight(0),
+    m_transparent(false),
+    m_transform(nullptr)
+{
+}
+
+Tilemap::~Tilemap()
+{
+}
+
+void Tilemap::MarkChunksDirty()
+{
+    for(Chunk& chunk : m_chunks)
+    {
+        chunk.dirty = true;
+    }
+}
+
+void Tilemap::SetTileset(TexturePtr texture, const glm::ivec2& tileSize)
+{
+    Verify(tileSize.x > 0 && tileSize.y > 0, "Invalid argument - \"tileSize\" is invalid!");
+
+    m_texture = texture;
+    m_tileSize = tileSize;
+    m_material = nullptr;
+
+    this->MarkChunksDirty();
+}
+
+void Tilemap::Resize(int width, int height)
+{
+    Verify(width >= 0 && height >= 0, "Invalid argument - grid size cannot be negative!");
+
+    // Allocate empty tiles.
+    m_tiles.assign(width * height, EmptyTile);
+    m_width = width;
+    m_height = height;
+
+    // Allocate chunks covering the grid.
+    m_chunksWidth = (width + ChunkSize - 1) / ChunkSize;
+    m_chunksHeight = (height + ChunkSize - 1) / ChunkSize;
+
+    ChunkList chunks(m_chunksWidth * m_chunksHeight);
+    m_chunks.swap(chunks);
+
+    this->MarkChunksDirty();
+}
+
+void Tilemap::SetTile(int x, int y, TileIndex tile)
+{
+    Verify(0 <= x && x < m_width, "Tile x coordinate is out of range!");
+    Verify(0 <= y && y < m_height, "Tile y coordinate is out of range!");
+
+    TileIndex& current = m_tiles[y * m_width + x];
+
+    // Rebuild the chunk only if the tile changes.
+    if(current != tile)
+    {
+        current = tile;
+
+        m_chunks[(y / ChunkSize) * m_chunksWidth + (x / ChunkSize)].dirty = true;
+    }
+}
+
+void Tilemap::SetTransparent(bool transparent)
+{
+    if(m_transparent != transparent)
+    {
+        m_transparent = transparent;
+        m_material = nullptr;
+
+        this->MarkChunksDirty();
+    }
+}
+
+Tilemap::TileIndex Tilemap::GetTile(int x, int y) const
+{
+    Verify(0 <= x && x < m_width, "Tile x coordinate is out of range!");
+    Verify(0 <= y && y < m_height, "Tile y coordinate is out of range!");
+
+    return m_tiles[y * m_width + x];
+}
+
+const Tilemap::TexturePtr& Tilemap::GetTexture() const
+{
+    return m_texture;
+}
+
+const glm::ivec2& Tilemap::GetTileSize() const
+{
+    return m_tileSize;
+}
+
+int Tilemap::GetWidth() const
+{
+    return m_width;
+}
+
+int Tilemap::GetHeight() const
+{
+    return m_height;
+}
+
+bool Tilemap::IsTransparent() const
+{
+    return m_transparent;
+}
+
+Transform* Tilemap::GetTransform()
+{
+    return m_transform;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Component.hpp"
+#include "Graphics/StaticSpriteBuffer.hpp"
+
+// Forward declarations.
+namespace Graphics
+{
+    class Texture;
+    class Material;
+}
+
+namespace Game
+{
+    class RenderSystem;
+}
+
+/*
+    Tilemap Component
+
+    Stores a grid of tile indices referencing cells of a tileset texture.
+    The grid is split into square chunks, each retained in its own static
+    sprite buffer that is rebuilt only after one of its tiles changes.
+    Tile (0, 0) is placed at the entity's position, with columns going
+    right and rows going up. Tiles are numbered from the top left cell of
+    the tileset, row by row.
+
+    void ExampleTilemapComponent(Components::Tilemap* tilemap)
+    {
+        // Set a tileset with 32x32 pixel cells.
+        tilemap->SetTileset(tilesetTexture, glm::ivec2(32, 32));
+
+        // Allocate a grid of empty tiles.
+        tilemap->Resize(512, 512);
+
+        // Fill the first row with the first tileset cell.
+        for(int x = 0; x < tilemap->GetWidth(); ++x)
+        {
+            tilemap->SetTile(x, 0, 0);
+        }
+    }
+*/
+
+namespace Game
+{
+    namespace Components
+    {
+        // Forward declarations.
+        class Transform;
+
+        // Tilemap component class.
+        class Tilemap : public Component
+        {
+        public:
+            // Type declarations.
+            typedef std::shared_ptr<const Graphics::Texture> TexturePtr;
+            typedef std::shared_ptr<const Graphics::Material> MaterialPtr;
+            typedef uint16_t TileIndex;
+
+            // Friend declarations.
+            friend RenderSystem;
+
+            // Index of an empty tile.
+            static const TileIndex EmptyTile = std::numeric_limits<TileIndex>::max();
+
+            // Size of a chunk in tiles along each axis.
+            static const int ChunkSize = 32;
+
+        public:
+            Tilemap();
+            ~Tilemap();
+
+            // Sets the tileset texture and the size of its cells in pixels.
+            void SetTileset(TexturePtr texture, const glm::ivec2& tileSize);
+
+            // Resizes the grid.
+            // All tiles are reset to empty.
+            void Resize(int width, int height);
+
+            // Sets a tile.
+            void SetTile(int x, int y, TileIndex tile);
+
+            // Sets transparency state.
+            void SetTransparent(bool transparent);
+
+            // Gets a tile.
+            TileIndex GetTile(int x, int y) const;
+
+            // Gets the tileset texture.
+            const TexturePtr& GetTexture() const;
+
+            // Gets the size of tileset cells.
+            const glm::ivec2& GetTileSize() const;
+
+            // Gets the grid width.
+            int GetWidth() const;
+
+            // Gets the grid height.
+            int GetHeight() const;
+
+            // Checks if is transparent.
+            bool IsTransparent() const;
+
+            // Gets the transform component.
+            Transform* GetTransform();
+
+        private:
+            // Chunk structure.
+            struct Chunk
+            {
+                Chunk();
+
+                // Retained tile sprites.
+                // Buffer is replaced on rebuild, as the previous one can still be used by the render thread.
+                std::shared_ptr<Graphics::StaticSpriteBuffer> sprites;
+
+                // Rebuild state.
+                bool dirty;
+
+                // Frame in which the chunk was last counted as visible.
+                uint32_t visibleFrame;
+            };
+
+            // Type declarations.
+            typedef std::vector<TileIndex> TileList;
+            typedef std::vector<Chunk> ChunkList;
+
+        private:
+            // Marks all chunks for a rebuild.
+            void MarkChunksDirty();
+
+        private:
+            // Tileset resource.
+            TexturePtr m_texture;
+            glm::ivec2 m_tileSize;
+
+            // Tile grid.
+            TileList m_tiles;
+            int m_width;
+            int m_height;
+
+            // Tile chunks.
+            ChunkList m_chunks;
+            int m_chunksWidth;
+            int m_chunksHeight;
+
+            // Render parameters.
+            // Material is resolved by the render system when chunks are rebuilt.
+            bool m_transparent;
+            MaterialPtr m_material;
+
+            // Entity components.
+            Transform* m_transform;
+        };
+    }
+}
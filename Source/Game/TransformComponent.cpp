@@ -5,7 +5,8 @@ using namespace Game::Components;
 Transform::Transform() :
     m_position(0.0f, 0.0f, 0.0f),
     m_rotation(0.0f, 0.0f, 0.0f),
-    m_scale(1.0f, 1.0f, 1.0f)
+    m_scale(1.0f, 1.0f, 1.0f),
+    m_version(0)
 {
 }
 
@@ -16,6 +17,7 @@ Transform::~Transform()
 void Transform::SetPosition(const glm::vec3& position)
 {
     m_position = position;
+    m_version += 1;
 }
 
 void Transform::SetPosition(float x, float y, float z)
@@ -23,11 +25,13 @@ void Transform::SetPosition(float x, float y, float z)
     m_position.x = x;
     m_position.y = y;
     m_position.z = z;
+    m_version += 1;
 }
 
 void Transform::SetRotation(const glm::vec3& rotation)
 {
     m_rotation = rotation;
+    m_version += 1;
 }
 
 void Transform::SetRotation(float x, float y, float z)
@@ -35,11 +39,13 @@ void Transform::SetRotation(float x, float y, float z)
     m_rotation.x = x;
     m_rotation.y = y;
     m_rotation.z = z;
+    m_version += 1;
 }
 
 void Transform::SetScale(const glm::vec3& scale)
 {
     m_scale = scale;
+    m_version += 1;
 }
 
 void Transform::SetScale(float x, float y, float z)
@@ -47,6 +53,7 @@ void Transform::SetScale(float x, float y, float z)
     m_scale.x = x;
     m_scale.y = y;
     m_scale.z = z;
+    m_version += 1;
 }
 
 const glm::vec3& Transform::GetPosition() const
@@ -63,3 +70,8 @@ const glm::vec3& Transform::GetScale() const
 {
     return m_scale;
 }
+
+uint32_t Transform::GetVersion() const
+{
+    return m_version;
+}
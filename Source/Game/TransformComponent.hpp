@@ -39,11 +39,18 @@ namespace Game
             // Gets the scale.
             const glm::vec3& GetScale() const;
 
+            // Gets the version.
+            // Version changes each time the transform is modified.
+            uint32_t GetVersion() const;
+
         private:
             // Transform data.
             glm::vec3 m_position;
             glm::vec3 m_rotation;
             glm::vec3 m_scale;
+
+            // Modification counter.
+            uint32_t m_version;
         };
     }
 }
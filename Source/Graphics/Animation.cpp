@@ -0,0 +1,138 @@
+#include "Precompiled.hpp"
+#include "Animation.hpp"
+using namespace Graphics;
+
+Animation::Frame::Frame() :
+    rectangle(0.0f, 0.0f, 0.0f, 0.0f),
+    endTime(0.0f)
+{
+}
+
+Animation::Animation() :
+    m_looped(false)
+{
+}
+
+Animation::~Animation()
+{
+}
+
+bool Animation::Load(std::string filepath)
+{
+    Log() << "Loading animation from \"" << filepath << "\" file..." << LogIndent();
+
+    // Check if animation has been already loaded.
+    Verify(!this->IsValid(), "Animation instance has been already initialized!");
+
+    // Validate arguments.
+    if(filepath.empty())
+    {
+        LogError() << "Invalid argument - \"filepath\" is empty!";
+        return false;
+    }
+
+    // Open the file.
+    std::ifstream file(Build::GetWorkingDir() + filepath);
+
+    if(!file.is_open())
+    {
+        LogError() << "Could not open the file!";
+        return false;
+    }
+
+    // Parse animation lines.
+    FrameList frames;
+    bool looped = false;
+    float endTime = 0.0f;
+
+    std::string line;
+    int lineNumber = 0;
+
+    while(std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::istringstream stream(line);
+        std::string tag;
+
+        // Skip empty lines and comments.
+        if(!(stream >> tag) || tag.front() == '#')
+            continue;
+
+        if(tag == "loop")
+        {
+            std::string value;
+            stream >> value;
+
+            looped = value == "true" || value == "1";
+        }
+        else if(tag == "frame")
+        {
+            Frame frame;
+            float duration = 0.0f;
+
+            if(!(stream >> frame.rectangle.x >> frame.rectangle.y >> frame.rectangle.z >> frame.rectangle.w >> duration))
+            {
+                LogError() << "Frame at line " << lineNumber << " is incomplete!";
+                return false;
+            }
+
+            if(duration <= 0.0f)
+            {
+                LogError() << "Frame at line " << lineNumber << " has an invalid duration!";
+                return false;
+            }
+
+            endTime += duration;
+            frame.endTime = endTime;
+
+            frames.push_back(frame);
+        }
+        else
+        {
+            LogWarning() << "Unknown tag \"" << tag << "\" at line " << lineNumber << " has been ignored.";
+        }
+    }
+
+    if(frames.empty())
+    {
+        LogError() << "Animation does not define any frames!";
+        return false;
+    }
+
+    // Save the loaded animation.
+    m_frames = std::move(frames);
+    m_looped = looped;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+const Animation::Frame& Animation::GetFrame(std::size_t index) const
+{
+    Verify(index < m_frames.size(), "Invalid argument - \"index\" is out of range!");
+
+    return m_frames[index];
+}
+
+std::size_t Animation::GetFrameCount() const
+{
+    return m_frames.size();
+}
+
+float Animation::GetDuration() const
+{
+    return m_frames.empty() ? 0.0f : m_frames.back().endTime;
+}
+
+bool Animation::IsLooped() const
+{
+    return m_looped;
+}
+
+bool Animation::IsValid() const
+{
+    return !m_frames.empty();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Animation
+
+    Flipbook animation loaded from a text file that lists sprite frames.
+    Each frame line holds a rectangle in the convention of sprite
+    rectangles and a duration in seconds. Lines starting with a hash are
+    comments. End times of frames are accumulated on load, so the current
+    frame can be found by stepping forward from the previous one.
+
+        # Run cycle.
+        loop true
+        frame 0 32 32 32 0.1
+        frame 32 32 32 32 0.1
+
+    void ExampleGraphicsAnimation(System::ResourceManager& resourceManager)
+    {
+        // Load an animation through the resource manager.
+        auto animation = resourceManager.Load<Graphics::Animation>("Data/Animations/Run.anim");
+
+        // Get the rectangle of the first frame.
+        const glm::vec4& rectangle = animation->GetFrame(0).rectangle;
+    }
+*/
+
+namespace Graphics
+{
+    // Animation class.
+    class Animation : private NonCopyable
+    {
+    public:
+        // Frame structure.
+        struct Frame
+        {
+            Frame();
+
+            // Sprite rectangle of the frame.
+            glm::vec4 rectangle;
+
+            // Time in seconds from the start of the animation to the end of the frame.
+            float endTime;
+        };
+
+    public:
+        Animation();
+        ~Animation();
+
+        // Loads the animation from a file.
+        bool Load(std::string filepath);
+
+        // Gets a frame.
+        const Frame& GetFrame(std::size_t index) const;
+
+        // Gets the number of frames.
+        std::size_t GetFrameCount() const;
+
+        // Gets the total duration in seconds.
+        float GetDuration() const;
+
+        // Checks if the animation loops.
+        bool IsLooped() const;
+
+        // Checks if the instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Type declarations.
+        typedef std::vector<Frame> FrameList;
+
+    private:
+        // List of frames.
+        FrameList m_frames;
+
+        // Looping state.
+        bool m_looped;
+    };
+}
@@ -1,7 +1,9 @@
 #include "Precompiled.hpp"
 #include "BasicRenderer.hpp"
 #include "System/ResourceManager.hpp"
-#include "Graphics/Texture.hpp"
+#include "Graphics/Material.hpp"
+#include "Graphics/StaticSpriteBuffer.hpp"
+#include "Graphics/StateCache.hpp"
 using namespace Graphics;
 
 namespace
@@ -12,6 +14,26 @@ namespace
         glm::vec2 position;
         glm::vec2 texture;
     };
+
+    // Frame constants structure.
+    // Follows the std140 layout of the uniform block in the sprite shader.
+    struct FrameConstants
+    {
+        glm::mat4 viewTransform;
+    };
+
+    // Sprite shader uniforms.
+    constexpr Uniform<glm::vec2> TextureSizeInv("textureSizeInv");
+}
+
+BasicRendererStats::BasicRendererStats() :
+    batches(0),
+    drawCalls(0),
+    programSwitches(0),
+    textureSwitches(0),
+    blendSwitches(0),
+    instanceBytes(0)
+{
 }
 
 BasicRendererInfo::BasicRendererInfo() :
@@ -21,6 +43,7 @@ BasicRendererInfo::BasicRendererInfo() :
 }
 
 BasicRenderer::BasicRenderer() :
+    m_viewTransform(1.0f),
     m_spriteBatchSize(0),
     m_initialized(false)
 {
@@ -91,11 +114,13 @@ bool BasicRenderer::Initialize(const BasicRendererInfo& info)
     // Create a vertex input.
     const VertexAttribute vertexAttributes[] =
     {
-        { &m_vertexBuffer,   VertexAttributeTypes::Float2   }, // Position
-        { &m_vertexBuffer,   VertexAttributeTypes::Float2   }, // Texture
-        { &m_instanceBuffer, VertexAttributeTypes::Float4x4 }, // Transform
-        { &m_instanceBuffer, VertexAttributeTypes::Float4   }, // Rectangle
-        { &m_instanceBuffer, VertexAttributeTypes::Float4   }, // Color
+        { &m_vertexBuffer,   VertexAttributeTypes::Float2     }, // Position
+        { &m_vertexBuffer,   VertexAttributeTypes::Float2     }, // Texture
+        { &m_instanceBuffer, VertexAttributeTypes::Float4x4   }, // Transform
+        { &m_instanceBuffer, VertexAttributeTypes::Float4     }, // Rectangle
+        { &m_instanceBuffer, VertexAttributeTypes::UByte4Norm }, // Diffuse color
+        { &m_instanceBuffer, VertexAttributeTypes::UByte4Norm }, // Emissive color
+        { &m_instanceBuffer, VertexAttributeTypes::Float1     }, // Emissive power
     };
 
     VertexInputInfo vertexInputInfo;
@@ -110,42 +135,97 @@ bool BasicRenderer::Initialize(const BasicRendererInfo& info)
 
     SCOPE_GUARD_IF(!m_initialized, m_vertexInput = VertexInput());
 
-    // Create a nearest filtering sampler.
-    SamplerInfo nearestSamplerInfo;
-    nearestSamplerInfo.textureMinFilter = GL_NEAREST;
-    nearestSamplerInfo.textureMagFilter = GL_NEAREST;
+    // Create a vertex input for static sprites.
+    // Instance attributes will be pointed at a static sprite buffer before each draw.
+    if(!m_staticVertexInput.Create(vertexInputInfo))
+    {
+        LogError() << "Could not create a static vertex input!";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_staticVertexInput = VertexInput());
 
-    if(!m_nearestSampler.Create(nearestSamplerInfo))
+    // Create a stream vertex buffer for lines.
+    // Buffer is reallocated when a batch of lines does not fit in it.
+    BufferInfo lineVertexBufferInfo;
+    lineVertexBufferInfo.usage = GL_STREAM_DRAW;
+    lineVertexBufferInfo.elementSize = sizeof(LineVertex);
+    lineVertexBufferInfo.elementCount = 1024;
+    lineVertexBufferInfo.data = nullptr;
+
+    if(!m_lineVertexBuffer.Create(lineVertexBufferInfo))
     {
-        LogError() << "Could not create a nearest filtering sampler!";
+        LogError() << "Could not create a line vertex buffer!";
         return false;
     }
 
-    SCOPE_GUARD_IF(!m_initialized, m_nearestSampler = Sampler());
+    SCOPE_GUARD_IF(!m_initialized, m_lineVertexBuffer = VertexBuffer());
+
+    // Create a vertex input for lines.
+    const VertexAttribute lineVertexAttributes[] =
+    {
+        { &m_lineVertexBuffer, VertexAttributeTypes::Float2 }, // Position
+        { &m_lineVertexBuffer, VertexAttributeTypes::Float4 }, // Color
+    };
 
-    // Create a linear filtering sampler.
-    SamplerInfo linearSamplerInfo;
-    linearSamplerInfo.textureMinFilter = GL_LINEAR;
-    linearSamplerInfo.textureMagFilter = GL_LINEAR;
+    VertexInputInfo lineVertexInputInfo;
+    lineVertexInputInfo.attributeCount = Utility::ArraySize(lineVertexAttributes);
+    lineVertexInputInfo.attributes = &lineVertexAttributes[0];
 
-    if(!m_linearSampler.Create(linearSamplerInfo))
+    if(!m_lineVertexInput.Create(lineVertexInputInfo))
     {
-        LogError() << "Could not create a linear filtering sampler!";
+        LogError() << "Could not create a line vertex input!";
         return false;
     }
 
-    SCOPE_GUARD_IF(!m_initialized, m_linearSampler = Sampler());
+    SCOPE_GUARD_IF(!m_initialized, m_lineVertexInput = VertexInput());
+
+    // Load the line shader.
+    m_lineShader = info.resourceManager->Load<Shader>("Data/Shaders/Line.glsl");
+
+    if(!m_lineShader->IsValid())
+    {
+        LogError() << "Could not load the line shader!";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, m_lineShader = nullptr);
+
+    // Create a uniform buffer for frame constants.
+    FrameConstants frameConstants;
+    frameConstants.viewTransform = m_viewTransform;
 
-    // Load the sprite shader.
-    m_shader = info.resourceManager->Load<Shader>("Data/Shaders/Sprite.glsl");
+    BufferInfo frameConstantsInfo;
+    frameConstantsInfo.usage = GL_DYNAMIC_DRAW;
+    frameConstantsInfo.elementSize = sizeof(FrameConstants);
+    frameConstantsInfo.elementCount = 1;
+    frameConstantsInfo.data = &frameConstants;
 
-    if(!m_shader->IsValid())
+    if(!m_frameConstantsBuffer.Create(frameConstantsInfo))
     {
-        LogError() << "Could not load the sprite shader!";
+        LogError() << "Could not create a uniform buffer!";
         return false;
     }
 
-    SCOPE_GUARD_IF(!m_initialized, m_shader = nullptr);
+    SCOPE_GUARD_IF(!m_initialized, m_frameConstantsBuffer = UniformBuffer());
+
+    // Setup constant shader uniforms.
+    // Sprite shaders have their blocks bound by materials.
+    if(!m_lineShader->BindUniformBlock(FrameConstantsBlock, FrameConstantsBinding))
+    {
+        LogError() << "Could not find the frame constants block in the line shader!";
+        return false;
+    }
+
+    // Create a GPU timer.
+    // Renderer can work without it, so only report its absence.
+    GpuTimerInfo gpuTimerInfo;
+    gpuTimerInfo.frameLatency = 3;
+
+    if(!m_gpuTimer.Initialize(gpuTimerInfo))
+    {
+        LogWarning() << "GPU timings will be unavailable.";
+    }
 
     // Remember the sprite batch size.
     m_spriteBatchSize = info.spriteBatchSize;
@@ -174,6 +254,9 @@ void BasicRenderer::Clear(const ClearValues& values)
     {
         glClearDepth(values.depth.value());
         mask |= GL_DEPTH_BUFFER_BIT;
+
+        // Depth writes have to be enabled for the depth buffer to be cleared.
+        GetStateCache()->SetDepthMask(true);
     }
 
     if(values.stencil.has_value())
@@ -205,57 +288,36 @@ void BasicRenderer::DrawSprites(const SpriteInfoList& spriteInfo, const SpriteDa
     // Make sure both lists have the same size.
     Verify(spriteInfo.size() == spriteData.size(), "Sprite data and info lists have different sizes!");
 
-    // Bind the vertex input.
-    glBindVertexArray(m_vertexInput.GetHandle());
-
-    SCOPE_GUARD(glBindVertexArray(0));
-
-    // Bind shader program.
-    glUseProgram(m_shader->GetHandle());
-
-    SCOPE_GUARD(glUseProgram(0));
-
-    // Set the view transform.
-    glUniformMatrix4fv(m_shader->GetUniform("viewTransform"), 1, GL_FALSE, glm::value_ptr(transform));
-
-    // Current transparency state.
-    bool currentTransparent = false;
+    // Call the sprite batching method with list storage.
+    this->DrawSprites(spriteInfo.data(), spriteData.data(), spriteInfo.size(), transform);
+}
 
-    SCOPE_GUARD_BEGIN();
-    {
-        if(currentTransparent)
-        {
-            glDisable(GL_BLEND);
-            glBlendFunc(GL_ONE, GL_ZERO);
+void BasicRenderer::DrawSprites(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const glm::mat4& transform)
+{
+    Verify(m_initialized, "Instance has not been initialized!");
 
-            glDepthMask(GL_TRUE);
-        }
-    }
-    SCOPE_GUARD_END();
+    if(spriteCount == 0)
+        return;
 
-    // Current texture state.
-    const Texture* currentTexture = nullptr;
+    Verify(spriteInfo != nullptr, "Invalid argument - \"spriteInfo\" is null!");
+    Verify(spriteData != nullptr, "Invalid argument - \"spriteData\" is null!");
 
-    SCOPE_GUARD_BEGIN();
-    {
-        if(currentTexture != nullptr)
-        {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, 0);
+    // Bind the vertex input.
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindVertexArray(m_vertexInput.GetHandle());
 
-            glBindSampler(0, 0);
-        }
-    }
-    SCOPE_GUARD_END();
+    // Set the view transform.
+    this->SetViewTransform(transform);
 
-    // Set used texture slot.
-    glUniform1i(m_shader->GetUniform("textureDiffuse"), 0);
+    // Current material state.
+    // Pipeline state is left as is after drawing, as it is shadowed by the state cache.
+    const Material* currentMaterial = nullptr;
 
     // Render sprite batches.
-    const int spriteCount = spriteInfo.size();
+    const int totalSprites = (int)spriteCount;
     int spritesDrawn = 0;
 
-    while(spritesDrawn != spriteCount)
+    while(spritesDrawn != totalSprites)
     {
         // Get the next sprite info that will represent current batch.
         const Sprite::Info& info = spriteInfo[spritesDrawn];
@@ -273,7 +335,7 @@ void BasicRenderer::DrawSprites(const SpriteInfoList& spriteInfo, const SpriteDa
             int spriteNext = spritesDrawn + spritesBatched;
 
             // Check if we have reached the end of the sprite list.
-            if(spriteNext >= spriteCount)
+            if(spriteNext >= totalSprites)
                 break;
 
             // Check if the next sprite can be batched.
@@ -286,72 +348,256 @@ void BasicRenderer::DrawSprites(const SpriteInfoList& spriteInfo, const SpriteDa
 
         // Update the instance buffer with sprite data.
         m_instanceBuffer.Update(&spriteData[spritesDrawn], spritesBatched);
+        m_stats.instanceBytes += spritesBatched * sizeof(Sprite::Data);
 
-        // Set transparency state.
-        if(currentTransparent != info.transparent)
-        {
-            if(info.transparent)
-            {
-                // Enable alpha blending.
-                glEnable(GL_BLEND);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-                // Disable depth writing.
-                glDepthMask(GL_FALSE);
-            }
-            else
-            {
-                // Set default blend state.
-                glDisable(GL_BLEND);
-
-                // Set default blend mask.
-                glDepthMask(GL_TRUE);
-            }
-
-            currentTransparent = info.transparent;
-        }
-
-        // Set texture state.
-        if(currentTexture != info.texture)
-        {
-            // Set texture shader uniform.
-            if(info.texture != nullptr)
-            {
-                // Calculate inversed texture size.
-                glm::vec2 textureInvSize;
-                textureInvSize.x = 1.0f / info.texture->GetWidth();
-                textureInvSize.y = 1.0f / info.texture->GetHeight();
-
-                glUniform2fv(m_shader->GetUniform("textureSizeInv"), 1, glm::value_ptr(textureInvSize));
-
-                // Bind texture unit.
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, info.texture->GetHandle());
-
-                // Bind texture sampler.
-                if(info.filter)
-                {
-                    glBindSampler(0, m_linearSampler.GetHandle());
-                }
-                else
-                {
-                    glBindSampler(0, m_nearestSampler.GetHandle());
-                }
-            }
-            else
-            {
-                // Disable texture unit.
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, 0);
-            }
-
-            currentTexture = info.texture;
-        }
+        // Set material state.
+        this->SetMaterialState(info.material, currentMaterial);
 
         // Draw instanced sprite batch.
         glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, spritesBatched);
 
+        m_stats.batches += 1;
+        m_stats.drawCalls += 1;
+
         // Update the counter of drawn sprites.
         spritesDrawn += spritesBatched;
     }
 }
+
+void BasicRenderer::DrawStaticSprites(const StaticSpriteBuffer& sprites, const std::size_t* batchIndices, std::size_t batchCount, const glm::mat4& transform)
+{
+    Verify(m_initialized, "Instance has not been initialized!");
+
+    if(batchCount == 0)
+        return;
+
+    Verify(batchIndices != nullptr, "Invalid argument - \"batchIndices\" is null!");
+
+    // Bind the static vertex input.
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindVertexArray(m_staticVertexInput.GetHandle());
+
+    // Bind the static instance buffer.
+    // Instance attributes are respecified with an offset to the first instance of each batch.
+    stateCache->BindBuffer(GL_ARRAY_BUFFER, sprites.GetInstanceBuffer().GetHandle());
+
+    // Set the view transform.
+    this->SetViewTransform(transform);
+
+    // Current material state.
+    // Pipeline state is left as is after drawing, as it is shadowed by the state cache.
+    const Material* currentMaterial = nullptr;
+
+    // Render static sprite batches.
+    for(std::size_t i = 0; i < batchCount; ++i)
+    {
+        const StaticSpriteBuffer::Batch& batch = sprites.GetBatch(batchIndices[i]);
+
+        // Point instance attributes at the first sprite of the batch.
+        this->SetInstanceOffset(batch.first);
+
+        // Set material state.
+        this->SetMaterialState(batch.info.material, currentMaterial);
+
+        // Draw instanced sprite batch.
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.count);
+
+        m_stats.batches += 1;
+        m_stats.drawCalls += 1;
+    }
+}
+
+void BasicRenderer::DrawSpriteInstances(const Sprite::Info& info, const Sprite::Data* instances, std::size_t instanceCount, const glm::mat4& transform)
+{
+    Verify(m_initialized, "Instance has not been initialized!");
+
+    if(instanceCount == 0)
+        return;
+
+    Verify(instances != nullptr, "Invalid argument - \"instances\" is null!");
+
+    // Upload instances to the stream buffer.
+    // Buffer is created on first use and only grows afterwards.
+    if(!m_streamInstanceBuffer.IsValid())
+    {
+        BufferInfo streamBufferInfo;
+        streamBufferInfo.usage = GL_STREAM_DRAW;
+        streamBufferInfo.elementSize = sizeof(Sprite::Data);
+        streamBufferInfo.elementCount = (unsigned int)instanceCount;
+        streamBufferInfo.data = instances;
+
+        if(!m_streamInstanceBuffer.Create(streamBufferInfo))
+        {
+            LogError() << "Could not create a stream instance buffer!";
+            return;
+        }
+    }
+    else if(instanceCount > m_streamInstanceBuffer.GetElementCount())
+    {
+        m_streamInstanceBuffer.Resize((unsigned int)instanceCount, instances);
+    }
+    else
+    {
+        m_streamInstanceBuffer.Update(instances, (int)instanceCount);
+    }
+
+    m_stats.instanceBytes += instanceCount * sizeof(Sprite::Data);
+
+    // Bind the static vertex input with the stream buffer.
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindVertexArray(m_staticVertexInput.GetHandle());
+    stateCache->BindBuffer(GL_ARRAY_BUFFER, m_streamInstanceBuffer.GetHandle());
+
+    this->SetInstanceOffset(0);
+
+    // Set the view transform.
+    this->SetViewTransform(transform);
+
+    // Set material state.
+    const Material* currentMaterial = nullptr;
+    this->SetMaterialState(info.material, currentMaterial);
+
+    // Draw all instances at once.
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)instanceCount);
+
+    m_stats.batches += 1;
+    m_stats.drawCalls += 1;
+}
+
+void BasicRenderer::DrawLines(const LineVertex* vertices, std::size_t vertexCount, const glm::mat4& transform)
+{
+    Verify(m_initialized, "Instance has not been initialized!");
+
+    if(vertexCount == 0)
+        return;
+
+    Verify(vertices != nullptr, "Invalid argument - \"vertices\" is null!");
+    Verify(vertexCount % 2 == 0, "Invalid argument - \"vertexCount\" is not even!");
+
+    // Upload vertices to the stream buffer.
+    if(vertexCount > m_lineVertexBuffer.GetElementCount())
+    {
+        m_lineVertexBuffer.Resize((unsigned int)vertexCount, vertices);
+    }
+    else
+    {
+        m_lineVertexBuffer.Update(vertices, (int)vertexCount);
+    }
+
+    // Bind the vertex input.
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindVertexArray(m_lineVertexInput.GetHandle());
+
+    // Bind shader program.
+    if(stateCache->UseProgram(m_lineShader->GetHandle()))
+    {
+        m_stats.programSwitches += 1;
+    }
+
+    // Set the view transform.
+    this->SetViewTransform(transform);
+
+    // Lines are blended over the scene.
+    if(stateCache->SetBlend(true))
+    {
+        m_stats.blendSwitches += 1;
+    }
+
+    stateCache->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    stateCache->SetDepthMask(false);
+
+    // Draw all lines at once.
+    glDrawArrays(GL_LINES, 0, (GLsizei)vertexCount);
+
+    m_stats.batches += 1;
+    m_stats.drawCalls += 1;
+}
+
+void BasicRenderer::SetInstanceOffset(std::size_t firstInstance)
+{
+    // Instance attributes keep the layout of the static vertex input,
+    // but source the instance buffer that is currently bound to the array target.
+    m_staticVertexInput.SetElementOffset(&m_instanceBuffer, firstInstance);
+}
+
+void BasicRenderer::ResetStats()
+{
+    m_stats = BasicRendererStats();
+}
+
+const BasicRendererStats& BasicRenderer::GetStats() const
+{
+    return m_stats;
+}
+
+GpuTimer& BasicRenderer::GetGpuTimer()
+{
+    return m_gpuTimer;
+}
+
+void BasicRenderer::SetViewTransform(const glm::mat4& transform)
+{
+    // Upload frame constants only when they change.
+    if(m_viewTransform != transform)
+    {
+        FrameConstants frameConstants;
+        frameConstants.viewTransform = transform;
+
+        m_frameConstantsBuffer.Update(&frameConstants);
+        m_viewTransform = transform;
+    }
+
+    // Bind the uniform buffer.
+    GetStateCache()->BindBufferBase(GL_UNIFORM_BUFFER, FrameConstantsBinding, m_frameConstantsBuffer.GetHandle());
+}
+
+void BasicRenderer::SetMaterialState(const Material* material, const Material*& currentMaterial)
+{
+    Assert(material != nullptr, "Sprite material is null!");
+
+    // Pipeline state only changes along with the material.
+    if(material == currentMaterial)
+        return;
+
+    const Material::PipelineState& state = material->GetState();
+    StateCache* stateCache = GetStateCache();
+
+    // Bind shader program.
+    bool programChanged = stateCache->UseProgram(state.program);
+
+    if(programChanged)
+    {
+        m_stats.programSwitches += 1;
+    }
+
+    // Set blend state.
+    if(stateCache->SetBlend(state.blend))
+    {
+        m_stats.blendSwitches += 1;
+    }
+
+    stateCache->SetBlendFunc(state.sourceFactor, state.destinationFactor);
+    stateCache->SetDepthMask(state.depthMask);
+
+    // Bind texture unit and its sampler.
+    bool textureChanged = stateCache->BindTexture(0, GL_TEXTURE_2D, material->GetTextureHandle());
+
+    if(textureChanged)
+    {
+        m_stats.textureSwitches += 1;
+    }
+
+    stateCache->BindSampler(0, state.sampler);
+
+    // Bind material constants.
+    stateCache->BindBufferBase(GL_UNIFORM_BUFFER, MaterialConstantsBinding, state.uniformBuffer);
+
+    // Set inversed texture size only when the bound texture or program changes.
+    // Pending textures change their handle along with their size once uploaded.
+    if(programChanged || textureChanged)
+    {
+        material->GetShader()->SetUniform(TextureSizeInv, material->GetTextureSizeInv());
+    }
+
+    currentMaterial = material;
+}
@@ -3,9 +3,9 @@
 #include "Precompiled.hpp"
 #include "VertexInput.hpp"
 #include "Buffer.hpp"
-#include "Sampler.hpp"
 #include "Shader.hpp"
 #include "Sprite.hpp"
+#include "GpuTimer.hpp"
 
 // Forward declarations.
 namespace System
@@ -41,7 +41,8 @@ namespace System
 namespace Graphics
 {
     // Forward declarations.
-    class Texture;
+    class Material;
+    class StaticSpriteBuffer;
 
     // Clear values structure.
     struct ClearValues
@@ -51,6 +52,26 @@ namespace Graphics
         std::optional<int> stencil;
     };
 
+    // Line vertex structure.
+    struct LineVertex
+    {
+        glm::vec2 position;
+        glm::vec4 color;
+    };
+
+    // Basic renderer stats structure.
+    struct BasicRendererStats
+    {
+        BasicRendererStats();
+
+        unsigned int batches;
+        unsigned int drawCalls;
+        unsigned int programSwitches;
+        unsigned int textureSwitches;
+        unsigned int blendSwitches;
+        std::size_t instanceBytes;
+    };
+
     // Basic renderer info struct.
     struct BasicRendererInfo
     {
@@ -85,19 +106,64 @@ namespace Graphics
         // Draws a batch of sprites.
         // Provide sprite lists that are already sorted for most efficient rendering.
         void DrawSprites(const SpriteInfoList& spriteInfo, const SpriteDataList& spriteData, const glm::mat4& transform);
+        void DrawSprites(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const glm::mat4& transform);
+
+        // Draws batches of sprites retained in a static sprite buffer.
+        // Batches are drawn in the order their indices are provided.
+        void DrawStaticSprites(const StaticSpriteBuffer& sprites, const std::size_t* batchIndices, std::size_t batchCount, const glm::mat4& transform);
+
+        // Draws sprites sharing the same info in a single call, regardless of the sprite batch size.
+        // Instances are uploaded to a stream buffer that grows to fit them.
+        void DrawSpriteInstances(const Sprite::Info& info, const Sprite::Data* instances, std::size_t instanceCount, const glm::mat4& transform);
+
+        // Draws colored lines from pairs of vertices in a single call.
+        // Vertices are uploaded to a stream buffer that grows to fit them.
+        void DrawLines(const LineVertex* vertices, std::size_t vertexCount, const glm::mat4& transform);
+
+        // Resets the stats counters.
+        void ResetStats();
+
+        // Gets the stats counters accumulated since the last reset.
+        const BasicRendererStats& GetStats() const;
+
+        // Gets the GPU timer.
+        // Timer is unavailable if timer queries are not supported.
+        GpuTimer& GetGpuTimer();
+
+    private:
+        // Sets the view transform in frame constants.
+        void SetViewTransform(const glm::mat4& transform);
+
+        // Points instance attributes of the static vertex input at an instance.
+        void SetInstanceOffset(std::size_t firstInstance);
+
+        // Sets the pipeline state of a material if it differs from the current one.
+        void SetMaterialState(const Material* material, const Material*& currentMaterial);
 
     private:
         // Graphics objects.
         VertexBuffer m_vertexBuffer;
         InstanceBuffer m_instanceBuffer;
+        InstanceBuffer m_streamInstanceBuffer;
         VertexInput m_vertexInput;
-        Sampler m_nearestSampler;
-        Sampler m_linearSampler;
-        ShaderPtr m_shader;
+        VertexInput m_staticVertexInput;
+
+        // Line drawing objects.
+        VertexBuffer m_lineVertexBuffer;
+        VertexInput m_lineVertexInput;
+        ShaderPtr m_lineShader;
+
+        // Frame constants.
+        UniformBuffer m_frameConstantsBuffer;
+        glm::mat4 m_viewTransform;
 
         // Sprite batch size.
         int m_spriteBatchSize;
 
+        // Stats counters.
+        BasicRendererStats m_stats;
+        GpuTimer m_gpuTimer;
+
         // Initialization state.
         bool m_initialized;
     };
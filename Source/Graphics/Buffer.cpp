@@ -1,5 +1,6 @@
 #include "Precompiled.hpp"
 #include "Buffer.hpp"
+#include "StateCache.hpp"
 using namespace Graphics;
 
 namespace
@@ -24,6 +25,7 @@ BufferInfo::BufferInfo() :
 Buffer::Buffer(GLenum type) :
     m_type(type),
     m_handle(InvalidHandle),
+    m_usage(InvalidEnum),
     m_elementSize(0),
     m_elementCount(0)
 {
@@ -40,6 +42,7 @@ void Buffer::DestroyHandle()
     if(m_handle != InvalidHandle)
     {
         glDeleteBuffers(1, &m_handle);
+        GetStateCache()->OnBufferDeleted(m_handle);
         m_handle = InvalidHandle;
     }
 }
@@ -79,13 +82,14 @@ bool Buffer::Create(const BufferInfo& info)
     }
 
     // Allocate buffer memory.
+    // Copy write target is used for uploads, so element array bindings of vertex arrays are not affected.
     unsigned int bufferSize = info.elementSize * info.elementCount;
 
-    glBindBuffer(m_type, m_handle);
-    glBufferData(m_type, bufferSize, info.data, info.usage);
-    glBindBuffer(m_type, 0);
+    GetStateCache()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+    glBufferData(GL_COPY_WRITE_BUFFER, bufferSize, info.data, info.usage);
 
     // Save buffer parameters.
+    m_usage = info.usage;
     m_elementSize = info.elementSize;
     m_elementCount = info.elementCount;
 
@@ -110,9 +114,21 @@ void Buffer::Update(const void* data, int count)
     }
 
     // Upload new buffer data.
-    glBindBuffer(m_type, m_handle);
-    glBufferSubData(m_type, 0, m_elementSize * count, data);
-    glBindBuffer(m_type, 0);
+    GetStateCache()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, m_elementSize * count, data);
+}
+
+void Buffer::Resize(unsigned int elementCount, const void* data)
+{
+    Verify(m_handle != InvalidHandle, "Buffer handle has not been created!");
+    Verify(elementCount != 0, "Invalid argument - \"elementCount\" is 0!");
+
+    // Reallocate buffer memory.
+    GetStateCache()->BindBuffer(GL_COPY_WRITE_BUFFER, m_handle);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_elementSize * elementCount, data, m_usage);
+
+    // Save the new element count.
+    m_elementCount = elementCount;
 }
 
 GLenum Buffer::GetType() const
@@ -223,3 +239,17 @@ bool InstanceBuffer::IsInstanced() const
 {
     return true;
 }
+
+/*
+    Uniform Buffer
+*/
+
+UniformBuffer::UniformBuffer() :
+    Buffer(GL_UNIFORM_BUFFER)
+{
+}
+
+const char* UniformBuffer::GetName() const
+{
+    return "uniform buffer";
+}
@@ -6,7 +6,7 @@
     Graphics Buffer
     
     Generic buffer base class that can handle different types of OpenGL buffers.
-    Available buffer types include vertex buffer, index buffer and instance buffer.
+    Available buffer types include vertex buffer, index buffer, instance buffer and uniform buffer.
     
     void ExampleGraphicsBuffer()
     {
@@ -67,6 +67,10 @@ namespace Graphics
         // Updates the buffer's data.
         void Update(const void* data, int count = -1);
 
+        // Reallocates the buffer's storage with a new element count.
+        // Previous content is discarded and replaced with provided data.
+        void Resize(unsigned int elementCount, const void* data = nullptr);
+
         // Gets the buffer's type.
         GLenum GetType() const;
 
@@ -102,6 +106,7 @@ namespace Graphics
         GLuint m_handle;
 
         // Buffer parameters.
+        GLenum m_usage;
         unsigned int m_elementSize;
         unsigned int m_elementCount;
     };
@@ -160,3 +165,19 @@ namespace Graphics
         bool IsInstanced() const override;
     };
 }
+
+/*
+    Graphics Uniform Buffer
+*/
+
+namespace Graphics
+{
+    class UniformBuffer : public Buffer
+    {
+    public:
+        UniformBuffer();
+
+        // Returns the buffer's name.
+        const char* GetName() const override;
+    };
+}
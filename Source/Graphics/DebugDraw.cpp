@@ -0,0 +1,91 @@
+#include "Precompiled.hpp"
+#include "DebugDraw.hpp"
+#include "Graphics/RenderCommandList.hpp"
+using namespace Graphics;
+
+#if DEBUG_DRAW_ENABLED
+
+DebugDraw::DebugDraw() :
+    m_lineCount(0)
+{
+}
+
+DebugDraw::~DebugDraw()
+{
+}
+
+void DebugDraw::Line(const glm::vec2& begin, const glm::vec2& end, const glm::vec4& color)
+{
+    m_vertices.push_back({ begin, color });
+    m_vertices.push_back({ end, color });
+}
+
+void DebugDraw::Rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color)
+{
+    glm::vec2 corners[4] =
+    {
+        glm::vec2(min.x, min.y), // Bottom-Left
+        glm::vec2(max.x, min.y), // Bottom-Right
+        glm::vec2(max.x, max.y), // Top-Right
+        glm::vec2(min.x, max.y), // Top-Left
+    };
+
+    for(int i = 0; i < 4; ++i)
+    {
+        this->Line(corners[i], corners[(i + 1) % 4], color);
+    }
+}
+
+void DebugDraw::Circle(const glm::vec2& center, float radius, const glm::vec4& color, int segments)
+{
+    if(segments < 3)
+        return;
+
+    // Rotate the radius vector by a constant step.
+    // Avoids evaluating trigonometric functions for every segment.
+    float step = glm::two_pi<float>() / segments;
+    float stepCos = std::cos(step);
+    float stepSin = std::sin(step);
+
+    glm::vec2 offset(radius, 0.0f);
+    glm::vec2 previous = center + offset;
+
+    for(int i = 1; i <= segments; ++i)
+    {
+        offset = glm::vec2(offset.x * stepCos - offset.y * stepSin, offset.x * stepSin + offset.y * stepCos);
+
+        // Close the circle exactly at its first point.
+        glm::vec2 current = i == segments ? center + glm::vec2(radius, 0.0f) : center + offset;
+
+        this->Line(previous, current, color);
+        previous = current;
+    }
+}
+
+void DebugDraw::Arrow(const glm::vec2& begin, const glm::vec2& end, const glm::vec4& color, float headSize)
+{
+    this->Line(begin, end, color);
+
+    // Draw the head as two lines pointing back along the arrow.
+    glm::vec2 back = (begin - end) * headSize;
+    glm::vec2 side(-back.y * 0.5f, back.x * 0.5f);
+
+    this->Line(end, end + back + side, color);
+    this->Line(end, end + back - side, color);
+}
+
+void DebugDraw::Flush(RenderCommandList& commandList, const glm::mat4& transform)
+{
+    m_lineCount = m_vertices.size() / 2;
+
+    // Vertices are copied by the list, so the array can be reused right away.
+    commandList.DrawLines(m_vertices.data(), m_vertices.size(), transform);
+    m_vertices.clear();
+}
+
+std::size_t DebugDraw::GetLineCount() const
+{
+    return m_lineCount;
+}
+
+#endif
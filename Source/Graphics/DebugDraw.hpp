@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "BasicRenderer.hpp"
+
+/*
+    Graphics Debug Draw
+
+    Collects lines, rectangles, circles and arrows drawn during a frame
+    into a single vertex array that is recorded as one line command when
+    flushed. Primitives only live until the next flush, so they have to be
+    drawn again every frame. Drawing is compiled out of release builds,
+    where all methods are empty and get inlined away, unless the
+    DEBUG_DRAW_ENABLED define is set explicitly.
+
+    void ExampleGraphicsDebugDraw(Graphics::RenderCommandList& commandList)
+    {
+        // Draw primitives in world space.
+        Graphics::DebugDraw debugDraw;
+        debugDraw.Line(glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        debugDraw.Circle(glm::vec2(0.0f, 0.0f), 0.5f);
+
+        // Record all primitives as a single command.
+        debugDraw.Flush(commandList, transform);
+    }
+*/
+
+#ifndef DEBUG_DRAW_ENABLED
+    #ifdef NDEBUG
+        #define DEBUG_DRAW_ENABLED 0
+    #else
+        #define DEBUG_DRAW_ENABLED 1
+    #endif
+#endif
+
+namespace Graphics
+{
+    // Forward declarations.
+    class RenderCommandList;
+
+    // Debug draw class.
+    class DebugDraw : private NonCopyable
+    {
+    public:
+        DebugDraw();
+        ~DebugDraw();
+
+        // Draws a line between two points.
+        void Line(const glm::vec2& begin, const glm::vec2& end, const glm::vec4& color = glm::vec4(1.0f));
+
+        // Draws an outline of a rectangle between two opposite corners.
+        void Rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color = glm::vec4(1.0f));
+
+        // Draws an outline of a circle approximated with line segments.
+        void Circle(const glm::vec2& center, float radius, const glm::vec4& color = glm::vec4(1.0f), int segments = 24);
+
+        // Draws a line with an arrow head at its end.
+        // Head size is a fraction of the arrow's length.
+        void Arrow(const glm::vec2& begin, const glm::vec2& end, const glm::vec4& color = glm::vec4(1.0f), float headSize = 0.2f);
+
+        // Records drawing of all primitives as a single command and clears them.
+        void Flush(RenderCommandList& commandList, const glm::mat4& transform);
+
+        // Gets the number of lines recorded by the last flush.
+        std::size_t GetLineCount() const;
+
+    private:
+        // Type declarations.
+        typedef std::vector<LineVertex> VertexList;
+
+    private:
+        // Vertices of primitives drawn this frame.
+        VertexList m_vertices;
+
+        // Number of lines recorded by the last flush.
+        std::size_t m_lineCount;
+    };
+}
+
+#if !DEBUG_DRAW_ENABLED
+
+// Empty methods that compile out debug drawing.
+inline Graphics::DebugDraw::DebugDraw() : m_lineCount(0) { }
+inline Graphics::DebugDraw::~DebugDraw() { }
+inline void Graphics::DebugDraw::Line(const glm::vec2&, const glm::vec2&, const glm::vec4&) { }
+inline void Graphics::DebugDraw::Rect(const glm::vec2&, const glm::vec2&, const glm::vec4&) { }
+inline void Graphics::DebugDraw::Circle(const glm::vec2&, float, const glm::vec4&, int) { }
+inline void Graphics::DebugDraw::Arrow(const glm::vec2&, const glm::vec2&, const glm::vec4&, float) { }
+inline void Graphics::DebugDraw::Flush(RenderCommandList&, const glm::mat4&) { }
+inline std::size_t Graphics::DebugDraw::GetLineCount() const { return 0; }
+
+#endif
@@ -0,0 +1,389 @@
+#include "Precompiled.hpp"
+#include "Font.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Padding between atlas cells.
+    // Prevents neighboring glyphs from bleeding in with linear filtering.
+    const int CellPadding = 1;
+
+    // Number of releases during which used glyphs cannot be evicted.
+    // Text of the previous frame may still be drawn by the render thread while the next one is laid out.
+    const unsigned int PinnedReleases = 2;
+
+    // Parses "key=value" pairs of a descriptor line.
+    std::unordered_map<std::string, std::string> ParseDescriptorLine(const std::string& line, std::string& tag)
+    {
+        std::unordered_map<std::string, std::string> values;
+        std::istringstream stream(line);
+
+        stream >> tag;
+
+        std::string token;
+        while(stream >> token)
+        {
+            std::size_t separator = token.find('=');
+            if(separator == std::string::npos)
+                continue;
+
+            std::string key = token.substr(0, separator);
+            std::string value = token.substr(separator + 1);
+
+            // Quoted values can contain spaces.
+            if(!value.empty() && value.front() == '"')
+            {
+                while(value.size() < 2 || value.back() != '"')
+                {
+                    std::string part;
+                    if(!(stream >> part))
+                        break;
+
+                    value += " " + part;
+                }
+
+                value = Utility::StringTrim(value, "\"");
+            }
+
+            values[key] = value;
+        }
+
+        return values;
+    }
+
+    // Gets an integer value of a descriptor key.
+    int GetDescriptorInt(const std::unordered_map<std::string, std::string>& values, const char* key)
+    {
+        auto it = values.find(key);
+        return it != values.end() ? std::atoi(it->second.c_str()) : 0;
+    }
+
+    // Combines two codepoints into a kerning key.
+    uint64_t KerningKey(uint32_t first, uint32_t second)
+    {
+        return ((uint64_t)first << 32) | second;
+    }
+}
+
+Font::Glyph::Glyph() :
+    rectangle(0.0f, 0.0f, 0.0f, 0.0f),
+    offset(0.0f, 0.0f),
+    advance(0.0f)
+{
+}
+
+Font::Font() :
+    m_lineHeight(0.0f),
+    m_cellSize(0, 0),
+    m_cellColumns(0),
+    m_cellCount(0),
+    m_usage(1),
+    m_cacheMisses(0)
+{
+}
+
+Font::~Font()
+{
+}
+
+bool Font::Load(std::string filepath)
+{
+    Log() << "Loading font from \"" << filepath << "\" file..." << LogIndent();
+
+    // Check if font has been already loaded.
+    Verify(m_atlas == nullptr, "Font instance has been already initialized!");
+
+    // Validate arguments.
+    if(filepath.empty())
+    {
+        LogError() << "Invalid argument - \"filepath\" is empty!";
+        return false;
+    }
+
+    // Open the descriptor file.
+    std::ifstream file(Build::GetWorkingDir() + filepath);
+
+    if(!file.is_open())
+    {
+        LogError() << "Could not open the file!";
+        return false;
+    }
+
+    // Parse descriptor lines.
+    std::string directory = Utility::GetFilePath(filepath);
+    std::string line;
+
+    while(std::getline(file, line))
+    {
+        std::string tag;
+        auto values = ParseDescriptorLine(line, tag);
+
+        if(tag == "common")
+        {
+            m_lineHeight = (float)GetDescriptorInt(values, "lineHeight");
+        }
+        else if(tag == "page")
+        {
+            // Load page images in order of their indices.
+            std::size_t page = (std::size_t)GetDescriptorInt(values, "id");
+
+            if(page >= m_pages.size())
+            {
+                m_pages.resize(page + 1);
+            }
+
+            if(!m_pages[page].Load(directory + values["file"]))
+            {
+                LogError() << "Could not load a font page!";
+                return false;
+            }
+        }
+        else if(tag == "char")
+        {
+            SourceGlyph glyph;
+            glyph.page = GetDescriptorInt(values, "page");
+            glyph.rectangle.x = GetDescriptorInt(values, "x");
+            glyph.rectangle.y = GetDescriptorInt(values, "y");
+            glyph.rectangle.z = GetDescriptorInt(values, "width");
+            glyph.rectangle.w = GetDescriptorInt(values, "height");
+            glyph.offset.x = GetDescriptorInt(values, "xoffset");
+            glyph.offset.y = GetDescriptorInt(values, "yoffset");
+            glyph.advance = GetDescriptorInt(values, "xadvance");
+
+            m_sourceGlyphs[(uint32_t)GetDescriptorInt(values, "id")] = glyph;
+        }
+        else if(tag == "kerning")
+        {
+            uint32_t first = (uint32_t)GetDescriptorInt(values, "first");
+            uint32_t second = (uint32_t)GetDescriptorInt(values, "second");
+
+            m_kerning[KerningKey(first, second)] = (float)GetDescriptorInt(values, "amount");
+        }
+    }
+
+    // Validate glyphs against loaded pages.
+    for(const auto& pair : m_sourceGlyphs)
+    {
+        const SourceGlyph& glyph = pair.second;
+
+        if(glyph.page < 0 || glyph.page >= (int)m_pages.size() || !m_pages[glyph.page].IsValid())
+        {
+            LogError() << "Glyph " << pair.first << " references an invalid page!";
+            return false;
+        }
+
+        const Image& page = m_pages[glyph.page];
+
+        if(glyph.rectangle.x < 0 || glyph.rectangle.y < 0 ||
+            glyph.rectangle.x + glyph.rectangle.z > page.GetWidth() ||
+            glyph.rectangle.y + glyph.rectangle.w > page.GetHeight())
+        {
+            LogError() << "Glyph " << pair.first << " lies outside of its page!";
+            return false;
+        }
+
+        // Size atlas cells to fit the largest glyph.
+        m_cellSize = glm::max(m_cellSize, glm::ivec2(glyph.rectangle.z, glyph.rectangle.w));
+    }
+
+    if(m_sourceGlyphs.empty())
+    {
+        LogError() << "Font does not define any glyphs!";
+        return false;
+    }
+
+    // Divide the atlas into cells.
+    m_cellSize += CellPadding;
+    m_cellColumns = AtlasSize / m_cellSize.x;
+    m_cellCount = m_cellColumns * (AtlasSize / m_cellSize.y);
+
+    if(m_cellCount == 0)
+    {
+        LogError() << "Glyphs are too large for the atlas!";
+        return false;
+    }
+
+    m_freeCells.resize(m_cellCount);
+
+    for(int i = 0; i < m_cellCount; ++i)
+    {
+        m_freeCells[i] = m_cellCount - i - 1;
+    }
+
+    m_cache.reserve(m_cellCount);
+
+    // Create the atlas texture.
+    std::vector<uint8_t> atlasData(AtlasSize * AtlasSize * 4, 0);
+
+    auto atlas = std::make_shared<Texture>();
+
+    if(!atlas->Create(AtlasSize, AtlasSize, GL_RGBA, atlasData.data()))
+    {
+        LogError() << "Could not create the atlas texture!";
+        return false;
+    }
+
+    m_atlas = atlas;
+
+    LogInfo() << "Font has " << m_sourceGlyphs.size() << " glyphs and " << m_cellCount << " atlas cells.";
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+const Font::Glyph* Font::GetGlyph(uint32_t codepoint) const
+{
+    Verify(m_atlas != nullptr, "Font has not been loaded!");
+
+    // Return a cached glyph and mark it as most recently used.
+    auto it = m_cache.find(codepoint);
+
+    if(it != m_cache.end())
+    {
+        CacheEntry& entry = it->second;
+        entry.usage = m_usage;
+
+        m_recent.splice(m_recent.begin(), m_recent, entry.recent);
+
+        return &entry.glyph;
+    }
+
+    // Find the glyph in the font source.
+    auto source = m_sourceGlyphs.find(codepoint);
+
+    if(source == m_sourceGlyphs.end())
+        return nullptr;
+
+    // Acquire an atlas cell.
+    int cell = 0;
+
+    if(!m_freeCells.empty())
+    {
+        cell = m_freeCells.back();
+        m_freeCells.pop_back();
+    }
+    else
+    {
+        // Evict the least recently used glyph.
+        // If it is still pinned by recorded text, so are all the others.
+        auto evicted = m_cache.find(m_recent.back());
+        Assert(evicted != m_cache.end());
+
+        if(m_usage - evicted->second.usage < PinnedReleases)
+            return nullptr;
+
+        cell = evicted->second.cell;
+
+        m_recent.pop_back();
+        m_cache.erase(evicted);
+    }
+
+    // Copy the glyph into the atlas.
+    CacheEntry entry;
+    entry.cell = cell;
+    entry.usage = m_usage;
+
+    this->CopyGlyph(source->second, cell, entry.glyph);
+
+    m_recent.push_front(codepoint);
+    entry.recent = m_recent.begin();
+
+    m_cacheMisses += 1;
+
+    return &m_cache.emplace(codepoint, entry).first->second.glyph;
+}
+
+void Font::CopyGlyph(const SourceGlyph& source, int cell, Glyph& glyph) const
+{
+    const Image& page = m_pages[source.page];
+
+    int width = source.rectangle.z;
+    int height = source.rectangle.w;
+
+    // Calculate the cell position.
+    int cellX = (cell % m_cellColumns) * m_cellSize.x;
+    int cellY = (cell / m_cellColumns) * m_cellSize.y;
+
+    // Convert glyph pixels to the atlas format.
+    // Page rows are stored from the bottom, while descriptor rectangles are measured from the top.
+    if(width > 0 && height > 0)
+    {
+        m_staging.resize(width * height * 4);
+
+        int pageBottom = page.GetHeight() - source.rectangle.y - height;
+
+        for(int y = 0; y < height; ++y)
+        {
+            for(int x = 0; x < width; ++x)
+            {
+                const uint8_t* pixel = page.GetPixel(source.rectangle.x + x, pageBottom + y);
+                uint8_t* output = &m_staging[(y * width + x) * 4];
+
+                switch(page.GetChannels())
+                {
+                case 1:
+                    // Single channel pages store coverage as alpha.
+                    output[0] = output[1] = output[2] = 255;
+                    output[3] = pixel[0];
+                    break;
+
+                case 2:
+                    output[0] = output[1] = output[2] = pixel[0];
+                    output[3] = pixel[1];
+                    break;
+
+                case 3:
+                    output[0] = pixel[0];
+                    output[1] = pixel[1];
+                    output[2] = pixel[2];
+                    output[3] = 255;
+                    break;
+
+                default:
+                    std::memcpy(output, pixel, 4);
+                    break;
+                }
+            }
+        }
+
+        m_atlas->UpdateRegion(cellX, cellY, width, height, m_staging.data());
+    }
+
+    // Describe the cached glyph.
+    glyph.rectangle = glm::vec4(cellX, cellY + height, width, height);
+    glyph.offset = glm::vec2(source.offset);
+    glyph.advance = (float)source.advance;
+}
+
+float Font::GetKerning(uint32_t first, uint32_t second) const
+{
+    auto it = m_kerning.find(KerningKey(first, second));
+    return it != m_kerning.end() ? it->second : 0.0f;
+}
+
+void Font::ReleaseGlyphs() const
+{
+    m_usage += 1;
+}
+
+std::shared_ptr<const Texture> Font::GetAtlas() const
+{
+    return m_atlas;
+}
+
+float Font::GetLineHeight() const
+{
+    return m_lineHeight;
+}
+
+unsigned int Font::GetCacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+bool Font::IsValid() const
+{
+    return m_atlas != nullptr;
+}
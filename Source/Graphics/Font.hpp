@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Image.hpp"
+#include "Texture.hpp"
+
+/*
+    Graphics Font
+
+    Bitmap font loaded from a descriptor in the text BMFont format along
+    with its page images. Glyphs are kept in system memory and copied into
+    an atlas texture on demand. The atlas is divided into equal cells that
+    are reused for other glyphs in least recently used order. Glyphs used
+    since the last two releases cannot be evicted, so laid out text stays
+    valid while the frame that recorded it is drawn on the render thread
+    and the next frame is laid out.
+
+    void ExampleGraphicsFont(System::ResourceManager& resourceManager)
+    {
+        // Load a font through the resource manager.
+        auto font = resourceManager.Load<Graphics::Font>("Data/Fonts/Debug.fnt");
+
+        // Get a glyph, caching it in the atlas if needed.
+        const Graphics::Font::Glyph* glyph = font->GetGlyph('A');
+
+        // Release glyphs after text using them has been drawn.
+        font->ReleaseGlyphs();
+    }
+*/
+
+namespace Graphics
+{
+    // Font class.
+    class Font : private NonCopyable
+    {
+    public:
+        // Size of the atlas texture.
+        static const int AtlasSize = 512;
+
+        // Glyph structure.
+        struct Glyph
+        {
+            Glyph();
+
+            // Atlas rectangle in the sprite rectangle convention.
+            glm::vec4 rectangle;
+
+            // Offset from the pen position at the top of the line to the top left corner of the glyph.
+            // Vertical offset points down.
+            glm::vec2 offset;
+
+            // Horizontal pen advance.
+            float advance;
+        };
+
+    public:
+        Font();
+        ~Font();
+
+        // Loads the font from a descriptor file.
+        bool Load(std::string filepath);
+
+        // Gets a glyph and caches it in the atlas if needed.
+        // Returns null if the font has no such glyph or the atlas is full of pinned glyphs.
+        const Glyph* GetGlyph(uint32_t codepoint) const;
+
+        // Gets the kerning adjustment between two glyphs.
+        float GetKerning(uint32_t first, uint32_t second) const;
+
+        // Marks the end of a frame's text.
+        // Glyphs used so far can be evicted after the following release.
+        void ReleaseGlyphs() const;
+
+        // Gets the atlas texture.
+        // Atlas is shared, so it can outlive the font while text drawn with it is in flight.
+        std::shared_ptr<const Texture> GetAtlas() const;
+
+        // Gets the distance between lines.
+        float GetLineHeight() const;
+
+        // Gets the number of glyphs that had to be copied to the atlas.
+        unsigned int GetCacheMisses() const;
+
+        // Checks if the font instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Source glyph structure.
+        struct SourceGlyph
+        {
+            int page;
+            glm::ivec4 rectangle;
+            glm::ivec2 offset;
+            int advance;
+        };
+
+        // Cache entry structure.
+        struct CacheEntry
+        {
+            Glyph glyph;
+            int cell;
+            unsigned int usage;
+            std::list<uint32_t>::iterator recent;
+        };
+
+        // Type declarations.
+        typedef std::vector<Image> PageList;
+        typedef std::unordered_map<uint32_t, SourceGlyph> SourceGlyphList;
+        typedef std::unordered_map<uint64_t, float> KerningList;
+        typedef std::unordered_map<uint32_t, CacheEntry> CacheEntryList;
+        typedef std::list<uint32_t> RecentList;
+
+    private:
+        // Copies a source glyph into an atlas cell.
+        void CopyGlyph(const SourceGlyph& source, int cell, Glyph& glyph) const;
+
+    private:
+        // Font source data.
+        PageList m_pages;
+        SourceGlyphList m_sourceGlyphs;
+        KerningList m_kerning;
+        float m_lineHeight;
+
+        // Atlas layout.
+        glm::ivec2 m_cellSize;
+        int m_cellColumns;
+        int m_cellCount;
+
+        // Glyph cache.
+        // Most recently used glyphs are at the front of the recent list.
+        std::shared_ptr<Texture> m_atlas;
+        mutable CacheEntryList m_cache;
+        mutable RecentList m_recent;
+        mutable std::vector<int> m_freeCells;
+        mutable std::vector<uint8_t> m_staging;
+        mutable unsigned int m_usage;
+        mutable unsigned int m_cacheMisses;
+    };
+}
@@ -0,0 +1,479 @@
+#include "Precompiled.hpp"
+#include "FrameCapture.hpp"
+#include "RenderThread.hpp"
+#include "RenderCommandList.hpp"
+#include "StateCache.hpp"
+#include "System/ThreadPool.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Invalid types.
+    const GLuint InvalidHandle = 0;
+
+    // Number of bytes of a captured pixel.
+    const std::size_t PixelSize = 4;
+
+    // Timeout of a single wait for a fence in nanoseconds.
+    const GLuint64 FenceWaitTimeout = 100 * 1000 * 1000;
+
+    // Makes pixels opaque, as alpha of the render target is not meaningful.
+    void MakeOpaque(std::vector<uint8_t>& pixels)
+    {
+        for(std::size_t i = PixelSize - 1; i < pixels.size(); i += PixelSize)
+        {
+            pixels[i] = 255;
+        }
+    }
+
+    // Writes pixels as a PNG file.
+    // Rows are read from the bottom, as this is how OpenGL stores them.
+    bool WritePng(const std::string& path, const std::vector<uint8_t>& pixels, int width, int height)
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        if(!file.is_open())
+            return false;
+
+        // Create format encoder structures.
+        png_structp png_write_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+
+        if(png_write_ptr == nullptr)
+            return false;
+
+        png_infop png_info_ptr = png_create_info_struct(png_write_ptr);
+
+        if(png_info_ptr == nullptr)
+        {
+            png_destroy_write_struct(&png_write_ptr, nullptr);
+            return false;
+        }
+
+        SCOPE_GUARD_BEGIN();
+        {
+            png_destroy_write_struct(&png_write_ptr, &png_info_ptr);
+        }
+        SCOPE_GUARD_END();
+
+        // Declare file write functions.
+        auto png_write_function = [](png_structp png_ptr, png_bytep data, png_size_t length) -> void
+        {
+            std::ofstream* file = (std::ofstream*)png_get_io_ptr(png_ptr);
+
+            if(!file->write((const char*)data, length))
+            {
+                png_error(png_ptr, "Could not write to the file.");
+            }
+        };
+
+        auto png_flush_function = [](png_structp png_ptr) -> void
+        {
+            std::ofstream* file = (std::ofstream*)png_get_io_ptr(png_ptr);
+            file->flush();
+        };
+
+        // Setup an array of row pointers in reversed order to flip the image.
+        std::vector<png_bytep> png_row_ptrs(height);
+        png_uint_32 png_stride = width * PixelSize;
+
+        for(int i = 0; i < height; ++i)
+        {
+            png_row_ptrs[height - i - 1] = (png_bytep)pixels.data() + i * png_stride;
+        }
+
+        // Setup the error handling routine.
+        // Objects with destructors have to be declared before this call, see Image::Decode().
+        if(setjmp(png_jmpbuf(png_write_ptr)))
+            return false;
+
+        png_set_write_fn(png_write_ptr, (png_voidp)&file, png_write_function, png_flush_function);
+
+        // Favor encoding speed over file size, as frames are usually captured in sequences.
+        png_set_IHDR(png_write_ptr, png_info_ptr, width, height, 8, PNG_COLOR_TYPE_RGBA,
+            PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        png_set_compression_level(png_write_ptr, Z_BEST_SPEED);
+        png_set_filter(png_write_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+
+        // Write image data.
+        png_write_info(png_write_ptr, png_info_ptr);
+        png_write_image(png_write_ptr, png_row_ptrs.data());
+        png_write_end(png_write_ptr, nullptr);
+
+        return file.good();
+    }
+
+    // Writes pixels as tightly packed rows from top to bottom.
+    bool WriteRaw(const std::string& path, const std::vector<uint8_t>& pixels, int width, int height)
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        if(!file.is_open())
+            return false;
+
+        std::size_t stride = width * PixelSize;
+
+        for(int i = height - 1; i >= 0; --i)
+        {
+            file.write((const char*)pixels.data() + i * stride, stride);
+        }
+
+        return file.good();
+    }
+}
+
+FrameCaptureInfo::FrameCaptureInfo() :
+    renderThread(nullptr),
+    threadPool(nullptr),
+    bufferCount(3),
+    format(FrameCaptureFormats::Png)
+{
+}
+
+FrameCaptureStats::FrameCaptureStats() :
+    requested(0),
+    saved(0),
+    failed(0)
+{
+}
+
+FrameCapture::FrameCapture() :
+    m_renderThread(nullptr),
+    m_threadPool(nullptr),
+    m_format(FrameCaptureFormats::Png),
+    m_firstPending(0),
+    m_pendingCount(0),
+    m_frameIndex(0),
+    m_inFlight(0),
+    m_requested(0),
+    m_saved(0),
+    m_failed(0),
+    m_initialized(false)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    // Wait for captures in flight before their buffers are deleted.
+    if(m_initialized)
+    {
+        this->Flush();
+    }
+
+    this->DestroyObjects();
+}
+
+void FrameCapture::DestroyObjects()
+{
+    for(Slot& slot : m_slots)
+    {
+        if(slot.fence != nullptr)
+        {
+            glDeleteSync(slot.fence);
+        }
+
+        if(slot.buffer != InvalidHandle)
+        {
+            glDeleteBuffers(1, &slot.buffer);
+        }
+    }
+
+    m_slots.clear();
+    m_firstPending = 0;
+    m_pendingCount = 0;
+}
+
+bool FrameCapture::Initialize(const FrameCaptureInfo& info)
+{
+    Log() << "Initializing frame capture..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Frame capture instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.renderThread == nullptr)
+    {
+        LogError() << "Invalid argument - \"renderThread\" is null!";
+        return false;
+    }
+
+    if(info.threadPool == nullptr)
+    {
+        LogError() << "Invalid argument - \"threadPool\" is null!";
+        return false;
+    }
+
+    if(info.bufferCount <= 0)
+    {
+        LogError() << "Invalid argument - \"bufferCount\" is invalid!";
+        return false;
+    }
+
+    if(info.format < FrameCaptureFormats::Png || info.format >= FrameCaptureFormats::Count)
+    {
+        LogError() << "Invalid argument - \"format\" is invalid!";
+        return false;
+    }
+
+    // Create pixel buffers.
+    // Their storage is allocated once the size of the render target is known.
+    SCOPE_GUARD_IF(!m_initialized, this->DestroyObjects());
+
+    m_slots.resize(info.bufferCount);
+
+    for(Slot& slot : m_slots)
+    {
+        slot.buffer = InvalidHandle;
+        slot.bufferSize = 0;
+        slot.fence = nullptr;
+        slot.frame = 0;
+        slot.width = 0;
+        slot.height = 0;
+
+        glGenBuffers(1, &slot.buffer);
+
+        if(slot.buffer == InvalidHandle)
+        {
+            LogError() << "Could not create a pixel buffer!";
+            return false;
+        }
+    }
+
+    // Save instance references.
+    m_renderThread = info.renderThread;
+    m_threadPool = info.threadPool;
+    m_format = info.format;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void FrameCapture::Request(std::string filepath)
+{
+    Verify(m_initialized, "Frame capture has not been initialized!");
+    Verify(!filepath.empty(), "Invalid argument - \"filepath\" is empty!");
+
+    // Replace a request that has not been recorded yet.
+    m_request = std::move(filepath);
+}
+
+void FrameCapture::Record(RenderCommandList& commandList, GLuint framebuffer, int width, int height)
+{
+    Verify(m_initialized, "Frame capture has not been initialized!");
+
+    // Skip the command if there is nothing to read or resolve.
+    if(m_request.empty() && m_inFlight.load() == 0)
+        return;
+
+    if(!m_request.empty())
+    {
+        m_inFlight += 1;
+        m_requested += 1;
+    }
+
+    commandList.CaptureFrame(this, framebuffer, width, height, m_request);
+    m_request.clear();
+}
+
+void FrameCapture::Execute(GLuint framebuffer, int width, int height, const std::string& filepath)
+{
+    Assert(m_initialized, "Frame capture has not been initialized!");
+
+    m_frameIndex += 1;
+
+    // Resolve captures whose fences have been signaled, oldest first.
+    // Captures left in flight for as many frames as there are buffers are waited for.
+    while(m_pendingCount != 0)
+    {
+        const Slot& slot = m_slots[m_firstPending];
+        bool expired = m_frameIndex - slot.frame >= m_slots.size();
+
+        if(!this->ResolveSlot(expired))
+            break;
+    }
+
+    if(filepath.empty())
+        return;
+
+    if(width <= 0 || height <= 0)
+    {
+        m_inFlight -= 1;
+        m_failed += 1;
+        return;
+    }
+
+    // Make room for the capture if the ring is full.
+    if(m_pendingCount == m_slots.size())
+    {
+        this->ResolveSlot(true);
+    }
+
+    Slot& slot = m_slots[(m_firstPending + m_pendingCount) % m_slots.size()];
+    StateCache* stateCache = GetStateCache();
+
+    // Reallocate the buffer if the size of the render target has changed.
+    std::size_t bufferSize = (std::size_t)width * height * PixelSize;
+
+    stateCache->BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+
+    if(slot.bufferSize != bufferSize)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+        slot.bufferSize = bufferSize;
+    }
+
+    // Queue a copy of pixels into the buffer and place a fence after it.
+    // Rows of four byte pixels are always aligned, so the default pack alignment is kept.
+    stateCache->BindFramebuffer(framebuffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    // Unbind the buffer, so other reads write to client memory again.
+    stateCache->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = m_frameIndex;
+    slot.filepath = filepath;
+    slot.width = width;
+    slot.height = height;
+
+    m_pendingCount += 1;
+}
+
+bool FrameCapture::ResolveSlot(bool wait)
+{
+    Assert(m_pendingCount != 0, "There are no pending captures to resolve!");
+
+    Slot& slot = m_slots[m_firstPending];
+
+    // Check the fence of the capture.
+    // Flushing makes sure that the fence gets signaled eventually.
+    GLenum result;
+
+    do
+    {
+        result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? FenceWaitTimeout : 0);
+    }
+    while(wait && result == GL_TIMEOUT_EXPIRED);
+
+    if(result == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    // Release the slot, as pixels are copied out of its buffer below.
+    m_firstPending = (m_firstPending + 1) % m_slots.size();
+    m_pendingCount -= 1;
+    m_inFlight -= 1;
+
+    if(result == GL_WAIT_FAILED)
+    {
+        m_failed += 1;
+        return true;
+    }
+
+    // Copy pixels out of the buffer, so it can be reused while a worker encodes them.
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+
+    std::vector<uint8_t> pixels;
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.bufferSize, GL_MAP_READ_BIT);
+
+    if(mapped != nullptr)
+    {
+        pixels.assign((const uint8_t*)mapped, (const uint8_t*)mapped + slot.bufferSize);
+
+        if(glUnmapBuffer(GL_PIXEL_PACK_BUFFER) != GL_TRUE)
+        {
+            pixels.clear();
+        }
+    }
+
+    stateCache->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(pixels.empty())
+    {
+        m_failed += 1;
+        return true;
+    }
+
+    // Encode and write pixels on a worker thread.
+    // Workers cannot log, so results are only counted.
+    std::string path = Build::GetWorkingDir() + slot.filepath;
+    FrameCaptureFormats format = m_format;
+    int width = slot.width;
+    int height = slot.height;
+
+    std::future<void> task = m_threadPool->Submit([this, path, format, width, height, pixels = std::move(pixels)]() mutable
+    {
+        MakeOpaque(pixels);
+
+        bool written = format == FrameCaptureFormats::Png ?
+            WritePng(path, pixels, width, height) : WriteRaw(path, pixels, width, height);
+
+        if(written)
+        {
+            m_saved += 1;
+        }
+        else
+        {
+            m_failed += 1;
+        }
+    });
+
+    // Keep the task, while dropping ones that have already finished.
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), [](const std::future<void>& task)
+    {
+        return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), m_tasks.end());
+
+    m_tasks.push_back(std::move(task));
+
+    return true;
+}
+
+void FrameCapture::Flush()
+{
+    Verify(m_initialized, "Frame capture has not been initialized!");
+
+    // Resolve captures of executed frames.
+    // Captures recorded in a frame that has not been submitted yet are not waited for.
+    m_renderThread->Invoke([this]()
+    {
+        while(m_pendingCount != 0)
+        {
+            this->ResolveSlot(true);
+        }
+    });
+
+    // Wait for workers to write captured frames.
+    TaskList tasks;
+
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        tasks.swap(m_tasks);
+    }
+
+    for(std::future<void>& task : tasks)
+    {
+        task.wait();
+    }
+}
+
+FrameCaptureStats FrameCapture::GetStats() const
+{
+    FrameCaptureStats stats;
+    stats.requested = m_requested;
+    stats.saved = m_saved.load();
+    stats.failed = m_failed.load();
+
+    return stats;
+}
+
+bool FrameCapture::IsValid() const
+{
+    return m_initialized;
+}
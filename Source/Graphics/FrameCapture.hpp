@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ThreadPool;
+}
+
+/*
+    Graphics Frame Capture
+
+    Saves rendered frames to files without stalling the frame loop.
+    Pixels of a requested frame are read into a pixel buffer object on
+    the render thread, which only queues a copy on the GPU. Buffers are
+    kept in a ring and mapped a few frames later, once a fence placed
+    after the read is signaled, so mapping does not wait for the GPU.
+    Mapped pixels are handed over to a worker thread that encodes and
+    writes them, which keeps encoding cost off both the main and render
+    threads. Capture waits for the oldest frame only if more frames are
+    requested than there are buffers in the ring.
+
+    void ExampleGraphicsFrameCapture(Graphics::RenderThread& renderThread, System::ThreadPool& threadPool)
+    {
+        // Create a frame capture instance.
+        Graphics::FrameCaptureInfo frameCaptureInfo;
+        frameCaptureInfo.renderThread = &renderThread;
+        frameCaptureInfo.threadPool = &threadPool;
+        frameCaptureInfo.format = Graphics::FrameCaptureFormats::Png;
+
+        Graphics::FrameCapture frameCapture;
+        frameCapture.Initialize(frameCaptureInfo);
+
+        // Request a capture of the frame being recorded.
+        frameCapture.Request("Captures/Frame.png");
+        frameCapture.Record(renderThread.GetCommandList(), 0, 1024, 576);
+
+        // Wait until all captured frames have been written.
+        frameCapture.Flush();
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class RenderThread;
+    class RenderCommandList;
+
+    // Frame capture formats.
+    enum class FrameCaptureFormats
+    {
+        // Compressed RGBA image.
+        Png,
+
+        // Tightly packed RGBA rows from top to bottom.
+        Raw,
+
+        Count,
+    };
+
+    // Frame capture info structure.
+    struct FrameCaptureInfo
+    {
+        FrameCaptureInfo();
+
+        RenderThread* renderThread;
+        System::ThreadPool* threadPool;
+
+        // Number of pixel buffers in the ring.
+        // Captured frames are mapped at most this many frames later.
+        int bufferCount;
+
+        FrameCaptureFormats format;
+    };
+
+    // Frame capture stats structure.
+    struct FrameCaptureStats
+    {
+        FrameCaptureStats();
+
+        unsigned int requested;
+        unsigned int saved;
+        unsigned int failed;
+    };
+
+    // Frame capture class.
+    class FrameCapture : private NonCopyable
+    {
+    public:
+        FrameCapture();
+        ~FrameCapture();
+
+        // Initializes the frame capture.
+        bool Initialize(const FrameCaptureInfo& info);
+
+        // Requests a capture of the next recorded frame.
+        // Path is relative to the working directory, which has to contain its directories.
+        void Request(std::string filepath);
+
+        // Records a capture of the render target after commands of the frame.
+        // Also resolves captures of previous frames, so it should be called every frame.
+        void Record(RenderCommandList& commandList, GLuint framebuffer, int width, int height);
+
+        // Resolves finished captures and reads pixels of the render target if a path is given.
+        // Called by the command list on the render thread.
+        void Execute(GLuint framebuffer, int width, int height, const std::string& filepath);
+
+        // Waits until all captured frames have been written.
+        void Flush();
+
+        // Gets the capture stats.
+        FrameCaptureStats GetStats() const;
+
+        // Checks if the frame capture instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Capture slot structure.
+        struct Slot
+        {
+            GLuint buffer;
+            std::size_t bufferSize;
+            GLsync fence;
+            uint64_t frame;
+
+            std::string filepath;
+            int width;
+            int height;
+        };
+
+        // Type declarations.
+        typedef std::vector<Slot> SlotList;
+        typedef std::vector<std::future<void>> TaskList;
+
+    private:
+        // Maps pixels of the oldest slot and hands them over to a worker.
+        // Returns false if the slot is not ready and waiting is not allowed.
+        bool ResolveSlot(bool wait);
+
+        // Destroys pixel buffers and pending fences.
+        void DestroyObjects();
+
+    private:
+        // Instance references.
+        RenderThread* m_renderThread;
+        System::ThreadPool* m_threadPool;
+
+        // Capture parameters.
+        FrameCaptureFormats m_format;
+
+        // Path of the requested capture.
+        // Accessed only by the main thread.
+        std::string m_request;
+
+        // Ring of capture slots.
+        // Accessed only by the render thread once initialized.
+        SlotList m_slots;
+        std::size_t m_firstPending;
+        std::size_t m_pendingCount;
+        uint64_t m_frameIndex;
+
+        // Number of recorded captures that have not been mapped yet.
+        std::atomic<int> m_inFlight;
+
+        // Encoding tasks of workers.
+        TaskList m_tasks;
+        std::mutex m_taskMutex;
+
+        // Capture stats.
+        unsigned int m_requested;
+        std::atomic<unsigned int> m_saved;
+        std::atomic<unsigned int> m_failed;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
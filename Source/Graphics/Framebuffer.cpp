@@ -0,0 +1,172 @@
+#include "Precompiled.hpp"
+#include "Framebuffer.hpp"
+#include "StateCache.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Invalid types.
+    const GLuint InvalidHandle = 0;
+}
+
+FramebufferInfo::FramebufferInfo() :
+    width(0),
+    height(0)
+{
+}
+
+Framebuffer::Framebuffer() :
+    m_handle(InvalidHandle),
+    m_colorTexture(InvalidHandle),
+    m_depthStencil(InvalidHandle),
+    m_width(0),
+    m_height(0)
+{
+}
+
+Framebuffer::~Framebuffer()
+{
+    this->DestroyHandles();
+}
+
+void Framebuffer::DestroyHandles()
+{
+    // Destroy the framebuffer handle.
+    if(m_handle != InvalidHandle)
+    {
+        glDeleteFramebuffers(1, &m_handle);
+        GetStateCache()->OnFramebufferDeleted(m_handle);
+        m_handle = InvalidHandle;
+    }
+
+    // Destroy attachment handles.
+    if(m_colorTexture != InvalidHandle)
+    {
+        glDeleteTextures(1, &m_colorTexture);
+        GetStateCache()->OnTextureDeleted(m_colorTexture);
+        m_colorTexture = InvalidHandle;
+    }
+
+    if(m_depthStencil != InvalidHandle)
+    {
+        glDeleteRenderbuffers(1, &m_depthStencil);
+        m_depthStencil = InvalidHandle;
+    }
+}
+
+bool Framebuffer::Create(const FramebufferInfo& info)
+{
+    Log() << "Creating framebuffer..." << LogIndent();
+
+    // Check if handle has been already created.
+    Verify(m_handle == InvalidHandle, "Framebuffer instance has been already initialized!");
+
+    // Setup a cleanup guard.
+    bool initialized = false;
+
+    // Validate arguments.
+    if(info.width <= 0)
+    {
+        LogError() << "Invalid argument - \"width\" is invalid.";
+        return false;
+    }
+
+    if(info.height <= 0)
+    {
+        LogError() << "Invalid argument - \"height\" is invalid.";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!initialized, this->DestroyHandles());
+
+    // Create a color texture.
+    glGenTextures(1, &m_colorTexture);
+
+    if(m_colorTexture == InvalidHandle)
+    {
+        LogError() << "Could not create a color texture!";
+        return false;
+    }
+
+    GetStateCache()->BindTexture(GL_TEXTURE_2D, m_colorTexture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    // Create a depth stencil renderbuffer.
+    glGenRenderbuffers(1, &m_depthStencil);
+
+    if(m_depthStencil == InvalidHandle)
+    {
+        LogError() << "Could not create a depth stencil renderbuffer!";
+        return false;
+    }
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, info.width, info.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // Create a framebuffer handle.
+    glGenFramebuffers(1, &m_handle);
+
+    if(m_handle == InvalidHandle)
+    {
+        LogError() << "Could not create a framebuffer!";
+        return false;
+    }
+
+    // Attach surfaces to the framebuffer.
+    GetStateCache()->BindFramebuffer(m_handle);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthStencil);
+
+    // Check if the framebuffer is complete.
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+    if(status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        LogError() << "Framebuffer is incomplete (status 0x" << std::hex << status << std::dec << ")!";
+        return false;
+    }
+
+    // Save framebuffer parameters.
+    m_width = info.width;
+    m_height = info.height;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return initialized = true;
+}
+
+GLuint Framebuffer::GetHandle() const
+{
+    Verify(m_handle != InvalidHandle, "Framebuffer handle has not been created!");
+
+    return m_handle;
+}
+
+GLuint Framebuffer::GetColorTexture() const
+{
+    Verify(m_handle != InvalidHandle, "Framebuffer handle has not been created!");
+
+    return m_colorTexture;
+}
+
+int Framebuffer::GetWidth() const
+{
+    return m_width;
+}
+
+int Framebuffer::GetHeight() const
+{
+    return m_height;
+}
+
+bool Framebuffer::IsValid() const
+{
+    return m_handle != InvalidHandle;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Framebuffer
+
+    Encapsulates an OpenGL framebuffer object with a color texture
+    and a depth stencil renderbuffer attached. Used for rendering
+    into an offscreen surface instead of the window's backbuffer.
+
+    void ExampleGraphicsFramebuffer()
+    {
+        // Describe framebuffer info.
+        Graphics::FramebufferInfo framebufferInfo;
+        framebufferInfo.width = 1920;
+        framebufferInfo.height = 1080;
+
+        // Create a framebuffer instance.
+        Graphics::Framebuffer framebuffer;
+        framebuffer.Create(framebufferInfo);
+
+        // Bind the framebuffer for drawing.
+        Graphics::GetStateCache()->BindFramebuffer(framebuffer.GetHandle());
+    }
+*/
+
+namespace Graphics
+{
+    // Framebuffer info structure.
+    struct FramebufferInfo
+    {
+        FramebufferInfo();
+
+        int width;
+        int height;
+    };
+
+    // Framebuffer class.
+    class Framebuffer : private NonCopyable
+    {
+    public:
+        Framebuffer();
+        ~Framebuffer();
+
+        // Creates the framebuffer instance.
+        bool Create(const FramebufferInfo& info);
+
+        // Gets the framebuffer's handle.
+        GLuint GetHandle() const;
+
+        // Gets the handle of the color texture.
+        GLuint GetColorTexture() const;
+
+        // Gets the framebuffer's width.
+        int GetWidth() const;
+
+        // Gets the framebuffer's height.
+        int GetHeight() const;
+
+        // Checks if the framebuffer instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Destroys internal handles.
+        void DestroyHandles();
+
+    private:
+        // Object handles.
+        GLuint m_handle;
+        GLuint m_colorTexture;
+        GLuint m_depthStencil;
+
+        // Framebuffer parameters.
+        int m_width;
+        int m_height;
+    };
+}
@@ -0,0 +1,264 @@
+#include "Precompiled.hpp"
+#include "GpuTimer.hpp"
+using namespace Graphics;
+
+GpuTimerInfo::GpuTimerInfo() :
+    frameLatency(3),
+    maxScopes(64)
+{
+}
+
+GpuTimer::GpuTimer() :
+    m_frameIndex(0),
+    m_frameActive(false),
+    m_droppedScopes(0),
+    m_maxScopes(0),
+    m_initialized(false)
+{
+}
+
+GpuTimer::~GpuTimer()
+{
+    this->DestroyQueries();
+}
+
+void GpuTimer::DestroyQueries()
+{
+    for(Frame& frame : m_frames)
+    {
+        if(!frame.queries.empty())
+        {
+            glDeleteQueries(frame.queries.size(), frame.queries.data());
+        }
+    }
+
+    m_frames.clear();
+}
+
+bool GpuTimer::Initialize(const GpuTimerInfo& info)
+{
+    Log() << "Initializing GPU timer..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "GPU timer instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.frameLatency <= 0)
+    {
+        LogError() << "Invalid argument - \"frameLatency\" is invalid!";
+        return false;
+    }
+
+    if(info.maxScopes <= 0)
+    {
+        LogError() << "Invalid argument - \"maxScopes\" is invalid!";
+        return false;
+    }
+
+    // Check if timer queries are supported.
+    if(!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query)
+    {
+        LogWarning() << "Timer queries are unavailable.";
+        return false;
+    }
+
+    // Some implementations report timestamps without any precision.
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+
+    if(counterBits == 0)
+    {
+        LogWarning() << "Timer queries are unavailable due to zero counter bits.";
+        return false;
+    }
+
+    // Create query objects for each frame.
+    SCOPE_GUARD_IF(!m_initialized, this->DestroyQueries());
+
+    m_frames.resize(info.frameLatency);
+
+    for(Frame& frame : m_frames)
+    {
+        frame.queries.resize(info.maxScopes * 2);
+        frame.scopes.reserve(info.maxScopes);
+        frame.queryCount = 0;
+        frame.droppedScopes = 0;
+
+        glGenQueries(frame.queries.size(), frame.queries.data());
+    }
+
+    m_maxScopes = info.maxScopes;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void GpuTimer::BeginFrame()
+{
+    if(!m_initialized)
+        return;
+
+    Assert(!m_frameActive, "Previous frame has not been ended!");
+
+    // Advance to the oldest frame in the ring.
+    m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+    Frame& frame = m_frames[m_frameIndex];
+
+    // Read back its results if the GPU has already finished it.
+    // Results that are not yet available are dropped instead of waiting for them.
+    if(!frame.scopes.empty())
+    {
+        this->ReadResults(frame);
+    }
+
+    // Reset the frame for new scopes.
+    frame.scopes.clear();
+    frame.queryCount = 0;
+    frame.droppedScopes = 0;
+
+    m_frameActive = true;
+}
+
+void GpuTimer::EndFrame()
+{
+    if(!m_initialized)
+        return;
+
+    Assert(m_frameActive, "Frame has not been started!");
+
+    m_frameActive = false;
+}
+
+int GpuTimer::BeginScope(const char* name)
+{
+    if(!m_initialized || !m_frameActive)
+        return InvalidScope;
+
+    Assert(name != nullptr, "Scope name is null!");
+
+    Frame& frame = m_frames[m_frameIndex];
+
+    // Drop scopes past the limit.
+    // Dropped scopes are counted, so incomplete results can be told apart.
+    if(frame.queryCount + 2 > (int)frame.queries.size())
+    {
+        frame.droppedScopes += 1;
+        return InvalidScope;
+    }
+
+    // Record the begin timestamp.
+    Scope scope;
+    scope.name = name;
+    scope.beginQuery = frame.queryCount++;
+    scope.endQuery = InvalidScope;
+
+    glQueryCounter(frame.queries[scope.beginQuery], GL_TIMESTAMP);
+
+    frame.scopes.push_back(scope);
+
+    return frame.scopes.size() - 1;
+}
+
+void GpuTimer::EndScope(int scopeIndex)
+{
+    if(!m_initialized || !m_frameActive || scopeIndex == InvalidScope)
+        return;
+
+    Frame& frame = m_frames[m_frameIndex];
+    Assert(scopeIndex < (int)frame.scopes.size(), "Invalid scope index!");
+
+    Scope& scope = frame.scopes[scopeIndex];
+    Assert(scope.endQuery == InvalidScope, "Scope has been already ended!");
+
+    // Record the end timestamp.
+    scope.endQuery = frame.queryCount++;
+
+    glQueryCounter(frame.queries[scope.endQuery], GL_TIMESTAMP);
+}
+
+bool GpuTimer::ReadResults(Frame& frame)
+{
+    // Check if the last query of the frame is available.
+    // Queries complete in order, so all previous ones are available too.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[frame.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if(available == GL_FALSE)
+        return false;
+
+    // Accumulate scope times by name.
+    m_results.clear();
+    m_droppedScopes = frame.droppedScopes;
+
+    for(const Scope& scope : frame.scopes)
+    {
+        // Skip scopes that have not been ended.
+        if(scope.endQuery == InvalidScope)
+            continue;
+
+        GLuint64 beginTime = 0;
+        GLuint64 endTime = 0;
+
+        glGetQueryObjectui64v(frame.queries[scope.beginQuery], GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(frame.queries[scope.endQuery], GL_QUERY_RESULT, &endTime);
+
+        float time = static_cast<float>((endTime - beginTime) / 1000000.0);
+
+        auto it = std::find_if(m_results.begin(), m_results.end(), [&scope](const Result& result)
+        {
+            return std::strcmp(result.name, scope.name) == 0;
+        });
+
+        if(it != m_results.end())
+        {
+            it->time += time;
+            it->count += 1;
+        }
+        else
+        {
+            Result result;
+            result.name = scope.name;
+            result.time = time;
+            result.count = 1;
+
+            m_results.push_back(result);
+        }
+    }
+
+    return true;
+}
+
+const GpuTimer::ResultList& GpuTimer::GetResults() const
+{
+    return m_results;
+}
+
+int GpuTimer::GetDroppedScopeCount() const
+{
+    return m_droppedScopes;
+}
+
+bool GpuTimer::IsAvailable() const
+{
+    return m_initialized;
+}
+
+/*
+    GPU Timer Scope
+*/
+
+GpuTimerScope::GpuTimerScope(GpuTimer* timer, const char* name) :
+    m_timer(timer),
+    m_scope(GpuTimer::InvalidScope)
+{
+    Assert(timer != nullptr, "GPU timer is null!");
+
+    m_scope = m_timer->BeginScope(name);
+}
+
+GpuTimerScope::~GpuTimerScope()
+{
+    m_timer->EndScope(m_scope);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics GPU Timer
+
+    Measures GPU time of named scopes using timestamp queries.
+    Queries are kept in a ring of frames and only read back once their
+    results are available, a few frames later, so the CPU never waits
+    on the GPU. Scopes are measured with pairs of timestamps instead of
+    elapsed time queries, because elapsed time queries cannot be nested.
+
+    void ExampleGraphicsGpuTimer()
+    {
+        // Create a GPU timer instance.
+        Graphics::GpuTimerInfo gpuTimerInfo;
+        gpuTimerInfo.frameLatency = 3;
+
+        Graphics::GpuTimer gpuTimer;
+        gpuTimer.Initialize(gpuTimerInfo);
+
+        // Measure scopes in a frame.
+        gpuTimer.BeginFrame();
+        {
+            Graphics::GpuTimerScope scope(&gpuTimer, "Frame");
+            basicRenderer.Clear(clearValues);
+        }
+        gpuTimer.EndFrame();
+
+        // Read results from a previous frame.
+        if(gpuTimer.IsAvailable())
+        {
+            for(const auto& result : gpuTimer.GetResults())
+            {
+                Log() << result.name << ": " << result.time << " ms";
+            }
+        }
+    }
+*/
+
+namespace Graphics
+{
+    // GPU timer info structure.
+    struct GpuTimerInfo
+    {
+        GpuTimerInfo();
+
+        int frameLatency;
+        int maxScopes;
+    };
+
+    // GPU timer class.
+    class GpuTimer
+    {
+    public:
+        // Scope result structure.
+        // Results of scopes with the same name are accumulated.
+        struct Result
+        {
+            const char* name;
+            float time;
+            int count;
+        };
+
+        // Type declarations.
+        typedef std::vector<Result> ResultList;
+
+        // Invalid scope index.
+        // Returned when a scope is not measured.
+        static const int InvalidScope = -1;
+
+    public:
+        GpuTimer();
+        ~GpuTimer();
+
+        // Initializes the GPU timer.
+        // Returns false if timer queries are not supported.
+        bool Initialize(const GpuTimerInfo& info);
+
+        // Begins a new frame and reads back results of an old one.
+        void BeginFrame();
+
+        // Ends the current frame.
+        void EndFrame();
+
+        // Begins a named scope.
+        // Name has to remain valid until results are read back.
+        int BeginScope(const char* name);
+
+        // Ends a scope.
+        void EndScope(int scope);
+
+        // Gets the results of the last frame that has been read back.
+        const ResultList& GetResults() const;
+
+        // Gets the number of scopes dropped past the limit in the last frame that has been read back.
+        int GetDroppedScopeCount() const;
+
+        // Checks if timer queries are available.
+        bool IsAvailable() const;
+
+    private:
+        // Scope structure.
+        struct Scope
+        {
+            const char* name;
+            int beginQuery;
+            int endQuery;
+        };
+
+        // Frame structure.
+        struct Frame
+        {
+            std::vector<GLuint> queries;
+            std::vector<Scope> scopes;
+            int queryCount;
+            int droppedScopes;
+        };
+
+    private:
+        // Reads back results of a frame if available.
+        bool ReadResults(Frame& frame);
+
+        // Destroys query objects.
+        void DestroyQueries();
+
+    private:
+        // Ring of frames.
+        std::vector<Frame> m_frames;
+        int m_frameIndex;
+        bool m_frameActive;
+
+        // Results of the last read frame.
+        ResultList m_results;
+        int m_droppedScopes;
+
+        // Maximum number of scopes per frame.
+        int m_maxScopes;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+
+    // GPU timer scope class.
+    // Measures the time until the end of a C++ scope.
+    class GpuTimerScope : private NonCopyable
+    {
+    public:
+        GpuTimerScope(GpuTimer* timer, const char* name);
+        ~GpuTimerScope();
+
+    private:
+        GpuTimer* m_timer;
+        int m_scope;
+    };
+}
@@ -0,0 +1,346 @@
+#include "Precompiled.hpp"
+#include "Image.hpp"
+using namespace Graphics;
+
+Image::Image() :
+    m_width(0),
+    m_height(0),
+    m_channels(0)
+{
+}
+
+Image::~Image()
+{
+}
+
+void Image::Reset()
+{
+    Utility::ClearContainer(m_data);
+
+    m_width = 0;
+    m_height = 0;
+    m_channels = 0;
+}
+
+namespace
+{
+    // Memory stream of an encoded file.
+    struct MemoryStream
+    {
+        const png_byte* data;
+        std::size_t size;
+        std::size_t offset;
+    };
+}
+
+bool Image::Load(std::string filepath)
+{
+    Log() << "Loading image from \"" << filepath << "\" file..." << LogIndent();
+
+    // Check if image has been already created.
+    Verify(!this->IsValid(), "Image instance has been already initialized!");
+
+    // Validate arguments.
+    if(filepath.empty())
+    {
+        LogError() << "Invalid argument - \"filepath\" is empty!";
+        return false;
+    }
+
+    // Read the whole file at once.
+    std::vector<char> content = Utility::GetBinaryFileContent(Build::GetWorkingDir() + filepath);
+
+    if(content.empty())
+    {
+        LogError() << "Could not read the file!";
+        return false;
+    }
+
+    // Decode the file content.
+    std::string error;
+
+    if(!this->Decode(content.data(), content.size(), &error))
+    {
+        LogError() << error;
+        return false;
+    }
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+bool Image::Decode(const void* data, std::size_t size, std::string* error)
+{
+    // Check if image has been already created.
+    Verify(!this->IsValid(), "Image instance has been already initialized!");
+
+    // Setup a cleanup guard.
+    bool initialized = false;
+
+    // Reports an error without logging it.
+    auto SetError = [error](const char* message)
+    {
+        if(error != nullptr)
+        {
+            *error = message;
+        }
+    };
+
+    // Validate the file header.
+    const size_t png_sig_size = 8;
+
+    if(data == nullptr || size < png_sig_size || png_sig_cmp((png_const_bytep)data, 0, png_sig_size) != 0)
+    {
+        SetError("Data does not contain a valid PNG file!");
+        return false;
+    }
+
+    // Create format decoder structures.
+    png_structp png_read_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+
+    if(png_read_ptr == nullptr)
+    {
+        SetError("Could not create PNG read structure!");
+        return false;
+    }
+
+    png_infop png_info_ptr = png_create_info_struct(png_read_ptr);
+
+    if(png_info_ptr == nullptr)
+    {
+        png_destroy_read_struct(&png_read_ptr, nullptr, nullptr);
+
+        SetError("Could not create PNG info structure!");
+        return false;
+    }
+
+    SCOPE_GUARD_BEGIN();
+    {
+        png_destroy_read_struct(&png_read_ptr, &png_info_ptr, nullptr);
+    }
+    SCOPE_GUARD_END();
+
+    // Declare memory read function.
+    // Reading past the end of data is reported as a decoding error.
+    MemoryStream stream = { (const png_byte*)data, size, png_sig_size };
+
+    auto png_read_function = [](png_structp png_ptr, png_bytep data, png_size_t length) -> void
+    {
+        MemoryStream* stream = (MemoryStream*)png_get_io_ptr(png_ptr);
+
+        if(length > stream->size - stream->offset)
+        {
+            png_error(png_ptr, "Unexpected end of data.");
+        }
+
+        std::memcpy(data, stream->data + stream->offset, length);
+        stream->offset += length;
+    };
+
+    // Declare image buffers.
+    // Pixel data is read directly into the image's storage.
+    std::vector<png_bytep> png_row_ptrs;
+
+    SCOPE_GUARD_IF(!initialized, this->Reset());
+
+    // Setup the error handling routine.
+    // Apparently a standard way of handling errors with libpng...
+    // Library jumps here if one of its functions encounters an error!!!
+    // This is the reason why scope guards and other objects are declared
+    // before this call. Be aware of how dangerous it is to do in C++.
+    // For e.g. objects created past this line will not have their
+    // destructors called if the library jumps back here on an error.
+    if(setjmp(png_jmpbuf(png_read_ptr)))
+    {
+        SetError("Error occurred while decoding the data!");
+        return false;
+    }
+
+    // Setup the memory read function.
+    png_set_read_fn(png_read_ptr, (png_voidp)&stream, png_read_function);
+
+    // Set the amount of already read signature bytes.
+    png_set_sig_bytes(png_read_ptr, png_sig_size);
+
+    // Read image info.
+    png_read_info(png_read_ptr, png_info_ptr);
+
+    png_uint_32 width = png_get_image_width(png_read_ptr, png_info_ptr);
+    png_uint_32 height = png_get_image_height(png_read_ptr, png_info_ptr);
+    png_uint_32 depth = png_get_bit_depth(png_read_ptr, png_info_ptr);
+    png_uint_32 channels = png_get_channels(png_read_ptr, png_info_ptr);
+    png_uint_32 format = png_get_color_type(png_read_ptr, png_info_ptr);
+
+    // Process different format types.
+    switch(format)
+    {
+    case PNG_COLOR_TYPE_GRAY:
+    case PNG_COLOR_TYPE_GRAY_ALPHA:
+        if(depth < 8)
+        {
+            // Convert gray scale image to single 8bit channel.
+            png_set_expand_gray_1_2_4_to_8(png_read_ptr);
+            depth = 8;
+        }
+        break;
+
+    case PNG_COLOR_TYPE_PALETTE:
+        {
+            // Convert indexed palette to RGB.
+            png_set_palette_to_rgb(png_read_ptr);
+            channels = 3;
+
+            // Create alpha channel if pallete has transparency.
+            if(png_get_valid(png_read_ptr, png_info_ptr, PNG_INFO_tRNS))
+            {
+                png_set_tRNS_to_alpha(png_read_ptr);
+                channels += 1;
+            }
+        }
+        break;
+
+    case PNG_COLOR_TYPE_RGB:
+    case PNG_COLOR_TYPE_RGBA:
+        break;
+
+    default:
+        SetError("Unsupported image format!");
+        return false;
+    }
+
+    // Make sure we only get 8bits per channel.
+    if(depth == 16)
+    {
+        png_set_strip_16(png_read_ptr);
+    }
+
+    if(depth != 8)
+    {
+        SetError("Unsupported image depth size!");
+        return false;
+    }
+
+    // Allocate image buffers.
+    png_row_ptrs.resize(height);
+    m_data.resize(width * height * channels);
+
+    png_byte* png_data_ptr = m_data.data();
+
+    // Setup an array of row pointers to the actual data buffer.
+    png_uint_32 png_stride = width * channels;
+
+    for(png_uint_32 i = 0; i < height; ++i)
+    {
+        // Reverse the order of rows to flip the image.
+        // This is done because OpenGL's texture coordinates are also flipped.
+        png_uint_32 png_row_index = height - i - 1;
+
+        // Assemble an array of row pointers.
+        png_uint_32 png_offset = i * png_stride;
+        png_row_ptrs[png_row_index] = png_data_ptr + png_offset;
+    }
+
+    // Read image data.
+    png_read_image(png_read_ptr, png_row_ptrs.data());
+
+    // Save image parameters.
+    m_width = (int)width;
+    m_height = (int)height;
+    m_channels = (int)channels;
+
+    return initialized = true;
+}
+
+bool Image::Create(int width, int height, int channels)
+{
+    Verify(!this->IsValid(), "Image instance has been already initialized!");
+
+    // Validate arguments.
+    if(width <= 0)
+    {
+        LogError() << "Invalid argument - \"width\" is invalid.";
+        return false;
+    }
+
+    if(height <= 0)
+    {
+        LogError() << "Invalid argument - \"height\" is invalid.";
+        return false;
+    }
+
+    if(channels < 1 || channels > 4)
+    {
+        LogError() << "Invalid argument - \"channels\" is invalid.";
+        return false;
+    }
+
+    // Allocate zeroed pixels.
+    m_data.assign(width * height * channels, 0);
+
+    // Save image parameters.
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+
+    return true;
+}
+
+uint8_t* Image::GetData()
+{
+    return m_data.data();
+}
+
+const uint8_t* Image::GetData() const
+{
+    return m_data.data();
+}
+
+const uint8_t* Image::GetPixel(int x, int y) const
+{
+    Verify(0 <= x && x < m_width, "Pixel x coordinate is out of range!");
+    Verify(0 <= y && y < m_height, "Pixel y coordinate is out of range!");
+
+    return m_data.data() + (y * m_width + x) * m_channels;
+}
+
+int Image::GetWidth() const
+{
+    return m_width;
+}
+
+int Image::GetHeight() const
+{
+    return m_height;
+}
+
+int Image::GetChannels() const
+{
+    return m_channels;
+}
+
+GLenum Image::GetFormat() const
+{
+    switch(m_channels)
+    {
+    case 1:
+        return GL_RED;
+
+    case 2:
+        return GL_RG;
+
+    case 3:
+        return GL_RGB;
+
+    case 4:
+        return GL_RGBA;
+    }
+
+    return GL_NONE;
+}
+
+bool Image::IsValid() const
+{
+    return !m_data.empty();
+}
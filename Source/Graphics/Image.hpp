@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Image
+
+    Holds pixel data of an image in system memory.
+    Can load images from PNG files. Rows are stored from the bottom
+    to the top of the image, matching OpenGL's texture coordinates.
+
+    void ExampleGraphicsImage()
+    {
+        // Load an image from file.
+        Graphics::Image image;
+        image.Load("image.png");
+
+        // Create a texture from image data.
+        Graphics::Texture texture;
+        texture.Create(image.GetWidth(), image.GetHeight(), image.GetFormat(), image.GetData());
+    }
+*/
+
+namespace Graphics
+{
+    // Image class.
+    class Image
+    {
+    public:
+        Image();
+        ~Image();
+
+        // Loads the image from a PNG file.
+        bool Load(std::string filepath);
+
+        // Decodes the image from PNG file data in memory.
+        // Does not log, so it can be called from worker threads.
+        bool Decode(const void* data, std::size_t size, std::string* error = nullptr);
+
+        // Creates an image with zeroed pixels.
+        bool Create(int width, int height, int channels);
+
+        // Gets the image's pixel data.
+        uint8_t* GetData();
+        const uint8_t* GetData() const;
+
+        // Gets a pointer to a pixel.
+        const uint8_t* GetPixel(int x, int y) const;
+
+        // Gets the image's width.
+        int GetWidth() const;
+
+        // Gets the image's height.
+        int GetHeight() const;
+
+        // Gets the number of channels per pixel.
+        int GetChannels() const;
+
+        // Gets the OpenGL format matching the channels.
+        GLenum GetFormat() const;
+
+        // Checks if the image instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Releases pixel data.
+        void Reset();
+
+    private:
+        // Pixel data.
+        std::vector<uint8_t> m_data;
+
+        // Image parameters.
+        int m_width;
+        int m_height;
+        int m_channels;
+    };
+}
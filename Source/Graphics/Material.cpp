@@ -0,0 +1,228 @@
+#include "Precompiled.hpp"
+#include "Material.hpp"
+#include "System/ResourceManager.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/Buffer.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Invalid types.
+    const uint32_t InvalidIdentifier = 0;
+
+    // Default shader of materials.
+    const char* SpriteShaderPath = "Data/Shaders/Sprite.glsl";
+
+    // Blend state structure.
+    struct BlendState
+    {
+        bool blend;
+        GLenum sourceFactor;
+        GLenum destinationFactor;
+        bool depthMask;
+    };
+
+    // Blend states of blend modes.
+    // Opaque mode keeps the alpha blend function, so switching from it only toggles blending.
+    const BlendState BlendStates[] =
+    {
+        { false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, true },  // Opaque
+        { true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, false },  // Alpha
+        { true, GL_SRC_ALPHA, GL_ONE, false },                  // Additive
+        { true, GL_ONE, GL_ONE_MINUS_SRC_ALPHA, false },        // Premultiplied
+    };
+
+    static_assert(sizeof(BlendStates) / sizeof(BlendState) == (std::size_t)BlendModes::Count, "Blend states do not match blend modes!");
+
+    // Identifier of the next created material.
+    // Materials are created on the main thread only.
+    uint32_t NextIdentifier = 1;
+}
+
+MaterialInfo::MaterialInfo() :
+    shader(nullptr),
+    texture(nullptr),
+    uniformBuffer(nullptr),
+    blendMode(BlendModes::Opaque),
+    textureFilter(GL_LINEAR),
+    textureWrap(GL_REPEAT)
+{
+}
+
+Material::PipelineState::PipelineState() :
+    program(0),
+    sampler(0),
+    uniformBuffer(0),
+    sourceFactor(GL_SRC_ALPHA),
+    destinationFactor(GL_ONE_MINUS_SRC_ALPHA),
+    blend(false),
+    depthMask(true)
+{
+}
+
+Material::Material() :
+    m_blendMode(BlendModes::Opaque),
+    m_identifier(InvalidIdentifier)
+{
+}
+
+Material::~Material()
+{
+}
+
+std::shared_ptr<const Material> Material::Create(System::ResourceManager* resourceManager, MaterialInfo info)
+{
+    Verify(resourceManager != nullptr, "Invalid argument - \"resourceManager\" is null!");
+
+    // Use the sprite shader by default.
+    if(info.shader == nullptr)
+    {
+        info.shader = resourceManager->Load<Shader>(SpriteShaderPath);
+    }
+
+    // Get a sampler shared by materials with the same filter and wrap modes.
+    SamplerInfo samplerInfo;
+    samplerInfo.textureWrapS = info.textureWrap;
+    samplerInfo.textureWrapT = info.textureWrap;
+    samplerInfo.textureWrapR = info.textureWrap;
+    samplerInfo.textureMinFilter = info.textureFilter;
+    samplerInfo.textureMagFilter = info.textureFilter;
+
+    SamplerPtr sampler = Sampler::Create(resourceManager, samplerInfo);
+
+    // Name the material after its state.
+    // Resources are referenced by the material, so their addresses cannot be reused while it exists.
+    std::ostringstream name;
+    name << "Material(" << info.shader.get() << ", " << info.texture.get() << ", " << info.uniformBuffer.get() << ", ";
+    name << (int)info.blendMode << ", " << info.textureFilter << ", " << info.textureWrap << ")";
+
+    // Load the material or get an existing one with the same name.
+    return resourceManager->Load<Material>(name.str(), info, sampler);
+}
+
+bool Material::Load(std::string name, const MaterialInfo& info, SamplerPtr sampler)
+{
+    Log() << "Creating \"" << name << "\" material..." << LogIndent();
+
+    // Check if material has been already created.
+    Verify(!this->IsValid(), "Material instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.shader == nullptr || !info.shader->IsValid())
+    {
+        LogError() << "Invalid argument - \"info.shader\" is invalid!";
+        return false;
+    }
+
+    if(info.blendMode < BlendModes::Opaque || info.blendMode >= BlendModes::Count)
+    {
+        LogError() << "Invalid argument - \"info.blendMode\" is invalid!";
+        return false;
+    }
+
+    // Bind uniform blocks of the shader.
+    // Texture unit uniform is left at its default unit zero, which is where the texture is bound.
+    if(!info.shader->BindUniformBlock(FrameConstantsBlock, FrameConstantsBinding))
+    {
+        LogError() << "Could not find the frame constants block in the shader!";
+        return false;
+    }
+
+    if(info.uniformBuffer != nullptr)
+    {
+        if(!info.uniformBuffer->IsValid())
+        {
+            LogError() << "Invalid argument - \"info.uniformBuffer\" is invalid!";
+            return false;
+        }
+
+        if(!info.shader->BindUniformBlock(MaterialConstantsBlock, MaterialConstantsBinding))
+        {
+            LogError() << "Could not find the material constants block in the shader!";
+            return false;
+        }
+    }
+
+    if(sampler == nullptr || !sampler->IsValid())
+    {
+        LogError() << "Invalid argument - \"sampler\" is invalid!";
+        return false;
+    }
+
+    // Resolve the pipeline state.
+    const BlendState& blendState = BlendStates[(int)info.blendMode];
+
+    m_state.program = info.shader->GetHandle();
+    m_state.sampler = sampler->GetHandle();
+    m_state.uniformBuffer = info.uniformBuffer != nullptr ? info.uniformBuffer->GetHandle() : 0;
+    m_state.sourceFactor = blendState.sourceFactor;
+    m_state.destinationFactor = blendState.destinationFactor;
+    m_state.blend = blendState.blend;
+    m_state.depthMask = blendState.depthMask;
+
+    // Save material resources.
+    m_shader = info.shader;
+    m_texture = info.texture;
+    m_uniformBuffer = info.uniformBuffer;
+    m_sampler = sampler;
+    m_blendMode = info.blendMode;
+
+    // Assign a stable identifier.
+    m_identifier = NextIdentifier++;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+const Material::PipelineState& Material::GetState() const
+{
+    return m_state;
+}
+
+GLuint Material::GetTextureHandle() const
+{
+    if(m_texture == nullptr)
+        return 0;
+
+    return m_texture->GetHandle();
+}
+
+glm::vec2 Material::GetTextureSizeInv() const
+{
+    if(m_texture == nullptr)
+        return glm::vec2(1.0f, 1.0f);
+
+    return glm::vec2(1.0f / m_texture->GetWidth(), 1.0f / m_texture->GetHeight());
+}
+
+const Material::ShaderPtr& Material::GetShader() const
+{
+    return m_shader;
+}
+
+const Material::TexturePtr& Material::GetTexture() const
+{
+    return m_texture;
+}
+
+BlendModes Material::GetBlendMode() const
+{
+    return m_blendMode;
+}
+
+uint32_t Material::GetIdentifier() const
+{
+    return m_identifier;
+}
+
+bool Material::IsTransparent() const
+{
+    return m_blendMode != BlendModes::Opaque;
+}
+
+bool Material::IsValid() const
+{
+    return m_identifier != InvalidIdentifier;
+}
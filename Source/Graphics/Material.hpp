@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Shader.hpp"
+#include "Sampler.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ResourceManager;
+}
+
+/*
+    Graphics Material
+
+    Immutable pipeline state shared by sprites - shader, blend mode,
+    sampler, texture and an optional uniform buffer. State is resolved
+    to handles and blend factors once when the material is created, so
+    the renderer only applies it when the material changes, without
+    branching on its parameters. Materials are created through the
+    resource manager, which returns an existing material if one with
+    the same state exists. Samplers are shared the same way between
+    materials with the same filter and wrap modes. Each material has
+    a stable identifier that is used as a sort and batch key.
+
+    void ExampleGraphicsMaterial(System::ResourceManager* resourceManager, std::shared_ptr<const Texture> texture)
+    {
+        // Describe material state.
+        Graphics::MaterialInfo materialInfo;
+        materialInfo.texture = texture;
+        materialInfo.blendMode = Graphics::BlendModes::Alpha;
+        materialInfo.textureFilter = GL_NEAREST;
+
+        // Create a material or get an existing one with the same state.
+        auto material = Graphics::Material::Create(resourceManager, materialInfo);
+
+        // Define a sprite drawn with the material.
+        Graphics::Sprite sprite;
+        sprite.info = Graphics::Sprite::Info(material.get());
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class Texture;
+    class UniformBuffer;
+
+    // Uniform blocks of sprite shaders and their buffer binding points.
+    constexpr UniformBlock FrameConstantsBlock("FrameConstants");
+    constexpr UniformBlock MaterialConstantsBlock("MaterialConstants");
+
+    const GLuint FrameConstantsBinding = 0;
+    const GLuint MaterialConstantsBinding = 1;
+
+    // Blend modes.
+    enum class BlendModes
+    {
+        // Blending disabled with depth writes.
+        Opaque,
+
+        // Blending without depth writes.
+        Alpha,
+        Additive,
+        Premultiplied,
+
+        Count,
+    };
+
+    // Material info structure.
+    struct MaterialInfo
+    {
+        MaterialInfo();
+
+        // Sprite shader is used if the shader is null.
+        std::shared_ptr<const Shader> shader;
+        std::shared_ptr<const Texture> texture;
+
+        // Bound to the material constants block of the shader if not null.
+        std::shared_ptr<const UniformBuffer> uniformBuffer;
+
+        BlendModes blendMode;
+        GLint textureFilter;
+        GLint textureWrap;
+    };
+
+    // Material class.
+    // Shared ownership can be recovered from sprites that only point to the material.
+    class Material : public std::enable_shared_from_this<Material>
+    {
+    public:
+        // Type declarations.
+        typedef std::shared_ptr<const Shader> ShaderPtr;
+        typedef std::shared_ptr<const Texture> TexturePtr;
+        typedef std::shared_ptr<const UniformBuffer> UniformBufferPtr;
+        typedef std::shared_ptr<const Sampler> SamplerPtr;
+
+        // Pipeline state structure.
+        // Resolved once on creation and applied as is by the renderer.
+        struct PipelineState
+        {
+            PipelineState();
+
+            GLuint program;
+            GLuint sampler;
+            GLuint uniformBuffer;
+            GLenum sourceFactor;
+            GLenum destinationFactor;
+            bool blend;
+            bool depthMask;
+        };
+
+    public:
+        Material();
+        ~Material();
+
+        // Creates a material through the resource manager.
+        // Returns an existing material if one with the same state has been created.
+        static std::shared_ptr<const Material> Create(System::ResourceManager* resourceManager, MaterialInfo info);
+
+        // Loads the material from state info and a sampler created for it.
+        // Called by the resource manager with the name of the material's state.
+        bool Load(std::string name, const MaterialInfo& info, SamplerPtr sampler);
+
+        // Gets the pipeline state.
+        const PipelineState& GetState() const;
+
+        // Gets the texture's handle.
+        // Resolved on each call, as pending textures stand in for their placeholders.
+        GLuint GetTextureHandle() const;
+
+        // Gets the inversed texture size.
+        glm::vec2 GetTextureSizeInv() const;
+
+        // Gets the shader.
+        const ShaderPtr& GetShader() const;
+
+        // Gets the texture.
+        const TexturePtr& GetTexture() const;
+
+        // Gets the blend mode.
+        BlendModes GetBlendMode() const;
+
+        // Gets the identifier.
+        // Identifiers are assigned in creation order and never reused.
+        uint32_t GetIdentifier() const;
+
+        // Checks if the material is transparent.
+        bool IsTransparent() const;
+
+        // Checks if the material is valid.
+        bool IsValid() const;
+
+    private:
+        // Material resources.
+        ShaderPtr m_shader;
+        TexturePtr m_texture;
+        UniformBufferPtr m_uniformBuffer;
+        SamplerPtr m_sampler;
+
+        // Resolved pipeline state.
+        PipelineState m_state;
+        BlendModes m_blendMode;
+
+        // Stable identifier.
+        uint32_t m_identifier;
+    };
+}
@@ -0,0 +1,361 @@
+#include "Precompiled.hpp"
+#include "RenderCommandList.hpp"
+#include "Graphics/StaticSpriteBuffer.hpp"
+#include "Graphics/Material.hpp"
+#include "Graphics/StateCache.hpp"
+#include "Graphics/FrameCapture.hpp"
+using namespace Graphics;
+
+RenderCommandList::RenderCommandList()
+{
+}
+
+RenderCommandList::~RenderCommandList()
+{
+}
+
+uint32_t RenderCommandList::AddTransform(const glm::mat4& transform)
+{
+    // Consecutive commands usually share the view transform.
+    if(m_transforms.empty() || m_transforms.back() != transform)
+    {
+        m_transforms.push_back(transform);
+    }
+
+    return (uint32_t)(m_transforms.size() - 1);
+}
+
+void RenderCommandList::RetainMaterial(const Material* material)
+{
+    Assert(material != nullptr, "Sprite material is null!");
+
+    // Consecutive sprites usually share the material.
+    if(m_materials.empty() || m_materials.back().get() != material)
+    {
+        m_materials.push_back(material->shared_from_this());
+    }
+}
+
+void RenderCommandList::BeginPass(const char* name)
+{
+    Verify(name != nullptr, "Invalid argument - \"name\" is null!");
+
+    Command command;
+    command.type = CommandTypes::BeginPass;
+    command.index = (uint32_t)m_passNames.size();
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_passNames.push_back(name);
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::EndPass()
+{
+    Command command;
+    command.type = CommandTypes::EndPass;
+    command.index = 0;
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::SetTarget(GLuint framebuffer, int width, int height)
+{
+    Target target;
+    target.framebuffer = framebuffer;
+    target.width = width;
+    target.height = height;
+    target.source = 0;
+    target.sourceWidth = 0;
+    target.sourceHeight = 0;
+
+    Command command;
+    command.type = CommandTypes::SetTarget;
+    command.index = (uint32_t)m_targets.size();
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_targets.push_back(target);
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::BlitTarget(GLuint source, int sourceWidth, int sourceHeight, GLuint framebuffer, int width, int height)
+{
+    Verify(source != framebuffer, "Invalid argument - \"source\" is the same as \"framebuffer\"!");
+
+    Target target;
+    target.framebuffer = framebuffer;
+    target.width = width;
+    target.height = height;
+    target.source = source;
+    target.sourceWidth = sourceWidth;
+    target.sourceHeight = sourceHeight;
+
+    Command command;
+    command.type = CommandTypes::BlitTarget;
+    command.index = (uint32_t)m_targets.size();
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_targets.push_back(target);
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::Clear(const ClearValues& values)
+{
+    Command command;
+    command.type = CommandTypes::Clear;
+    command.index = (uint32_t)m_clearValues.size();
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_clearValues.push_back(values);
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::DrawSprites(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const glm::mat4& transform)
+{
+    if(spriteCount == 0)
+        return;
+
+    Verify(spriteInfo != nullptr, "Invalid argument - \"spriteInfo\" is null!");
+    Verify(spriteData != nullptr, "Invalid argument - \"spriteData\" is null!");
+
+    // Copy sprites into the list.
+    // Info and data arrays are indexed separately, as instanced commands store a single info.
+    Command command;
+    command.type = CommandTypes::DrawSprites;
+    command.index = (uint32_t)m_spriteInfo.size();
+    command.first = (uint32_t)m_spriteData.size();
+    command.count = (uint32_t)spriteCount;
+    command.transform = this->AddTransform(transform);
+
+    m_spriteInfo.insert(m_spriteInfo.end(), spriteInfo, spriteInfo + spriteCount);
+    m_spriteData.insert(m_spriteData.end(), spriteData, spriteData + spriteCount);
+    m_commands.push_back(command);
+
+    // Retain materials, which are sorted so they change rarely between sprites.
+    for(std::size_t i = 0; i < spriteCount; ++i)
+    {
+        this->RetainMaterial(spriteInfo[i].material);
+    }
+}
+
+void RenderCommandList::DrawStaticSprites(const StaticSpriteBufferPtr& sprites, const std::size_t* batchIndices, std::size_t batchCount, const glm::mat4& transform)
+{
+    if(batchCount == 0)
+        return;
+
+    Verify(sprites != nullptr, "Invalid argument - \"sprites\" is null!");
+    Verify(batchIndices != nullptr, "Invalid argument - \"batchIndices\" is null!");
+
+    // Retain the buffer only once if it is drawn by consecutive commands.
+    if(m_staticSprites.empty() || m_staticSprites.back() != sprites)
+    {
+        m_staticSprites.push_back(sprites);
+    }
+
+    Command command;
+    command.type = CommandTypes::DrawStaticSprites;
+    command.index = (uint32_t)(m_staticSprites.size() - 1);
+    command.first = (uint32_t)m_batchIndices.size();
+    command.count = (uint32_t)batchCount;
+    command.transform = this->AddTransform(transform);
+
+    m_batchIndices.insert(m_batchIndices.end(), batchIndices, batchIndices + batchCount);
+    m_commands.push_back(command);
+
+    // Retain materials of drawn batches.
+    for(std::size_t i = 0; i < batchCount; ++i)
+    {
+        this->RetainMaterial(sprites->GetBatch(batchIndices[i]).info.material);
+    }
+}
+
+void RenderCommandList::DrawSpriteInstances(const Sprite::Info& info, const Sprite::Data* instances, std::size_t instanceCount, const glm::mat4& transform)
+{
+    if(instanceCount == 0)
+        return;
+
+    Verify(instances != nullptr, "Invalid argument - \"instances\" is null!");
+
+    // Shared info is stored once, at the index of the command.
+    Command command;
+    command.type = CommandTypes::DrawSpriteInstances;
+    command.index = (uint32_t)m_spriteInfo.size();
+    command.first = (uint32_t)m_spriteData.size();
+    command.count = (uint32_t)instanceCount;
+    command.transform = this->AddTransform(transform);
+
+    m_spriteInfo.push_back(info);
+    m_spriteData.insert(m_spriteData.end(), instances, instances + instanceCount);
+    m_commands.push_back(command);
+
+    this->RetainMaterial(info.material);
+}
+
+void RenderCommandList::DrawLines(const LineVertex* vertices, std::size_t vertexCount, const glm::mat4& transform)
+{
+    if(vertexCount == 0)
+        return;
+
+    Verify(vertices != nullptr, "Invalid argument - \"vertices\" is null!");
+
+    Command command;
+    command.type = CommandTypes::DrawLines;
+    command.index = 0;
+    command.first = (uint32_t)m_lineVertices.size();
+    command.count = (uint32_t)vertexCount;
+    command.transform = this->AddTransform(transform);
+
+    m_lineVertices.insert(m_lineVertices.end(), vertices, vertices + vertexCount);
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::CaptureFrame(FrameCapture* capture, GLuint framebuffer, int width, int height, const std::string& filepath)
+{
+    Verify(capture != nullptr, "Invalid argument - \"capture\" is null!");
+
+    Capture frameCapture;
+    frameCapture.capture = capture;
+    frameCapture.framebuffer = framebuffer;
+    frameCapture.width = width;
+    frameCapture.height = height;
+    frameCapture.filepath = filepath;
+
+    Command command;
+    command.type = CommandTypes::CaptureFrame;
+    command.index = (uint32_t)m_captures.size();
+    command.first = 0;
+    command.count = 0;
+    command.transform = 0;
+
+    m_captures.push_back(std::move(frameCapture));
+    m_commands.push_back(command);
+}
+
+void RenderCommandList::Execute(BasicRenderer& basicRenderer) const
+{
+    // Passes are timed as a whole, so timestamps are not issued for each draw.
+    GpuTimer& gpuTimer = basicRenderer.GetGpuTimer();
+    int passScope = GpuTimer::InvalidScope;
+
+    for(const Command& command : m_commands)
+    {
+        switch(command.type)
+        {
+        case CommandTypes::BeginPass:
+            Assert(passScope == GpuTimer::InvalidScope, "Previous pass has not been ended!");
+            passScope = gpuTimer.BeginScope(m_passNames[command.index]);
+            break;
+
+        case CommandTypes::EndPass:
+            gpuTimer.EndScope(passScope);
+            passScope = GpuTimer::InvalidScope;
+            break;
+
+        case CommandTypes::SetTarget:
+            {
+                const Target& target = m_targets[command.index];
+
+                GetStateCache()->BindFramebuffer(target.framebuffer);
+                glViewport(0, 0, target.width, target.height);
+            }
+            break;
+
+        case CommandTypes::BlitTarget:
+            {
+                const Target& target = m_targets[command.index];
+
+                // Bind the target for both reading and drawing first, so the state cache stays in sync.
+                GetStateCache()->BindFramebuffer(target.framebuffer);
+                glViewport(0, 0, target.width, target.height);
+
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, target.source);
+                glBlitFramebuffer(0, 0, target.sourceWidth, target.sourceHeight,
+                    0, 0, target.width, target.height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, target.framebuffer);
+            }
+            break;
+
+        case CommandTypes::Clear:
+            basicRenderer.Clear(m_clearValues[command.index]);
+            break;
+
+        case CommandTypes::DrawSprites:
+            basicRenderer.DrawSprites(&m_spriteInfo[command.index], &m_spriteData[command.first],
+                command.count, m_transforms[command.transform]);
+            break;
+
+        case CommandTypes::DrawStaticSprites:
+            basicRenderer.DrawStaticSprites(*m_staticSprites[command.index], &m_batchIndices[command.first],
+                command.count, m_transforms[command.transform]);
+            break;
+
+        case CommandTypes::DrawSpriteInstances:
+            basicRenderer.DrawSpriteInstances(m_spriteInfo[command.index], &m_spriteData[command.first],
+                command.count, m_transforms[command.transform]);
+            break;
+
+        case CommandTypes::DrawLines:
+            basicRenderer.DrawLines(&m_lineVertices[command.first], command.count, m_transforms[command.transform]);
+            break;
+
+        case CommandTypes::CaptureFrame:
+            {
+                const Capture& capture = m_captures[command.index];
+                capture.capture->Execute(capture.framebuffer, capture.width, capture.height, capture.filepath);
+            }
+            break;
+
+        default:
+            Assert(false, "Unknown render command type!");
+            break;
+        }
+    }
+
+    // End a pass that has been left open.
+    gpuTimer.EndScope(passScope);
+}
+
+void RenderCommandList::Reset()
+{
+    m_commands.clear();
+    m_targets.clear();
+    m_clearValues.clear();
+    m_transforms.clear();
+    m_spriteInfo.clear();
+    m_spriteData.clear();
+    m_batchIndices.clear();
+    m_staticSprites.clear();
+    m_materials.clear();
+    m_lineVertices.clear();
+    m_captures.clear();
+    m_passNames.clear();
+}
+
+std::size_t RenderCommandList::GetCommandCount() const
+{
+    return m_commands.size();
+}
+
+std::size_t RenderCommandList::GetMemoryUsage() const
+{
+    return m_commands.size() * sizeof(Command) +
+        m_targets.size() * sizeof(Target) +
+        m_clearValues.size() * sizeof(ClearValues) +
+        m_transforms.size() * sizeof(glm::mat4) +
+        m_spriteInfo.size() * sizeof(Sprite::Info) +
+        m_spriteData.size() * sizeof(Sprite::Data) +
+        m_batchIndices.size() * sizeof(std::size_t) +
+        m_lineVertices.size() * sizeof(LineVertex) +
+        m_captures.size() * sizeof(Capture) +
+        m_passNames.size() * sizeof(const char*);
+}
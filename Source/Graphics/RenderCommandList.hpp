@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Sprite.hpp"
+#include "BasicRenderer.hpp"
+
+/*
+    Graphics Render Command List
+
+    Records compact render commands that are executed later with a basic
+    renderer, possibly on another thread. Commands only hold offsets into
+    arrays owned by the list, so recording a frame does not allocate once
+    the arrays have grown. Sprite data is copied when recorded, while
+    static sprite buffers and materials of recorded sprites are retained
+    until the list is reset, so their owners can release or rebuild them
+    while the list is still executed.
+
+    void ExampleGraphicsRenderCommandList(Graphics::BasicRenderer& basicRenderer)
+    {
+        // Record commands.
+        Graphics::RenderCommandList commandList;
+        commandList.BeginPass("Scene");
+        commandList.SetTarget(0, 1024, 576);
+        commandList.Clear(clearValues);
+        commandList.DrawSprites(spriteInfo.data(), spriteData.data(), spriteInfo.size(), transform);
+        commandList.EndPass();
+
+        // Execute commands where the OpenGL context is current.
+        commandList.Execute(basicRenderer);
+        commandList.Reset();
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class StaticSpriteBuffer;
+    class FrameCapture;
+    class Material;
+
+    // Render command list class.
+    class RenderCommandList : private NonCopyable
+    {
+    public:
+        // Type declarations.
+        typedef std::shared_ptr<const StaticSpriteBuffer> StaticSpriteBufferPtr;
+        typedef std::shared_ptr<const Material> MaterialPtr;
+
+    public:
+        RenderCommandList();
+        ~RenderCommandList();
+
+        // Records the beginning of a named pass, which is measured by the renderer's GPU timer.
+        // Name has to be a string literal, as it is read back a few frames later.
+        void BeginPass(const char* name);
+
+        // Records the end of the current pass.
+        void EndPass();
+
+        // Records a binding of the render target and sets the viewport to its size.
+        // Zero framebuffer handle targets the window's backbuffer.
+        void SetTarget(GLuint framebuffer, int width, int height);
+
+        // Records a blit of a framebuffer's color that is stretched over the render target.
+        // Target is then bound for further drawing, with the viewport set to its size.
+        void BlitTarget(GLuint source, int sourceWidth, int sourceHeight, GLuint framebuffer, int width, int height);
+
+        // Records a clear of the render target.
+        void Clear(const ClearValues& values);
+
+        // Records a batch of sprites.
+        // Sprite data is copied into the list and their materials are retained until it is reset.
+        void DrawSprites(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const glm::mat4& transform);
+
+        // Records batches of a static sprite buffer.
+        // Buffer and materials of its batches are retained by the list until it is reset.
+        void DrawStaticSprites(const StaticSpriteBufferPtr& sprites, const std::size_t* batchIndices, std::size_t batchCount, const glm::mat4& transform);
+
+        // Records sprites sharing the same info that are drawn in a single call.
+        // Instance data is copied into the list and uploaded when executed.
+        // Material is retained until the list is reset.
+        void DrawSpriteInstances(const Sprite::Info& info, const Sprite::Data* instances, std::size_t instanceCount, const glm::mat4& transform);
+
+        // Records colored lines from pairs of vertices.
+        // Vertices are copied into the list.
+        void DrawLines(const LineVertex* vertices, std::size_t vertexCount, const glm::mat4& transform);
+
+        // Records a frame capture step that reads the render target if a path is given.
+        // Frame capture has to outlive the list's execution.
+        void CaptureFrame(FrameCapture* capture, GLuint framebuffer, int width, int height, const std::string& filepath);
+
+        // Executes recorded commands in order.
+        void Execute(BasicRenderer& basicRenderer) const;
+
+        // Removes recorded commands and releases retained buffers and materials.
+        // Allocated memory is kept for the next recording.
+        void Reset();
+
+        // Gets the number of recorded commands.
+        std::size_t GetCommandCount() const;
+
+        // Gets the number of bytes used by recorded commands and their data.
+        std::size_t GetMemoryUsage() const;
+
+    private:
+        // Command types.
+        struct CommandTypes
+        {
+            enum Type
+            {
+                Invalid,
+
+                BeginPass,
+                EndPass,
+                SetTarget,
+                BlitTarget,
+                Clear,
+                DrawSprites,
+                DrawStaticSprites,
+                DrawSpriteInstances,
+                DrawLines,
+                CaptureFrame,
+            };
+        };
+
+        // Command structure.
+        // Meaning of the index depends on the command type.
+        struct Command
+        {
+            CommandTypes::Type type;
+            uint32_t index;
+            uint32_t first;
+            uint32_t count;
+            uint32_t transform;
+        };
+
+        // Render target structure.
+        // Blits read from the source framebuffer of the given size.
+        struct Target
+        {
+            GLuint framebuffer;
+            int width;
+            int height;
+
+            GLuint source;
+            int sourceWidth;
+            int sourceHeight;
+        };
+
+        // Frame capture structure.
+        struct Capture
+        {
+            FrameCapture* capture;
+            GLuint framebuffer;
+            int width;
+            int height;
+            std::string filepath;
+        };
+
+        // Type declarations.
+        typedef std::vector<Command> CommandList;
+        typedef std::vector<Target> TargetList;
+        typedef std::vector<ClearValues> ClearValuesList;
+        typedef std::vector<glm::mat4> TransformList;
+        typedef std::vector<Sprite::Info> SpriteInfoList;
+        typedef std::vector<Sprite::Data> SpriteDataList;
+        typedef std::vector<std::size_t> BatchIndexList;
+        typedef std::vector<StaticSpriteBufferPtr> StaticSpriteBufferList;
+        typedef std::vector<MaterialPtr> MaterialList;
+        typedef std::vector<LineVertex> LineVertexList;
+        typedef std::vector<Capture> CaptureList;
+        typedef std::vector<const char*> PassNameList;
+
+    private:
+        // Adds a transform, reusing the last one if equal.
+        uint32_t AddTransform(const glm::mat4& transform);
+
+        // Retains a material, skipping it if it was the last one retained.
+        void RetainMaterial(const Material* material);
+
+    private:
+        // Recorded commands.
+        CommandList m_commands;
+
+        // Command data.
+        TargetList m_targets;
+        ClearValuesList m_clearValues;
+        TransformList m_transforms;
+        SpriteInfoList m_spriteInfo;
+        SpriteDataList m_spriteData;
+        BatchIndexList m_batchIndices;
+        StaticSpriteBufferList m_staticSprites;
+        MaterialList m_materials;
+        LineVertexList m_lineVertices;
+        CaptureList m_captures;
+        PassNameList m_passNames;
+    };
+}
@@ -0,0 +1,349 @@
+#include "Precompiled.hpp"
+#include "RenderThread.hpp"
+#include "Graphics/StateCache.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Calculates elapsed time in milliseconds.
+    float CalculateElapsedTime(uint64_t startTime)
+    {
+        uint64_t elapsedTime = glfwGetTimerValue() - startTime;
+        return static_cast<float>(elapsedTime * (1000.0 / glfwGetTimerFrequency()));
+    }
+}
+
+RenderThreadInfo::RenderThreadInfo() :
+    window(nullptr),
+    basicRenderer(nullptr),
+    threaded(true)
+{
+}
+
+RenderThreadStats::RenderThreadStats() :
+    commandCount(0),
+    commandBytes(0),
+    queueDepth(0),
+    stallTime(0.0f),
+    executeTime(0.0f),
+    presentTime(0.0f),
+    stateCallsIssued(0),
+    stateCallsSkipped(0),
+    gpuTimesAvailable(false),
+    gpuScopesDropped(0)
+{
+}
+
+RenderThread::RenderThread() :
+    m_window(nullptr),
+    m_basicRenderer(nullptr),
+    m_fences{ nullptr, nullptr },
+    m_recordIndex(0),
+    m_busy(false),
+    m_stop(false),
+    m_threaded(false),
+    m_initialized(false)
+{
+}
+
+RenderThread::~RenderThread()
+{
+    this->DestroyThread();
+}
+
+void RenderThread::DestroyThread()
+{
+    if(!m_thread.joinable())
+        return;
+
+    // Signal the render thread to exit after finishing its work.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        this->WaitIdle(lock);
+
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+
+    // Wait for the render thread to release the window's context.
+    m_thread.join();
+    m_stop = false;
+
+    // Take the window's context back, so shared objects destroyed afterwards are deleted with a live context.
+    m_window->MakeContextCurrent();
+}
+
+bool RenderThread::Initialize(const RenderThreadInfo& info)
+{
+    Log() << "Initializing render thread..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Render thread instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.window == nullptr)
+    {
+        LogError() << "Invalid argument - \"window\" is null!";
+        return false;
+    }
+
+    if(info.basicRenderer == nullptr)
+    {
+        LogError() << "Invalid argument - \"basicRenderer\" is null!";
+        return false;
+    }
+
+    m_window = info.window;
+    m_basicRenderer = info.basicRenderer;
+
+    if(info.threaded)
+    {
+        // Open a hidden window with a context shared with the main window.
+        // Opening it makes its context current on the main thread in place of the window's one.
+        System::WindowInfo loaderContextInfo;
+        loaderContextInfo.title = "Loader";
+        loaderContextInfo.width = 1;
+        loaderContextInfo.height = 1;
+        loaderContextInfo.vsync = false;
+        loaderContextInfo.visible = false;
+        loaderContextInfo.shareContext = m_window;
+
+        if(!m_loaderContext.Open(loaderContextInfo))
+        {
+            LogError() << "Could not open a window with a shared context!";
+            return false;
+        }
+
+        // Start the render thread.
+        m_thread = std::thread(&RenderThread::ThreadMain, this);
+
+        LogInfo() << "Commands are executed on a separate thread.";
+    }
+    else
+    {
+        LogInfo() << "Commands are executed on the main thread.";
+    }
+
+    m_threaded = info.threaded;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void RenderThread::ThreadMain()
+{
+    // Take over the window's context.
+    m_window->MakeContextCurrent();
+
+    while(true)
+    {
+        Task task;
+
+        // Wait for a task or a stop request.
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]()
+            {
+                return m_stop || m_task != nullptr;
+            });
+
+            if(m_task == nullptr)
+                break;
+
+            task = std::move(m_task);
+            m_task = nullptr;
+        }
+
+        // Execute the task and signal that the thread is idle.
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy = false;
+        }
+
+        m_condition.notify_all();
+    }
+
+    // Release the context, so the window can be destroyed.
+    m_window->ReleaseContext();
+}
+
+void RenderThread::WaitIdle(std::unique_lock<std::mutex>& lock)
+{
+    m_condition.wait(lock, [this]()
+    {
+        return !m_busy;
+    });
+}
+
+void RenderThread::Invoke(const Task& task)
+{
+    Verify(m_initialized, "Render thread has not been initialized!");
+
+    // Call the task directly if the context is current on this thread.
+    if(!m_threaded)
+    {
+        task();
+        return;
+    }
+
+    // Hand the task over to the render thread and wait for it.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    this->WaitIdle(lock);
+
+    m_task = task;
+    m_busy = true;
+
+    m_condition.notify_all();
+
+    this->WaitIdle(lock);
+}
+
+RenderCommandList& RenderThread::GetCommandList()
+{
+    Verify(m_initialized, "Render thread has not been initialized!");
+
+    return m_commandLists[m_recordIndex];
+}
+
+void RenderThread::Submit()
+{
+    Verify(m_initialized, "Render thread has not been initialized!");
+
+    const int listIndex = m_recordIndex;
+    const RenderCommandList& commandList = m_commandLists[listIndex];
+
+    // Execute the frame right away if not threaded.
+    if(!m_threaded)
+    {
+        m_stats.commandCount = commandList.GetCommandCount();
+        m_stats.commandBytes = commandList.GetMemoryUsage();
+
+        this->ExecuteFrame(listIndex);
+
+        m_commandLists[listIndex].Reset();
+        return;
+    }
+
+    // Insert a fence after objects uploaded with the shared context.
+    // Flush is needed for the fence to be signaled at all.
+    m_fences[listIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    // Wait for the previous frame and hand over the recorded one.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        unsigned int queueDepth = m_busy ? 1 : 0;
+        uint64_t stallStart = glfwGetTimerValue();
+
+        this->WaitIdle(lock);
+
+        m_stats.commandCount = commandList.GetCommandCount();
+        m_stats.commandBytes = commandList.GetMemoryUsage();
+        m_stats.queueDepth = queueDepth;
+        m_stats.stallTime = CalculateElapsedTime(stallStart);
+
+        m_task = [this, listIndex]()
+        {
+            this->ExecuteFrame(listIndex);
+        };
+
+        m_busy = true;
+    }
+
+    m_condition.notify_all();
+
+    // Record the next frame into the other list.
+    // Render thread has finished executing it, so its retained buffers can be released.
+    m_recordIndex = 1 - listIndex;
+    m_commandLists[m_recordIndex].Reset();
+}
+
+void RenderThread::ExecuteFrame(int listIndex)
+{
+    const RenderCommandList& commandList = m_commandLists[listIndex];
+    StateCache* stateCache = GetStateCache();
+
+    if(m_threaded)
+    {
+        // Make the GPU wait for uploads of the main thread.
+        GLsync& fence = m_fences[listIndex];
+
+        if(fence != nullptr)
+        {
+            glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        // Objects may have been deleted by the shared context and their handles reused.
+        stateCache->Reset();
+    }
+
+    // Reset renderer counters.
+    m_basicRenderer->ResetStats();
+    stateCache->ResetCounters();
+
+    // Execute commands.
+    uint64_t executeStart = glfwGetTimerValue();
+
+    GpuTimer& gpuTimer = m_basicRenderer->GetGpuTimer();
+    gpuTimer.BeginFrame();
+
+    {
+        GpuTimerScope gpuFrameScope(&gpuTimer, "Frame");
+        commandList.Execute(*m_basicRenderer);
+    }
+
+    gpuTimer.EndFrame();
+
+    float executeTime = CalculateElapsedTime(executeStart);
+
+    // Present the frame.
+    // Presenting can block until the vertical blank.
+    uint64_t presentStart = glfwGetTimerValue();
+
+    m_window->Present();
+
+    float presentTime = CalculateElapsedTime(presentStart);
+
+    // Publish frame stats.
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stats.executeTime = executeTime;
+    m_stats.presentTime = presentTime;
+    m_stats.renderer = m_basicRenderer->GetStats();
+    m_stats.stateCallsIssued = stateCache->GetIssuedCalls();
+    m_stats.stateCallsSkipped = stateCache->GetSkippedCalls();
+    m_stats.gpuTimesAvailable = gpuTimer.IsAvailable();
+    m_stats.gpuTimes = gpuTimer.GetResults();
+    m_stats.gpuScopesDropped = gpuTimer.GetDroppedScopeCount();
+}
+
+void RenderThread::Flush()
+{
+    Verify(m_initialized, "Render thread has not been initialized!");
+
+    if(!m_threaded)
+        return;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    this->WaitIdle(lock);
+}
+
+RenderThreadStats RenderThread::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+bool RenderThread::IsThreaded() const
+{
+    return m_threaded;
+}
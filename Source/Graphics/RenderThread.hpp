@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "System/Window.hpp"
+#include "RenderCommandList.hpp"
+#include "BasicRenderer.hpp"
+#include "GpuTimer.hpp"
+
+/*
+    Graphics Render Thread
+
+    Executes render command lists on a dedicated thread that owns the
+    window's OpenGL context. Command lists are double buffered, so the
+    main thread records the next frame while the previous one is being
+    submitted to the driver and presented. Main thread keeps a hidden
+    window with a shared context, so resources can still be created and
+    uploaded there. Objects that cannot be shared between contexts, such
+    as vertex arrays and framebuffers, have to be created and destroyed
+    with Invoke(). Once the render thread stops, the window's context is
+    made current on the calling thread again.
+
+    Commands can also be executed inline on the main thread, in which
+    case the window's context stays current there.
+
+    void ExampleGraphicsRenderThread(System::Window& window)
+    {
+        // Start the render thread.
+        Graphics::RenderThreadInfo renderThreadInfo;
+        renderThreadInfo.window = &window;
+        renderThreadInfo.basicRenderer = &basicRenderer;
+        renderThreadInfo.threaded = true;
+
+        Graphics::RenderThread renderThread;
+        renderThread.Initialize(renderThreadInfo);
+
+        // Create objects bound to the window's context.
+        renderThread.Invoke([&]()
+        {
+            basicRenderer.Initialize(basicRendererInfo);
+        });
+
+        // Record and submit a frame.
+        renderThread.GetCommandList().Clear(clearValues);
+        renderThread.Submit();
+    }
+*/
+
+namespace Graphics
+{
+    // Render thread info structure.
+    struct RenderThreadInfo
+    {
+        RenderThreadInfo();
+
+        System::Window* window;
+        BasicRenderer* basicRenderer;
+
+        // Executes commands on a separate thread if true.
+        bool threaded;
+    };
+
+    // Render thread stats structure.
+    struct RenderThreadStats
+    {
+        RenderThreadStats();
+
+        // Recorded command list.
+        std::size_t commandCount;
+        std::size_t commandBytes;
+
+        // Number of frames still executing when the last frame was submitted.
+        unsigned int queueDepth;
+
+        // Time in milliseconds the main thread waited for the render thread.
+        float stallTime;
+
+        // Time in milliseconds spent executing commands and presenting.
+        float executeTime;
+        float presentTime;
+
+        // Renderer counters of the last executed frame.
+        BasicRendererStats renderer;
+        unsigned int stateCallsIssued;
+        unsigned int stateCallsSkipped;
+
+        // GPU timings of a previous frame.
+        // Scopes past the timer's limit are dropped from the timings.
+        bool gpuTimesAvailable;
+        GpuTimer::ResultList gpuTimes;
+        unsigned int gpuScopesDropped;
+    };
+
+    // Render thread class.
+    class RenderThread : private NonCopyable
+    {
+    public:
+        // Type declarations.
+        typedef std::function<void()> Task;
+
+    public:
+        RenderThread();
+        ~RenderThread();
+
+        // Initializes the render thread.
+        bool Initialize(const RenderThreadInfo& info);
+
+        // Calls a function where the window's context is current and waits for it.
+        void Invoke(const Task& task);
+
+        // Gets the command list for recording the current frame.
+        RenderCommandList& GetCommandList();
+
+        // Submits the recorded frame for execution and presentation.
+        // Waits until the previous frame has finished executing.
+        void Submit();
+
+        // Waits until all submitted frames have finished executing.
+        void Flush();
+
+        // Gets the stats of the last executed frame.
+        // Stats are copied, as they are written by the render thread.
+        RenderThreadStats GetStats() const;
+
+        // Checks if commands are executed on a separate thread.
+        bool IsThreaded() const;
+
+    private:
+        // Runs the loop of the render thread.
+        void ThreadMain();
+
+        // Executes a command list and presents the frame.
+        void ExecuteFrame(int listIndex);
+
+        // Waits until the render thread becomes idle.
+        // Has to be called with the mutex locked.
+        void WaitIdle(std::unique_lock<std::mutex>& lock);
+
+        // Stops and joins the render thread.
+        // Makes the window's context current on the calling thread.
+        void DestroyThread();
+
+    private:
+        // Instance references.
+        System::Window* m_window;
+        BasicRenderer* m_basicRenderer;
+
+        // Shared context of the main thread.
+        System::Window m_loaderContext;
+
+        // Double buffered command lists.
+        // Fences make objects uploaded with the shared context visible before execution.
+        RenderCommandList m_commandLists[2];
+        GLsync m_fences[2];
+        int m_recordIndex;
+
+        // Render thread state.
+        std::thread m_thread;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        Task m_task;
+        bool m_busy;
+        bool m_stop;
+
+        // Frame stats.
+        RenderThreadStats m_stats;
+
+        // Initialization state.
+        bool m_threaded;
+        bool m_initialized;
+    };
+}
@@ -0,0 +1,154 @@
+#include "Precompiled.hpp"
+#include "ResolutionScaler.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Weight of a new frame time in the moving average.
+    const float SmoothingFactor = 0.1f;
+
+    // Number of frames measured before the scale can change again.
+    const int SettleFrameCount = 8;
+
+    // Frame time ratios of the target that trigger a change.
+    const float DecreaseThreshold = 1.0f;
+    const float IncreaseThreshold = 0.85f;
+
+    // Limits of a single change.
+    const float MaxDecreaseStep = 0.15f;
+    const float IncreaseStep = 0.05f;
+    const float MinScaleChange = 0.01f;
+}
+
+ResolutionScalerInfo::ResolutionScalerInfo() :
+    targetFrameTime(16.6f),
+    minScale(0.5f),
+    maxScale(1.0f)
+{
+}
+
+ResolutionScaler::ResolutionScaler() :
+    m_targetFrameTime(0.0f),
+    m_minScale(1.0f),
+    m_maxScale(1.0f),
+    m_scale(1.0f),
+    m_averageTime(0.0f),
+    m_sampleCount(0),
+    m_settleFrames(0),
+    m_initialized(false)
+{
+}
+
+ResolutionScaler::~ResolutionScaler()
+{
+}
+
+bool ResolutionScaler::Initialize(const ResolutionScalerInfo& info)
+{
+    Log() << "Initializing resolution scaler..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Resolution scaler instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.targetFrameTime <= 0.0f)
+    {
+        LogError() << "Invalid argument - \"targetFrameTime\" is invalid!";
+        return false;
+    }
+
+    if(info.minScale <= 0.0f || info.minScale > info.maxScale)
+    {
+        LogError() << "Invalid argument - \"minScale\" is invalid!";
+        return false;
+    }
+
+    if(info.maxScale > 1.0f)
+    {
+        LogError() << "Invalid argument - \"maxScale\" is invalid!";
+        return false;
+    }
+
+    // Save scaler parameters.
+    // Scale starts at the maximum and drops once frames are measured.
+    m_targetFrameTime = info.targetFrameTime;
+    m_minScale = info.minScale;
+    m_maxScale = info.maxScale;
+    m_scale = info.maxScale;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void ResolutionScaler::Update(float frameTime)
+{
+    if(!m_initialized)
+        return;
+
+    if(frameTime <= 0.0f)
+        return;
+
+    // Skip frames that may have been measured at the previous scale.
+    if(m_settleFrames > 0)
+    {
+        --m_settleFrames;
+        return;
+    }
+
+    // Smooth out frame time spikes.
+    if(m_sampleCount == 0)
+    {
+        m_averageTime = frameTime;
+    }
+    else
+    {
+        m_averageTime += (frameTime - m_averageTime) * SmoothingFactor;
+    }
+
+    ++m_sampleCount;
+
+    // Calculate a new scale.
+    float scale = m_scale;
+
+    if(m_averageTime > m_targetFrameTime * DecreaseThreshold)
+    {
+        // Fill rate bound frame time is proportional to the pixel count, which grows with the square of the scale.
+        scale = m_scale * std::sqrt(m_targetFrameTime / m_averageTime);
+        scale = std::max(scale, m_scale - MaxDecreaseStep);
+    }
+    else if(m_averageTime < m_targetFrameTime * IncreaseThreshold)
+    {
+        scale = m_scale + IncreaseStep;
+    }
+
+    scale = glm::clamp(scale, m_minScale, m_maxScale);
+
+    // Apply the scale and measure it anew.
+    // Tiny changes are ignored, unless they reach the end of the range.
+    if(scale == m_scale)
+        return;
+
+    if(std::abs(scale - m_scale) < MinScaleChange && scale != m_minScale && scale != m_maxScale)
+        return;
+
+    m_scale = scale;
+    m_sampleCount = 0;
+    m_settleFrames = SettleFrameCount;
+}
+
+int ResolutionScaler::CalculateSize(int size) const
+{
+    return std::max((int)(size * m_scale + 0.5f), 1);
+}
+
+float ResolutionScaler::GetScale() const
+{
+    return m_scale;
+}
+
+bool ResolutionScaler::IsValid() const
+{
+    return m_initialized;
+}
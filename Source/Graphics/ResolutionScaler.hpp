@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Resolution Scaler
+
+    Adjusts the resolution scale of the scene from measured frame times.
+    Scale is lowered when frames take longer than the target time, by an
+    amount estimated from fill rate bound frames, whose time grows with
+    the number of pixels. Scale is raised slowly once frames leave enough
+    headroom. After each change a few frames are skipped, as GPU timings
+    are read back with a delay.
+
+    void ExampleGraphicsResolutionScaler()
+    {
+        // Create a resolution scaler instance.
+        Graphics::ResolutionScalerInfo resolutionScalerInfo;
+        resolutionScalerInfo.targetFrameTime = 16.6f;
+        resolutionScalerInfo.minScale = 0.5f;
+
+        Graphics::ResolutionScaler resolutionScaler;
+        resolutionScaler.Initialize(resolutionScalerInfo);
+
+        // Feed the scaler with frame times.
+        resolutionScaler.Update(frameTime);
+
+        // Calculate the scaled size of the scene.
+        int sceneWidth = resolutionScaler.CalculateSize(targetWidth);
+    }
+*/
+
+namespace Graphics
+{
+    // Resolution scaler info structure.
+    struct ResolutionScalerInfo
+    {
+        ResolutionScalerInfo();
+
+        // Target frame time in milliseconds.
+        float targetFrameTime;
+
+        // Range of the resolution scale.
+        float minScale;
+        float maxScale;
+    };
+
+    // Resolution scaler class.
+    class ResolutionScaler
+    {
+    public:
+        ResolutionScaler();
+        ~ResolutionScaler();
+
+        // Initializes the resolution scaler.
+        bool Initialize(const ResolutionScalerInfo& info);
+
+        // Updates the scale with a measured frame time in milliseconds.
+        void Update(float frameTime);
+
+        // Calculates a scaled size, which is never smaller than a pixel.
+        int CalculateSize(int size) const;
+
+        // Gets the current resolution scale.
+        float GetScale() const;
+
+        // Checks if the resolution scaler instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Scaler parameters.
+        float m_targetFrameTime;
+        float m_minScale;
+        float m_maxScale;
+
+        // Scaler state.
+        float m_scale;
+        float m_averageTime;
+        int m_sampleCount;
+        int m_settleFrames;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
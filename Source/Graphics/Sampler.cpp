@@ -1,5 +1,7 @@
 #include "Precompiled.hpp"
 #include "Sampler.hpp"
+#include "StateCache.hpp"
+#include "System/ResourceManager.hpp"
 using namespace Graphics;
 
 namespace
@@ -38,10 +40,34 @@ void Sampler::DestroyHandle()
     if(m_handle != InvalidHandle)
     {
         glDeleteSamplers(1, &m_handle);
+        GetStateCache()->OnSamplerDeleted(m_handle);
         m_handle = InvalidHandle;
     }
 }
 
+std::shared_ptr<const Sampler> Sampler::Create(System::ResourceManager* resourceManager, const SamplerInfo& info)
+{
+    Verify(resourceManager != nullptr, "Invalid argument - \"resourceManager\" is null!");
+
+    // Name the sampler after its state.
+    std::ostringstream name;
+    name << "Sampler(" << info.textureWrapS << ", " << info.textureWrapT << ", " << info.textureWrapR << ", ";
+    name << info.textureMinFilter << ", " << info.textureMagFilter << ", ";
+    name << info.textureCompareMode << ", " << info.textureCompareFunc << ", ";
+    name << info.textureMinLOD << ", " << info.textureMaxLOD << ", ";
+    name << info.textureBorderColor.r << ", " << info.textureBorderColor.g << ", ";
+    name << info.textureBorderColor.b << ", " << info.textureBorderColor.a << ")";
+
+    // Load the sampler or get an existing one with the same name.
+    return resourceManager->Load<Sampler>(name.str(), info);
+}
+
+bool Sampler::Load(std::string, const SamplerInfo& info)
+{
+    // Sampler state is fully described by its info.
+    return this->Create(info);
+}
+
 bool Sampler::Create(const SamplerInfo& info)
 {
     Log() << "Creating sampler..." << LogIndent();
@@ -2,10 +2,17 @@
 
 #include "Precompiled.hpp"
 
+// Forward declarations.
+namespace System
+{
+    class ResourceManager;
+}
+
 /*
     Graphics Sampler
     
     Encapsulates an OpenGL sampler object that defines texture sampling and filtering properties.
+    Samplers created through the resource manager are shared by all users of the same state.
     
     void ExampleGraphicsSampler()
     {
@@ -55,9 +62,17 @@ namespace Graphics
         Sampler();
         ~Sampler();
 
+        // Creates a sampler through the resource manager.
+        // Returns an existing sampler if one with the same state has been created.
+        static std::shared_ptr<const Sampler> Create(System::ResourceManager* resourceManager, const SamplerInfo& info);
+
         // Initializes the sampler object.
         bool Create(const SamplerInfo& info);
 
+        // Loads the sampler from state info.
+        // Called by the resource manager with the name of the sampler's state.
+        bool Load(std::string name, const SamplerInfo& info);
+
         // Sets the sampler's parameter.
         void SetParameter(GLenum parameter, GLint value);
 
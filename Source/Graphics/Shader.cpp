@@ -1,5 +1,6 @@
 #include "Precompiled.hpp"
 #include "Graphics/Shader.hpp"
+#include "Graphics/StateCache.hpp"
 using namespace Graphics;
 
 namespace
@@ -23,6 +24,52 @@ namespace
         { "GEOMETRY_SHADER", GL_GEOMETRY_SHADER },
         { "FRAGMENT_SHADER", GL_FRAGMENT_SHADER },
     };
+
+    // Program binary file header.
+    struct BinaryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    const uint32_t BinaryMagic = 0x42485347; // "GSHB"
+    const uint32_t BinaryVersion = 1;
+
+    // Calculates a 64-bit FNV-1a hash of a string.
+    uint64_t CalculateBinaryKey(const std::string& text)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        for(char character : text)
+        {
+            hash ^= (uint8_t)character;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // Gets a string from the driver.
+    std::string GetDriverString(GLenum name)
+    {
+        const GLubyte* string = glGetString(name);
+        return string != nullptr ? (const char*)string : "";
+    }
+
+    // Checks if program binaries are supported by the driver.
+    bool IsProgramBinarySupported()
+    {
+        if(!GLEW_ARB_get_program_binary)
+            return false;
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+        return formatCount > 0;
+    }
 }
 
 Shader::Shader() :
@@ -41,8 +88,13 @@ void Shader::DestroyHandle()
     if(m_handle != InvalidHandle)
     {
         glDeleteProgram(m_handle);
+        GetStateCache()->OnProgramDeleted(m_handle);
         m_handle = InvalidHandle;
     }
+
+    // Clear reflected uniforms.
+    m_uniforms.clear();
+    m_uniformBlocks.clear();
 }
 
 bool Shader::Load(std::string filepath)
@@ -59,7 +111,8 @@ bool Shader::Load(std::string filepath)
     }
 
     // Call the compile method.
-    if(!this->Compile(shaderCode))
+    // Linked program binary is cached in a file next to the shader source.
+    if(!this->Compile(shaderCode, Build::GetWorkingDir() + filepath + ".bin"))
     {
         LogError() << "Could not compile the shader code!";
         return false;
@@ -72,6 +125,11 @@ bool Shader::Load(std::string filepath)
 }
 
 bool Shader::Compile(std::string shaderCode)
+{
+    return this->Compile(shaderCode, std::string());
+}
+
+bool Shader::Compile(std::string shaderCode, const std::string& binaryPath)
 {
     Log() << "Compiling shader code..." << LogIndent();
 
@@ -112,6 +170,45 @@ bool Shader::Compile(std::string shaderCode)
         shaderCode.erase(versionStart, versionEnd + 1);
     }
 
+    // Try to load a cached program binary.
+    // Key covers the source, defines of each compiled stage and the driver, so the binary
+    // gets invalidated whenever any of them changes.
+    bool binaryCache = !binaryPath.empty() && IsProgramBinarySupported();
+    uint64_t binaryKey = 0;
+
+    if(binaryCache)
+    {
+        std::string keyText;
+        keyText += GetDriverString(GL_VENDOR) + "\n";
+        keyText += GetDriverString(GL_RENDERER) + "\n";
+        keyText += GetDriverString(GL_VERSION) + "\n";
+        keyText += shaderVersion;
+
+        for(unsigned int i = 0; i < ShaderTypeCount; ++i)
+        {
+            if(shaderCode.find(ShaderTypes[i].name) != std::string::npos)
+            {
+                keyText += "#define ";
+                keyText += ShaderTypes[i].name;
+                keyText += "\n";
+            }
+        }
+
+        keyText += shaderCode;
+        binaryKey = CalculateBinaryKey(keyText);
+
+        if(this->LoadBinary(binaryPath, binaryKey))
+        {
+            // Reflect program uniforms.
+            this->ReflectUniforms();
+
+            LogInfo() << "Loaded cached program binary.";
+            LogInfo() << "Success!";
+
+            return initialized = true;
+        }
+    }
+
     // Compile shader objects.
     bool shaderObjectsFound = false;
 
@@ -204,6 +301,11 @@ bool Shader::Compile(std::string shaderCode)
     }
 
     // Link attached shader objects.
+    if(binaryCache)
+    {
+        glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glLinkProgram(m_handle);
 
     // Detach linked shader objects.
@@ -239,12 +341,199 @@ bool Shader::Compile(std::string shaderCode)
         return false;
     }
 
+    // Reflect program uniforms.
+    this->ReflectUniforms();
+
+    // Save the program binary for later runs.
+    if(binaryCache)
+    {
+        this->SaveBinary(binaryPath, binaryKey);
+    }
+
     // Success!
     LogInfo() << "Success!";
 
     return initialized = true;
 }
 
+bool Shader::LoadBinary(const std::string& binaryPath, uint64_t binaryKey)
+{
+    Assert(m_handle == InvalidHandle);
+
+    // Read the binary file.
+    std::vector<char> binary = Utility::GetBinaryFileContent(binaryPath);
+
+    if(binary.size() < sizeof(BinaryHeader))
+        return false;
+
+    // Validate the binary header.
+    BinaryHeader header;
+    std::memcpy(&header, binary.data(), sizeof(BinaryHeader));
+
+    if(header.magic != BinaryMagic || header.version != BinaryVersion)
+    {
+        LogWarning() << "Cached program binary has an unknown format.";
+        return false;
+    }
+
+    if(header.key != binaryKey)
+    {
+        LogInfo() << "Cached program binary is out of date.";
+        return false;
+    }
+
+    if(header.length != binary.size() - sizeof(BinaryHeader))
+    {
+        LogWarning() << "Cached program binary is truncated.";
+        return false;
+    }
+
+    // Create a program from the binary.
+    bool loaded = false;
+
+    SCOPE_GUARD_IF(!loaded, this->DestroyHandle());
+
+    m_handle = glCreateProgram();
+
+    if(m_handle == InvalidHandle)
+        return false;
+
+    glProgramBinary(m_handle, header.format, binary.data() + sizeof(BinaryHeader), header.length);
+
+    // Driver can reject binaries, for example after an update.
+    GLint linkStatus = 0;
+    glGetProgramiv(m_handle, GL_LINK_STATUS, &linkStatus);
+
+    if(linkStatus == GL_FALSE)
+    {
+        LogInfo() << "Cached program binary has been rejected by the driver.";
+        return false;
+    }
+
+    return loaded = true;
+}
+
+void Shader::SaveBinary(const std::string& binaryPath, uint64_t binaryKey) const
+{
+    Assert(m_handle != InvalidHandle);
+
+    // Retrieve the program binary.
+    GLint binaryLength = 0;
+    glGetProgramiv(m_handle, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+    if(binaryLength <= 0)
+    {
+        LogWarning() << "Could not retrieve the program binary.";
+        return;
+    }
+
+    std::vector<char> binary(sizeof(BinaryHeader) + binaryLength);
+
+    GLenum binaryFormat = GL_NONE;
+    glGetProgramBinary(m_handle, binaryLength, &binaryLength, &binaryFormat, binary.data() + sizeof(BinaryHeader));
+
+    // Write the binary header.
+    BinaryHeader header;
+    header.magic = BinaryMagic;
+    header.version = BinaryVersion;
+    header.key = binaryKey;
+    header.format = binaryFormat;
+    header.length = binaryLength;
+
+    std::memcpy(binary.data(), &header, sizeof(BinaryHeader));
+
+    // Write the binary file.
+    std::ofstream file(binaryPath, std::ios::binary | std::ios::trunc);
+
+    if(!file.write(binary.data(), sizeof(BinaryHeader) + binaryLength))
+    {
+        LogWarning() << "Could not write the program binary to \"" << binaryPath << "\" file.";
+        return;
+    }
+
+    LogInfo() << "Saved program binary to the cache.";
+}
+
+void Shader::ReflectUniforms()
+{
+    Assert(m_handle != InvalidHandle);
+
+    // Retrieve active uniforms.
+    GLint uniformCount = 0;
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    GLint uniformNameLength = 0;
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &uniformNameLength);
+
+    std::vector<char> uniformName(std::max(uniformNameLength, 1));
+
+    for(GLint i = 0; i < uniformCount; ++i)
+    {
+        UniformInfo uniform;
+
+        GLsizei length = 0;
+        glGetActiveUniform(m_handle, i, uniformName.size(), &length, &uniform.size, &uniform.type, uniformName.data());
+
+        // Remove the array subscript from the name.
+        std::string name(uniformName.data(), length);
+
+        std::size_t subscript = name.find('[');
+
+        if(subscript != std::string::npos)
+        {
+            name.erase(subscript);
+        }
+
+        // Skip uniforms that are members of uniform blocks.
+        uniform.location = glGetUniformLocation(m_handle, name.c_str());
+
+        if(uniform.location < 0)
+            continue;
+
+        // Add uniform to the table.
+        uint32_t hash = Utility::StringHash(name.c_str());
+        Assert(m_uniforms.count(hash) == 0, "Uniform name hash collision!");
+
+        m_uniforms[hash] = uniform;
+    }
+
+    // Retrieve active uniform blocks.
+    GLint blockCount = 0;
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+
+    GLint blockNameLength = 0;
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &blockNameLength);
+
+    std::vector<char> blockName(std::max(blockNameLength, 1));
+
+    for(GLint i = 0; i < blockCount; ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(m_handle, i, blockName.size(), &length, blockName.data());
+
+        // Add uniform block to the table.
+        std::string name(blockName.data(), length);
+        uint32_t hash = Utility::StringHash(name.c_str());
+        Assert(m_uniformBlocks.count(hash) == 0, "Uniform block name hash collision!");
+
+        m_uniformBlocks[hash] = i;
+    }
+
+    LogInfo() << "Reflected " << m_uniforms.size() << " uniforms and " << m_uniformBlocks.size() << " uniform blocks.";
+}
+
+const Shader::UniformInfo* Shader::FindUniform(uint32_t hash) const
+{
+    auto it = m_uniforms.find(hash);
+
+    if(it != m_uniforms.end())
+    {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
 GLint Shader::GetAttribute(std::string name) const
 {
     Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
@@ -257,12 +546,106 @@ GLint Shader::GetAttribute(std::string name) const
 
 GLint Shader::GetUniform(std::string name) const
 {
-    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
     Verify(!name.empty(), "Uniform name cannot be empty!");
 
-    GLint location = glGetUniformLocation(m_handle, name.c_str());
+    return this->GetUniform(Utility::StringHash(name.c_str()));
+}
 
-    return location;
+GLint Shader::GetUniform(uint32_t hash) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    const UniformInfo* uniform = this->FindUniform(hash);
+
+    return uniform != nullptr ? uniform->location : -1;
+}
+
+template<>
+void Shader::SetUniform(const Uniform<int>& uniform, const int& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    // Integer uniforms also cover booleans and samplers.
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        glUniform1i(info->location, value);
+    }
+}
+
+template<>
+void Shader::SetUniform(const Uniform<float>& uniform, const float& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        Assert(info->type == GL_FLOAT, "Uniform type mismatch!");
+        glUniform1f(info->location, value);
+    }
+}
+
+template<>
+void Shader::SetUniform(const Uniform<glm::vec2>& uniform, const glm::vec2& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        Assert(info->type == GL_FLOAT_VEC2, "Uniform type mismatch!");
+        glUniform2fv(info->location, 1, glm::value_ptr(value));
+    }
+}
+
+template<>
+void Shader::SetUniform(const Uniform<glm::vec3>& uniform, const glm::vec3& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        Assert(info->type == GL_FLOAT_VEC3, "Uniform type mismatch!");
+        glUniform3fv(info->location, 1, glm::value_ptr(value));
+    }
+}
+
+template<>
+void Shader::SetUniform(const Uniform<glm::vec4>& uniform, const glm::vec4& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        Assert(info->type == GL_FLOAT_VEC4, "Uniform type mismatch!");
+        glUniform4fv(info->location, 1, glm::value_ptr(value));
+    }
+}
+
+template<>
+void Shader::SetUniform(const Uniform<glm::mat4>& uniform, const glm::mat4& value) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    if(const UniformInfo* info = this->FindUniform(uniform.hash))
+    {
+        Assert(info->type == GL_FLOAT_MAT4, "Uniform type mismatch!");
+        glUniformMatrix4fv(info->location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+bool Shader::BindUniformBlock(const UniformBlock& block, GLuint binding) const
+{
+    Verify(m_handle != InvalidHandle, "Shader program handle has not been created!");
+
+    // Find the uniform block index.
+    auto it = m_uniformBlocks.find(block.hash);
+
+    if(it == m_uniformBlocks.end())
+        return false;
+
+    // Assign the binding point.
+    glUniformBlockBinding(m_handle, it->second, binding);
+
+    return true;
 }
 
 GLuint Shader::GetHandle() const
@@ -7,6 +7,8 @@
     
     Loads and links GLSL shaders into an OpenGL program object.
     Supports geometry shaders, vertex shaders and fragment shaders.
+    Shaders loaded from files have their linked program binaries cached
+    when supported by the driver, which skips compilation on later runs.
     
     void ExampleGraphicsShader()
     {
@@ -17,6 +19,10 @@
         // Use the shader in the rendering pipeline.
         glUseProgram(shader.GetHandle());
         glUniformMatrix4fv(shader.GetUniform("vertexTransform"), 1, GL_FALSE, glm::value_ptr(glm::mat4()));
+
+        // Set a uniform using a typed handle hashed at compile time.
+        constexpr Graphics::Uniform<glm::mat4> VertexTransform("vertexTransform");
+        shader.SetUniform(VertexTransform, glm::mat4(1.0f));
     }
 
     ExampleShader.glsl
@@ -47,9 +53,50 @@
 
 namespace Graphics
 {
+    // Uniform handle structure.
+    // Name hash is calculated at compile time when constructed from a string literal.
+    template<typename Type>
+    struct Uniform
+    {
+        constexpr Uniform(const char* name) :
+            name(name),
+            hash(Utility::StringHash(name))
+        {
+        }
+
+        const char* name;
+        uint32_t hash;
+    };
+
+    // Uniform block handle structure.
+    struct UniformBlock
+    {
+        constexpr UniformBlock(const char* name) :
+            name(name),
+            hash(Utility::StringHash(name))
+        {
+        }
+
+        const char* name;
+        uint32_t hash;
+    };
+
     // Shader class.
     class Shader
     {
+    public:
+        // Uniform info structure.
+        struct UniformInfo
+        {
+            GLint location;
+            GLenum type;
+            GLint size;
+        };
+
+        // Type declarations.
+        typedef std::unordered_map<uint32_t, UniformInfo> UniformMap;
+        typedef std::unordered_map<uint32_t, GLuint>      UniformBlockMap;
+
     public:
         Shader();
         ~Shader();
@@ -64,7 +111,17 @@ namespace Graphics
         GLint GetAttribute(std::string name) const;
 
         // Gets a shader uniform index.
+        // Uniforms are looked up in a table reflected when the program is linked.
         GLint GetUniform(std::string name) const;
+        GLint GetUniform(uint32_t hash) const;
+
+        // Sets a uniform value of the shader.
+        // The shader's program has to be currently in use.
+        template<typename Type>
+        void SetUniform(const Uniform<Type>& uniform, const Type& value) const;
+
+        // Assigns a uniform block to an uniform buffer binding point.
+        bool BindUniformBlock(const UniformBlock& block, GLuint binding) const;
 
         // Gets the shader's program handle.
         GLuint GetHandle() const;
@@ -76,8 +133,35 @@ namespace Graphics
         // Destroys the internal handle.
         void DestroyHandle();
 
+        // Compiles the shader and caches the linked program binary.
+        bool Compile(std::string shaderCode, const std::string& binaryPath);
+
+        // Loads a cached program binary if its key matches.
+        bool LoadBinary(const std::string& binaryPath, uint64_t binaryKey);
+
+        // Saves the program binary to the cache.
+        void SaveBinary(const std::string& binaryPath, uint64_t binaryKey) const;
+
+        // Reflects active uniforms and uniform blocks of the linked program.
+        void ReflectUniforms();
+
+        // Finds uniform info by name hash.
+        const UniformInfo* FindUniform(uint32_t hash) const;
+
     private:
         // Program handle.
         GLuint m_handle;
+
+        // Reflected uniforms.
+        UniformMap m_uniforms;
+        UniformBlockMap m_uniformBlocks;
     };
+
+    // Uniform value setters.
+    template<> void Shader::SetUniform(const Uniform<int>& uniform, const int& value) const;
+    template<> void Shader::SetUniform(const Uniform<float>& uniform, const float& value) const;
+    template<> void Shader::SetUniform(const Uniform<glm::vec2>& uniform, const glm::vec2& value) const;
+    template<> void Shader::SetUniform(const Uniform<glm::vec3>& uniform, const glm::vec3& value) const;
+    template<> void Shader::SetUniform(const Uniform<glm::vec4>& uniform, const glm::vec4& value) const;
+    template<> void Shader::SetUniform(const Uniform<glm::mat4>& uniform, const glm::mat4& value) const;
 }
@@ -1,17 +1,25 @@
 #include "Precompiled.hpp"
 #include "Sprite.hpp"
+#include "Material.hpp"
 using namespace Graphics;
 
 Sprite::Info::Info() :
-    texture(nullptr),
-    transparent(false),
-    filter(true)
+    material(nullptr),
+    materialIdentifier(0),
+    transparent(false)
+{
+}
+
+Sprite::Info::Info(const Material* material) :
+    material(material),
+    materialIdentifier(material->GetIdentifier()),
+    transparent(material->IsTransparent())
 {
 }
 
 bool Sprite::Info::operator==(const Info& other) const
 {
-    return texture == other.texture && transparent == other.transparent && filter == other.filter;
+    return material == other.material;
 }
 
 bool Sprite::Info::operator!=(const Info& other) const
@@ -22,6 +30,8 @@ bool Sprite::Info::operator!=(const Info& other) const
 Sprite::Data::Data() :
     transform(1.0f),
     rectangle(0.0f, 0.0f, 1.0f, 1.0f),
-    color(1.0f, 1.0f, 1.0f, 1.0f)
+    diffuseColor(0xFFFFFFFF),
+    emissiveColor(0xFFFFFFFF),
+    emissivePower(0.0f)
 {
 }
@@ -8,29 +8,32 @@
     Structure that defines a textured quad. Consists of two parts - information
     that can be shared between different instances of sprites and data that
     is unique for each sprite. This is done to support efficient sprite
-    rendering using geometry instancing.
+    rendering using geometry instancing. Shared information references
+    a material that holds the whole pipeline state of the sprite. Colors
+    are packed as normalized bytes and the emissive blend is done by the
+    shader, so sprite data only has to change when colors change.
 
-    void ExampleGraphicsSprite(const Texture* texture)
+    void ExampleGraphicsSprite(const Material* material)
     {
         // Get texture size.
-        float width = texture->GetWidth();
-        float height = texture->GetHeight();
+        float width = material->GetTexture()->GetWidth();
+        float height = material->GetTexture()->GetHeight();
 
         // Define a sprite in two parts.
         Graphics::Sprite sprite;
-        sprite.info.texture = texture;
-        sprite.info.transparent = true;
-        sprite.info.filter = false;
+        sprite.info = Graphics::Sprite::Info(material);
         sprite.data.transform = glm::mat4(1.0f);
         sprite.data.rectangle = glm::vec4(0.0f, 0.0f, width, height);
-        sprite.data.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        sprite.data.diffuseColor = glm::packUnorm4x8(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+        sprite.data.emissiveColor = glm::packUnorm4x8(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+        sprite.data.emissivePower = 0.5f;
     }
 */
 
 namespace Graphics
 {
     // Forward declarations.
-    class Texture;
+    class Material;
 
     // Sprite structure.
     struct Sprite
@@ -39,13 +42,17 @@ namespace Graphics
         struct Info
         {
             Info();
+            Info(const Material* material);
 
             bool operator==(const Info& other) const;
             bool operator!=(const Info& other) const;
 
-            const Texture* texture;
+            const Material* material;
+
+            // Material state copied for sorting without dereferencing the material.
+            // Stable material key is used instead of the material's address.
+            uint32_t materialIdentifier;
             bool transparent;
-            bool filter;
         } info;
 
         // Data structure of each sprite.
@@ -55,7 +62,11 @@ namespace Graphics
 
             glm::mat4 transform;
             glm::vec4 rectangle;
-            glm::vec4 color;
+
+            // Final color is a mix of diffuse and emissive colors by the emissive power.
+            uint32_t diffuseColor;
+            uint32_t emissiveColor;
+            float emissivePower;
         } data;
     };
 }
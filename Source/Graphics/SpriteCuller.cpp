@@ -0,0 +1,96 @@
+#include "Precompiled.hpp"
+#include "SpriteCuller.hpp"
+using namespace Graphics;
+
+SpriteCuller::SpriteCuller()
+{
+}
+
+SpriteCuller::~SpriteCuller()
+{
+}
+
+void SpriteCuller::Reserve(std::size_t count)
+{
+    m_left.reserve(count);
+    m_right.reserve(count);
+    m_bottom.reserve(count);
+    m_top.reserve(count);
+}
+
+std::size_t SpriteCuller::AddBounds(const glm::vec4& bounds)
+{
+    Assert(bounds.x <= bounds.y, "Left edge of bounds is past the right edge!");
+    Assert(bounds.z <= bounds.w, "Bottom edge of bounds is past the top edge!");
+
+    // Store bounds edges in separate arrays.
+    m_left.push_back(bounds.x);
+    m_right.push_back(bounds.y);
+    m_bottom.push_back(bounds.z);
+    m_top.push_back(bounds.w);
+
+    return m_left.size() - 1;
+}
+
+void SpriteCuller::Cull(const glm::vec4& rectangle, IndexList& visibleIndices) const
+{
+    const std::size_t boundsCount = m_left.size();
+    std::size_t index = 0;
+
+#ifdef SSE_AVAILABLE
+    // Broadcast rectangle edges.
+    const __m128 rectangleLeft = _mm_set1_ps(rectangle.x);
+    const __m128 rectangleRight = _mm_set1_ps(rectangle.y);
+    const __m128 rectangleBottom = _mm_set1_ps(rectangle.z);
+    const __m128 rectangleTop = _mm_set1_ps(rectangle.w);
+
+    // Test four bounds at a time.
+    for(; index + 4 <= boundsCount; index += 4)
+    {
+        const __m128 left = _mm_loadu_ps(&m_left[index]);
+        const __m128 right = _mm_loadu_ps(&m_right[index]);
+        const __m128 bottom = _mm_loadu_ps(&m_bottom[index]);
+        const __m128 top = _mm_loadu_ps(&m_top[index]);
+
+        // Bounds intersect if they overlap on both axes.
+        __m128 overlap = _mm_and_ps(_mm_cmple_ps(left, rectangleRight), _mm_cmpge_ps(right, rectangleLeft));
+        overlap = _mm_and_ps(overlap, _mm_cmple_ps(bottom, rectangleTop));
+        overlap = _mm_and_ps(overlap, _mm_cmpge_ps(top, rectangleBottom));
+
+        // Append indices of intersecting bounds.
+        int mask = _mm_movemask_ps(overlap);
+
+        while(mask != 0)
+        {
+            int lane = 0;
+            while((mask & (1 << lane)) == 0) ++lane;
+
+            visibleIndices.push_back(index + lane);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Test remaining bounds one at a time.
+    for(; index < boundsCount; ++index)
+    {
+        if(m_left[index] <= rectangle.y && m_right[index] >= rectangle.x &&
+            m_bottom[index] <= rectangle.w && m_top[index] >= rectangle.z)
+        {
+            visibleIndices.push_back(index);
+        }
+    }
+}
+
+void SpriteCuller::Clear()
+{
+    m_left.clear();
+    m_right.clear();
+    m_bottom.clear();
+    m_top.clear();
+}
+
+std::size_t SpriteCuller::GetBoundsCount() const
+{
+    return m_left.size();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Sprite Culler
+
+    Tests axis aligned sprite bounds against a visible rectangle.
+    Bounds are stored as separate arrays of each edge, so they can be
+    tested four at a time using SIMD instructions when available.
+
+    Rectangles follow the same [left, right, bottom, top] convention
+    as the one returned by Graphics::ScreenSpace::GetRectangle().
+
+    void ExampleGraphicsSpriteCuller(const glm::vec4& cameraRectangle)
+    {
+        // Submit bounds of each sprite.
+        Graphics::SpriteCuller spriteCuller;
+        spriteCuller.AddBounds(glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+        spriteCuller.AddBounds(glm::vec4(100.0f, 101.0f, 100.0f, 101.0f));
+
+        // Retrieve indices of visible sprites.
+        std::vector<std::size_t> visibleIndices;
+        spriteCuller.Cull(cameraRectangle, visibleIndices);
+
+        // Clear submitted bounds for the next frame.
+        spriteCuller.Clear();
+    }
+*/
+
+namespace Graphics
+{
+    // Sprite culler class.
+    class SpriteCuller
+    {
+    public:
+        // Type declarations.
+        typedef std::vector<float>       EdgeList;
+        typedef std::vector<std::size_t> IndexList;
+
+    public:
+        SpriteCuller();
+        ~SpriteCuller();
+
+        // Reserves memory for a number of bounds.
+        void Reserve(std::size_t count);
+
+        // Adds sprite bounds as a [left, right, bottom, top] rectangle.
+        // Returns an index that will be referenced by the culling results.
+        std::size_t AddBounds(const glm::vec4& bounds);
+
+        // Tests all bounds against a [left, right, bottom, top] rectangle.
+        // Appends indices of intersecting bounds in the order they were added.
+        void Cull(const glm::vec4& rectangle, IndexList& visibleIndices) const;
+
+        // Clears all submitted bounds.
+        void Clear();
+
+        // Gets the number of submitted bounds.
+        std::size_t GetBoundsCount() const;
+
+    private:
+        // Bounds edges.
+        EdgeList m_left;
+        EdgeList m_right;
+        EdgeList m_bottom;
+        EdgeList m_top;
+    };
+}
@@ -0,0 +1,344 @@
+#include "Precompiled.hpp"
+#include "StateCache.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Unknown state values.
+    const GLuint UnknownHandle = std::numeric_limits<GLuint>::max();
+    const GLenum UnknownEnum = std::numeric_limits<GLenum>::max();
+    const int UnknownValue = -1;
+
+    // State cache of each thread.
+    // Threads have their own OpenGL contexts, each with separate pipeline state.
+    thread_local StateCache stateCache;
+}
+
+StateCache::StateCache() :
+    m_program(0),
+    m_vertexArray(0),
+    m_framebuffer(0),
+    m_activeTexture(0),
+    m_blend(GL_FALSE),
+    m_blendSource(GL_ONE),
+    m_blendDestination(GL_ZERO),
+    m_depthMask(GL_TRUE),
+    m_issuedCalls(0),
+    m_skippedCalls(0)
+{
+    // Start with the default state of a new context.
+    for(int i = 0; i < BufferTargetCount; ++i)
+    {
+        m_buffers[i] = 0;
+    }
+
+    for(int i = 0; i < TextureUnitCount; ++i)
+    {
+        m_textureUnits[i].target = GL_TEXTURE_2D;
+        m_textureUnits[i].texture = 0;
+        m_textureUnits[i].sampler = 0;
+    }
+}
+
+StateCache::~StateCache()
+{
+}
+
+void StateCache::Reset()
+{
+    m_program = UnknownHandle;
+    m_vertexArray = UnknownHandle;
+
+    for(int i = 0; i < BufferTargetCount; ++i)
+    {
+        m_buffers[i] = UnknownHandle;
+    }
+
+    m_framebuffer = UnknownHandle;
+
+    m_activeTexture = UnknownValue;
+
+    for(int i = 0; i < TextureUnitCount; ++i)
+    {
+        m_textureUnits[i].target = UnknownEnum;
+        m_textureUnits[i].texture = UnknownHandle;
+        m_textureUnits[i].sampler = UnknownHandle;
+    }
+
+    m_blend = UnknownValue;
+    m_blendSource = UnknownEnum;
+    m_blendDestination = UnknownEnum;
+    m_depthMask = UnknownValue;
+}
+
+template<typename Type>
+bool StateCache::Update(Type& current, const Type& value)
+{
+    // Check if the state is already set.
+    if(current == value)
+    {
+        ++m_skippedCalls;
+        return false;
+    }
+
+    // Shadow the new state.
+    current = value;
+    ++m_issuedCalls;
+    return true;
+}
+
+int StateCache::GetBufferTargetIndex(GLenum target)
+{
+    switch(target)
+    {
+        case GL_ARRAY_BUFFER:         return BufferTargetArray;
+        case GL_ELEMENT_ARRAY_BUFFER: return BufferTargetElementArray;
+        case GL_COPY_READ_BUFFER:     return BufferTargetCopyRead;
+        case GL_COPY_WRITE_BUFFER:    return BufferTargetCopyWrite;
+        case GL_PIXEL_PACK_BUFFER:    return BufferTargetPixelPack;
+        case GL_PIXEL_UNPACK_BUFFER:  return BufferTargetPixelUnpack;
+        case GL_UNIFORM_BUFFER:       return BufferTargetUniform;
+    }
+
+    return -1;
+}
+
+bool StateCache::UseProgram(GLuint program)
+{
+    if(this->Update(m_program, program))
+    {
+        glUseProgram(program);
+        return true;
+    }
+
+    return false;
+}
+
+void StateCache::BindVertexArray(GLuint vertexArray)
+{
+    if(this->Update(m_vertexArray, vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+
+        // Element array binding is a part of the vertex array state.
+        m_buffers[BufferTargetElementArray] = UnknownHandle;
+    }
+}
+
+void StateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+    int index = GetBufferTargetIndex(target);
+
+    // Issue calls for targets that are not tracked.
+    if(index < 0)
+    {
+        glBindBuffer(target, buffer);
+        ++m_issuedCalls;
+        return;
+    }
+
+    if(this->Update(m_buffers[index], buffer))
+    {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void StateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // Indexed bindings are not tracked, but they also change the generic binding.
+    glBindBufferBase(target, index, buffer);
+    ++m_issuedCalls;
+
+    int targetIndex = GetBufferTargetIndex(target);
+
+    if(targetIndex >= 0)
+    {
+        m_buffers[targetIndex] = buffer;
+    }
+}
+
+void StateCache::BindFramebuffer(GLuint framebuffer)
+{
+    if(this->Update(m_framebuffer, framebuffer))
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+}
+
+void StateCache::ActiveTexture(int unit)
+{
+    Verify(0 <= unit && unit < TextureUnitCount, "Texture unit is out of range!");
+
+    if(this->Update(m_activeTexture, unit))
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+bool StateCache::BindTexture(int unit, GLenum target, GLuint texture)
+{
+    Verify(0 <= unit && unit < TextureUnitCount, "Texture unit is out of range!");
+
+    TextureUnit& textureUnit = m_textureUnits[unit];
+
+    // Check if the texture is already bound.
+    if(textureUnit.target == target && textureUnit.texture == texture)
+    {
+        ++m_skippedCalls;
+        return false;
+    }
+
+    // Bind the texture to the unit.
+    this->ActiveTexture(unit);
+
+    glBindTexture(target, texture);
+    ++m_issuedCalls;
+
+    textureUnit.target = target;
+    textureUnit.texture = texture;
+
+    return true;
+}
+
+bool StateCache::BindTexture(GLenum target, GLuint texture)
+{
+    // Bind to the first unit if the active one is unknown.
+    int unit = m_activeTexture != UnknownValue ? m_activeTexture : 0;
+
+    return this->BindTexture(unit, target, texture);
+}
+
+void StateCache::BindSampler(int unit, GLuint sampler)
+{
+    Verify(0 <= unit && unit < TextureUnitCount, "Texture unit is out of range!");
+
+    if(this->Update(m_textureUnits[unit].sampler, sampler))
+    {
+        glBindSampler(unit, sampler);
+    }
+}
+
+bool StateCache::SetBlend(bool enabled)
+{
+    if(this->Update(m_blend, enabled ? GL_TRUE : GL_FALSE))
+    {
+        if(enabled)
+        {
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void StateCache::SetBlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+    // Check if the blend function is already set.
+    if(m_blendSource == sourceFactor && m_blendDestination == destinationFactor)
+    {
+        ++m_skippedCalls;
+        return;
+    }
+
+    glBlendFunc(sourceFactor, destinationFactor);
+    ++m_issuedCalls;
+
+    m_blendSource = sourceFactor;
+    m_blendDestination = destinationFactor;
+}
+
+void StateCache::SetDepthMask(bool enabled)
+{
+    if(this->Update(m_depthMask, enabled ? GL_TRUE : GL_FALSE))
+    {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void StateCache::OnProgramDeleted(GLuint program)
+{
+    // Deleted program stays in use until another one is bound,
+    // but its handle can be reused by a new program.
+    if(m_program == program)
+    {
+        m_program = UnknownHandle;
+    }
+}
+
+void StateCache::OnVertexArrayDeleted(GLuint vertexArray)
+{
+    if(m_vertexArray == vertexArray)
+    {
+        m_vertexArray = 0;
+        m_buffers[BufferTargetElementArray] = UnknownHandle;
+    }
+}
+
+void StateCache::OnBufferDeleted(GLuint buffer)
+{
+    for(int i = 0; i < BufferTargetCount; ++i)
+    {
+        if(m_buffers[i] == buffer)
+        {
+            m_buffers[i] = 0;
+        }
+    }
+}
+
+void StateCache::OnTextureDeleted(GLuint texture)
+{
+    for(int i = 0; i < TextureUnitCount; ++i)
+    {
+        if(m_textureUnits[i].texture == texture)
+        {
+            m_textureUnits[i].texture = 0;
+        }
+    }
+}
+
+void StateCache::OnSamplerDeleted(GLuint sampler)
+{
+    for(int i = 0; i < TextureUnitCount; ++i)
+    {
+        if(m_textureUnits[i].sampler == sampler)
+        {
+            m_textureUnits[i].sampler = 0;
+        }
+    }
+}
+
+void StateCache::OnFramebufferDeleted(GLuint framebuffer)
+{
+    // Deleting a bound framebuffer reverts the binding to the default one.
+    if(m_framebuffer == framebuffer)
+    {
+        m_framebuffer = 0;
+    }
+}
+
+void StateCache::ResetCounters()
+{
+    m_issuedCalls = 0;
+    m_skippedCalls = 0;
+}
+
+unsigned int StateCache::GetIssuedCalls() const
+{
+    return m_issuedCalls;
+}
+
+unsigned int StateCache::GetSkippedCalls() const
+{
+    return m_skippedCalls;
+}
+
+StateCache* Graphics::GetStateCache()
+{
+    return &stateCache;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics State Cache
+
+    Shadows the OpenGL pipeline state and skips calls that would set
+    state to the value it already has. All graphics objects bind their
+    handles through the global state cache, so nothing has to be unbound
+    after use. Code calling OpenGL directly should call Reset() afterwards.
+    Each thread gets its own cache, shadowing the context current on it.
+
+    void ExampleGraphicsStateCache()
+    {
+        // Get the global state cache.
+        Graphics::StateCache* stateCache = Graphics::GetStateCache();
+
+        // Bind pipeline state.
+        stateCache->UseProgram(shader.GetHandle());
+        stateCache->BindVertexArray(vertexInput.GetHandle());
+        stateCache->BindTexture(0, GL_TEXTURE_2D, texture.GetHandle());
+
+        // Second bind of the same program will be skipped.
+        stateCache->UseProgram(shader.GetHandle());
+
+        // Retrieve the number of skipped calls.
+        unsigned int skippedCalls = stateCache->GetSkippedCalls();
+    }
+*/
+
+namespace Graphics
+{
+    // State cache class.
+    class StateCache : private NonCopyable
+    {
+    public:
+        // Number of tracked texture units.
+        static const int TextureUnitCount = 16;
+
+    public:
+        StateCache();
+        ~StateCache();
+
+        // Invalidates all shadowed state.
+        // Following calls will be always issued.
+        void Reset();
+
+        // Binds a shader program.
+        // Returns true if the call has been issued.
+        bool UseProgram(GLuint program);
+
+        // Binds a vertex array.
+        void BindVertexArray(GLuint vertexArray);
+
+        // Binds a buffer to a target.
+        void BindBuffer(GLenum target, GLuint buffer);
+
+        // Binds a buffer to an indexed target.
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        // Binds a framebuffer for both drawing and reading.
+        void BindFramebuffer(GLuint framebuffer);
+
+        // Sets the active texture unit.
+        void ActiveTexture(int unit);
+
+        // Binds a texture to a texture unit.
+        // Returns true if the call has been issued.
+        bool BindTexture(int unit, GLenum target, GLuint texture);
+
+        // Binds a texture to the active texture unit.
+        bool BindTexture(GLenum target, GLuint texture);
+
+        // Binds a sampler to a texture unit.
+        void BindSampler(int unit, GLuint sampler);
+
+        // Sets blending state.
+        // Returns true if the call has been issued.
+        bool SetBlend(bool enabled);
+
+        // Sets the blending function.
+        void SetBlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+
+        // Sets the depth writing mask.
+        void SetDepthMask(bool enabled);
+
+        // Notifies the cache about a deleted object.
+        // OpenGL unbinds deleted objects and their handles can be reused.
+        void OnProgramDeleted(GLuint program);
+        void OnVertexArrayDeleted(GLuint vertexArray);
+        void OnBufferDeleted(GLuint buffer);
+        void OnTextureDeleted(GLuint texture);
+        void OnSamplerDeleted(GLuint sampler);
+        void OnFramebufferDeleted(GLuint framebuffer);
+
+        // Resets the call counters.
+        void ResetCounters();
+
+        // Gets the number of issued calls.
+        unsigned int GetIssuedCalls() const;
+
+        // Gets the number of skipped calls.
+        unsigned int GetSkippedCalls() const;
+
+    private:
+        // Buffer target indices.
+        enum BufferTargets
+        {
+            BufferTargetArray,
+            BufferTargetElementArray,
+            BufferTargetCopyRead,
+            BufferTargetCopyWrite,
+            BufferTargetPixelPack,
+            BufferTargetPixelUnpack,
+            BufferTargetUniform,
+
+            BufferTargetCount,
+        };
+
+        // Texture unit state.
+        struct TextureUnit
+        {
+            GLenum target;
+            GLuint texture;
+            GLuint sampler;
+        };
+
+    private:
+        // Gets the index of a buffer target.
+        static int GetBufferTargetIndex(GLenum target);
+
+        // Compares and updates a shadowed value.
+        template<typename Type>
+        bool Update(Type& current, const Type& value);
+
+    private:
+        // Pipeline state.
+        GLuint m_program;
+        GLuint m_vertexArray;
+        GLuint m_buffers[BufferTargetCount];
+        GLuint m_framebuffer;
+
+        // Texture state.
+        int m_activeTexture;
+        TextureUnit m_textureUnits[TextureUnitCount];
+
+        // Output state.
+        int m_blend;
+        GLenum m_blendSource;
+        GLenum m_blendDestination;
+        int m_depthMask;
+
+        // Call counters.
+        unsigned int m_issuedCalls;
+        unsigned int m_skippedCalls;
+    };
+
+    // Gets the state cache of the calling thread.
+    StateCache* GetStateCache();
+}
@@ -0,0 +1,179 @@
+#include "Precompiled.hpp"
+#include "StaticSpriteBuffer.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Calculates world bounds of a sprite.
+    glm::vec4 CalculateSpriteBounds(const Sprite::Data& data)
+    {
+        // Sprite size can be negative for mirrored sprites.
+        glm::vec2 size = glm::abs(glm::vec2(data.rectangle.z, data.rectangle.w));
+
+        // Transform each corner of the sprite quad.
+        const glm::vec4 corners[4] =
+        {
+            data.transform * glm::vec4(0.0f,   0.0f,   0.0f, 1.0f),
+            data.transform * glm::vec4(size.x, 0.0f,   0.0f, 1.0f),
+            data.transform * glm::vec4(0.0f,   size.y, 0.0f, 1.0f),
+            data.transform * glm::vec4(size.x, size.y, 0.0f, 1.0f),
+        };
+
+        glm::vec2 boundsMin = glm::vec2(corners[0]);
+        glm::vec2 boundsMax = glm::vec2(corners[0]);
+
+        for(int i = 1; i < 4; ++i)
+        {
+            boundsMin = glm::min(boundsMin, glm::vec2(corners[i]));
+            boundsMax = glm::max(boundsMax, glm::vec2(corners[i]));
+        }
+
+        return glm::vec4(boundsMin.x, boundsMax.x, boundsMin.y, boundsMax.y);
+    }
+}
+
+StaticBatchInfo::StaticBatchInfo() :
+    maxSpriteCount(1024),
+    maxExtent(0.0f),
+    splitTransparentRows(false)
+{
+}
+
+StaticSpriteBuffer::Batch::Batch() :
+    depth(0.0f),
+    height(0.0f),
+    bounds(0.0f, 0.0f, 0.0f, 0.0f),
+    first(0),
+    count(0)
+{
+}
+
+StaticSpriteBuffer::StaticSpriteBuffer() :
+    m_spriteCount(0)
+{
+}
+
+StaticSpriteBuffer::~StaticSpriteBuffer()
+{
+}
+
+bool StaticSpriteBuffer::Build(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const StaticBatchInfo& batchInfo)
+{
+    Verify(batchInfo.maxSpriteCount > 0, "Invalid argument - \"batchInfo.maxSpriteCount\" is invalid!");
+
+    // Clear previous batches.
+    this->Clear();
+
+    if(spriteCount == 0)
+        return true;
+
+    Verify(spriteInfo != nullptr, "Invalid argument - \"spriteInfo\" is null!");
+    Verify(spriteData != nullptr, "Invalid argument - \"spriteData\" is null!");
+
+    // Upload sprite data to the instance buffer.
+    if(!m_instanceBuffer.IsValid())
+    {
+        BufferInfo instanceBufferInfo;
+        instanceBufferInfo.usage = GL_STATIC_DRAW;
+        instanceBufferInfo.elementSize = sizeof(Sprite::Data);
+        instanceBufferInfo.elementCount = spriteCount;
+        instanceBufferInfo.data = spriteData;
+
+        if(!m_instanceBuffer.Create(instanceBufferInfo))
+        {
+            LogError() << "Could not create an instance buffer!";
+            return false;
+        }
+    }
+    else if(spriteCount > m_instanceBuffer.GetElementCount())
+    {
+        m_instanceBuffer.Resize(spriteCount, spriteData);
+    }
+    else
+    {
+        m_instanceBuffer.Update(spriteData, spriteCount);
+    }
+
+    m_spriteCount = spriteCount;
+
+    // Split sprites into batches.
+    for(std::size_t i = 0; i < spriteCount; ++i)
+    {
+        const Sprite::Info& info = spriteInfo[i];
+        const Sprite::Data& data = spriteData[i];
+
+        float depth = data.transform[3][2];
+        float height = data.transform[3][1];
+        glm::vec4 bounds = CalculateSpriteBounds(data);
+
+        // Check if sprite can be added to the current batch.
+        if(!m_batches.empty())
+        {
+            Batch& batch = m_batches.back();
+
+            bool sameRow = !batchInfo.splitTransparentRows || !info.transparent || batch.height == height;
+
+            if(batch.count < batchInfo.maxSpriteCount && batch.info == info && batch.depth == depth && sameRow)
+            {
+                // Calculate extended batch bounds.
+                glm::vec4 batchBounds;
+                batchBounds.x = std::min(batch.bounds.x, bounds.x);
+                batchBounds.y = std::max(batch.bounds.y, bounds.y);
+                batchBounds.z = std::min(batch.bounds.z, bounds.z);
+                batchBounds.w = std::max(batch.bounds.w, bounds.w);
+
+                // Extend the batch if its bounds stay within the size limit.
+                bool withinExtent = batchInfo.maxExtent <= 0.0f ||
+                    (batchBounds.y - batchBounds.x <= batchInfo.maxExtent && batchBounds.w - batchBounds.z <= batchInfo.maxExtent);
+
+                if(withinExtent)
+                {
+                    batch.bounds = batchBounds;
+                    batch.count += 1;
+                    continue;
+                }
+            }
+        }
+
+        // Start a new batch.
+        Batch batch;
+        batch.info = info;
+        batch.depth = depth;
+        batch.height = height;
+        batch.bounds = bounds;
+        batch.first = (int)i;
+        batch.count = 1;
+
+        m_batches.push_back(batch);
+    }
+
+    return true;
+}
+
+void StaticSpriteBuffer::Clear()
+{
+    m_batches.clear();
+    m_spriteCount = 0;
+}
+
+const InstanceBuffer& StaticSpriteBuffer::GetInstanceBuffer() const
+{
+    return m_instanceBuffer;
+}
+
+const StaticSpriteBuffer::Batch& StaticSpriteBuffer::GetBatch(std::size_t index) const
+{
+    Verify(index < m_batches.size(), "Batch index is out of range!");
+
+    return m_batches[index];
+}
+
+std::size_t StaticSpriteBuffer::GetBatchCount() const
+{
+    return m_batches.size();
+}
+
+std::size_t StaticSpriteBuffer::GetSpriteCount() const
+{
+    return m_spriteCount;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Buffer.hpp"
+#include "Sprite.hpp"
+
+/*
+    Graphics Static Sprite Buffer
+
+    Retains sprites that rarely change in a GPU instance buffer along
+    with precomputed batches, so they do not have to be sorted and
+    uploaded every frame. Sprites are expected to be already sorted
+    when the buffer is built. Batches are split whenever sprite info
+    or depth changes, so each batch can be ordered by its depth in
+    relation to other sprites. Batches of transparent sprites can also
+    be split on each change of their y position, so dynamic sprites
+    sorted by it can be drawn in between them. Batch bounds can be
+    limited in size, which keeps batches of spatially grouped sprites
+    small enough to be culled.
+
+    void ExampleGraphicsStaticSpriteBuffer(const SpriteInfoList& spriteInfo, const SpriteDataList& spriteData)
+    {
+        // Build the buffer once from a sorted list of sprites.
+        Graphics::StaticSpriteBuffer staticSprites;
+        staticSprites.Build(spriteInfo.data(), spriteData.data(), spriteInfo.size());
+
+        // Draw visible batches every frame.
+        std::vector<std::size_t> visibleBatches = { 0 };
+        basicRenderer.DrawStaticSprites(staticSprites, visibleBatches.data(), visibleBatches.size(), transform);
+    }
+*/
+
+namespace Graphics
+{
+    // Static batch info structure.
+    // Describes when batches of a static sprite buffer are split.
+    struct StaticBatchInfo
+    {
+        StaticBatchInfo();
+
+        // Maximum number of sprites in a batch.
+        int maxSpriteCount;
+
+        // Maximum width and height of batch bounds in world units.
+        // Zero does not limit the size of batch bounds.
+        float maxExtent;
+
+        // Splits batches of transparent sprites when their y position changes.
+        bool splitTransparentRows;
+    };
+
+    // Static sprite buffer class.
+    class StaticSpriteBuffer
+    {
+    public:
+        // Batch structure.
+        struct Batch
+        {
+            Batch();
+
+            // Shared sprite info.
+            Sprite::Info info;
+
+            // Depth shared by all sprites in the batch.
+            float depth;
+
+            // Y position of the first sprite in the batch.
+            // Shared by all sprites of transparent batches if rows are split.
+            float height;
+
+            // World bounds as a [left, right, bottom, top] rectangle.
+            glm::vec4 bounds;
+
+            // Range of sprite instances.
+            int first;
+            int count;
+        };
+
+        // Type declarations.
+        typedef std::vector<Batch> BatchList;
+
+    public:
+        StaticSpriteBuffer();
+        ~StaticSpriteBuffer();
+
+        // Builds batches from a sorted list of sprites and uploads their data.
+        // Can be called again to rebuild the buffer with different sprites.
+        bool Build(const Sprite::Info* spriteInfo, const Sprite::Data* spriteData, std::size_t spriteCount, const StaticBatchInfo& batchInfo = StaticBatchInfo());
+
+        // Clears all batches.
+        void Clear();
+
+        // Gets the instance buffer.
+        const InstanceBuffer& GetInstanceBuffer() const;
+
+        // Gets a batch.
+        const Batch& GetBatch(std::size_t index) const;
+
+        // Gets the number of batches.
+        std::size_t GetBatchCount() const;
+
+        // Gets the number of sprites.
+        std::size_t GetSpriteCount() const;
+
+    private:
+        // Instance buffer.
+        InstanceBuffer m_instanceBuffer;
+
+        // List of batches.
+        BatchList m_batches;
+
+        // Number of uploaded sprites.
+        std::size_t m_spriteCount;
+    };
+}
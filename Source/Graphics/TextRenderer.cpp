@@ -0,0 +1,247 @@
+#include "Precompiled.hpp"
+#include "TextRenderer.hpp"
+#include "Graphics/RenderCommandList.hpp"
+#include "Graphics/Font.hpp"
+#include "Graphics/Material.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Decodes the next UTF-8 codepoint and advances the iterator.
+    // Invalid sequences decode as a replacement character.
+    uint32_t DecodeCodepoint(const char*& it, const char* end)
+    {
+        uint8_t lead = (uint8_t)*it++;
+
+        if(lead < 0x80)
+            return lead;
+
+        int continuation = 0;
+        uint32_t codepoint = 0;
+
+        if((lead & 0xE0) == 0xC0)
+        {
+            continuation = 1;
+            codepoint = lead & 0x1F;
+        }
+        else if((lead & 0xF0) == 0xE0)
+        {
+            continuation = 2;
+            codepoint = lead & 0x0F;
+        }
+        else if((lead & 0xF8) == 0xF0)
+        {
+            continuation = 3;
+            codepoint = lead & 0x07;
+        }
+        else
+        {
+            return 0xFFFD;
+        }
+
+        for(int i = 0; i < continuation; ++i)
+        {
+            if(it == end || ((uint8_t)*it & 0xC0) != 0x80)
+                return 0xFFFD;
+
+            codepoint = (codepoint << 6) | ((uint8_t)*it++ & 0x3F);
+        }
+
+        return codepoint;
+    }
+}
+
+TextRendererInfo::TextRendererInfo() :
+    resourceManager(nullptr)
+{
+}
+
+TextRenderer::TextRenderer() :
+    m_resourceManager(nullptr),
+    m_glyphCount(0),
+    m_initialized(false)
+{
+}
+
+TextRenderer::~TextRenderer()
+{
+}
+
+bool TextRenderer::Initialize(const TextRendererInfo& info)
+{
+    Log() << "Initializing text renderer..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.resourceManager == nullptr)
+    {
+        LogError() << "Invalid argument - \"info.resourceManager\" is null!";
+        return false;
+    }
+
+    // Save the resource manager.
+    m_resourceManager = info.resourceManager;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void TextRenderer::QueueText(const Font* font, const std::string& text, const glm::vec2& position, const glm::vec4& color, float scale)
+{
+    // Skip text that would not be visible.
+    if(font == nullptr || !font->IsValid() || text.empty())
+        return;
+
+    // Append text to the shared buffer.
+    TextEntry entry;
+    entry.font = font;
+    entry.textOffset = m_text.size();
+    entry.textLength = text.size();
+    entry.position = position;
+    entry.color = color;
+    entry.scale = scale;
+
+    m_entries.push_back(entry);
+    m_text.append(text);
+}
+
+void TextRenderer::Flush(RenderCommandList& commandList, const glm::mat4& transform)
+{
+    Verify(m_initialized, "Instance has not been initialized!");
+
+    m_glyphCount = 0;
+
+    if(m_entries.empty())
+        return;
+
+    // Group entries by font while keeping their submission order.
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const TextEntry& a, const TextEntry& b)
+    {
+        return a.font < b.font;
+    });
+
+    // Lay out glyphs of each entry.
+    const Font* currentFont = m_entries.front().font;
+
+    for(const TextEntry& entry : m_entries)
+    {
+        // Draw glyphs of the previous font.
+        if(entry.font != currentFont)
+        {
+            this->DrawGlyphs(commandList, currentFont, transform);
+            currentFont = entry.font;
+        }
+
+        Sprite::Info info(this->GetFontMaterial(entry.font));
+
+        uint32_t color = glm::packUnorm4x8(entry.color);
+
+        glm::vec2 pen = entry.position;
+        uint32_t previous = 0;
+
+        const char* it = m_text.data() + entry.textOffset;
+        const char* end = it + entry.textLength;
+
+        while(it != end)
+        {
+            uint32_t codepoint = DecodeCodepoint(it, end);
+
+            // Move to the next line.
+            if(codepoint == '\n')
+            {
+                pen.x = entry.position.x;
+                pen.y -= entry.font->GetLineHeight() * entry.scale;
+                previous = 0;
+                continue;
+            }
+
+            // Get the glyph from the font cache.
+            // Missing glyphs and glyphs that do not fit in the atlas are skipped.
+            const Font::Glyph* glyph = entry.font->GetGlyph(codepoint);
+
+            if(glyph == nullptr)
+                continue;
+
+            // Apply kerning between glyph pairs.
+            if(previous != 0)
+            {
+                pen.x += entry.font->GetKerning(previous, codepoint) * entry.scale;
+            }
+
+            previous = codepoint;
+
+            // Add a sprite for visible glyphs.
+            if(glyph->rectangle.z > 0.0f && glyph->rectangle.w > 0.0f)
+            {
+                glm::vec2 corner;
+                corner.x = pen.x + glyph->offset.x * entry.scale;
+                corner.y = pen.y - (glyph->offset.y + glyph->rectangle.w) * entry.scale;
+
+                Sprite::Data data;
+                data.transform = glm::translate(glm::mat4(1.0f), glm::vec3(corner, 0.0f));
+                data.transform = glm::scale(data.transform, glm::vec3(entry.scale, entry.scale, 1.0f));
+                data.rectangle = glyph->rectangle;
+                data.diffuseColor = color;
+
+                m_spriteInfo.push_back(info);
+                m_spriteData.push_back(data);
+            }
+
+            pen.x += glyph->advance * entry.scale;
+        }
+    }
+
+    this->DrawGlyphs(commandList, currentFont, transform);
+
+    // Clear queued text.
+    m_entries.clear();
+    m_text.clear();
+}
+
+const Material* TextRenderer::GetFontMaterial(const Font* font)
+{
+    // Find an existing material.
+    // Material of a released font is replaced if another font has been loaded at its address.
+    Material::TexturePtr atlas = font->GetAtlas();
+    auto it = m_materials.find(font);
+
+    if(it != m_materials.end() && it->second->GetTexture() == atlas)
+        return it->second.get();
+
+    // Create a filtered and transparent material.
+    // Material shares the atlas, so recorded text keeps it alive after the font is released.
+    MaterialInfo materialInfo;
+    materialInfo.texture = atlas;
+    materialInfo.blendMode = BlendModes::Alpha;
+    materialInfo.textureFilter = GL_LINEAR;
+
+    MaterialPtr material = Material::Create(m_resourceManager, materialInfo);
+    m_materials[font] = material;
+
+    return material.get();
+}
+
+void TextRenderer::DrawGlyphs(RenderCommandList& commandList, const Font* font, const glm::mat4& transform)
+{
+    // Record all glyphs sharing the font atlas.
+    if(!m_spriteData.empty())
+    {
+        commandList.DrawSprites(m_spriteInfo.data(), m_spriteData.data(), m_spriteData.size(), transform);
+        m_glyphCount += m_spriteData.size();
+
+        m_spriteInfo.clear();
+        m_spriteData.clear();
+    }
+
+    // Allow recorded glyphs to be evicted once the frame has been drawn.
+    font->ReleaseGlyphs();
+}
+
+std::size_t TextRenderer::GetGlyphCount() const
+{
+    return m_glyphCount;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Sprite.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ResourceManager;
+}
+
+/*
+    Graphics Text Renderer
+
+    Queues text drawn during a frame and submits it in batches. Text is
+    grouped by font, so all strings sharing a font atlas are laid out into
+    sprites and recorded together as a single command per atlas. Glyphs
+    that do not fit in the atlas along with text of the frame in flight
+    are skipped, as the atlas cannot change while recorded text is still
+    drawn by the render thread. Each font atlas is drawn with its own
+    material.
+
+    void ExampleTextRenderer(Graphics::RenderCommandList& commandList, const Graphics::Font* font)
+    {
+        // Setup text renderer info.
+        Graphics::TextRendererInfo textRendererInfo;
+        textRendererInfo.resourceManager = &resourceManager;
+
+        // Queue text and record its drawing.
+        Graphics::TextRenderer textRenderer;
+        textRenderer.Initialize(textRendererInfo);
+        textRenderer.QueueText(font, "Hello world!", glm::vec2(10.0f, 710.0f));
+        textRenderer.Flush(commandList, transform);
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class RenderCommandList;
+    class Font;
+    class Material;
+
+    // Text renderer info structure.
+    struct TextRendererInfo
+    {
+        TextRendererInfo();
+
+        System::ResourceManager* resourceManager;
+    };
+
+    // Text renderer class.
+    class TextRenderer
+    {
+    public:
+        TextRenderer();
+        ~TextRenderer();
+
+        // Initializes the text renderer.
+        bool Initialize(const TextRendererInfo& info);
+
+        // Queues text to be drawn on the next flush.
+        // Position is the top left corner of the first line.
+        void QueueText(const Font* font, const std::string& text, const glm::vec2& position, const glm::vec4& color = glm::vec4(1.0f), float scale = 1.0f);
+
+        // Records drawing of all queued text in batches per font.
+        void Flush(RenderCommandList& commandList, const glm::mat4& transform);
+
+        // Gets the number of glyphs recorded by the last flush.
+        std::size_t GetGlyphCount() const;
+
+    private:
+        // Text entry structure.
+        struct TextEntry
+        {
+            const Font* font;
+            std::size_t textOffset;
+            std::size_t textLength;
+            glm::vec2 position;
+            glm::vec4 color;
+            float scale;
+        };
+
+        // Type declarations.
+        typedef std::vector<TextEntry> TextEntryList;
+        typedef std::shared_ptr<const Material> MaterialPtr;
+        typedef std::unordered_map<const Font*, MaterialPtr> MaterialList;
+        typedef std::vector<Sprite::Info> SpriteInfoList;
+        typedef std::vector<Sprite::Data> SpriteDataList;
+
+    private:
+        // Gets the material of a font atlas.
+        // Material is created on first use and kept for following frames.
+        const Material* GetFontMaterial(const Font* font);
+
+        // Records laid out glyph sprites and releases them in the font cache.
+        void DrawGlyphs(RenderCommandList& commandList, const Font* font, const glm::mat4& transform);
+
+    private:
+        // Resource manager.
+        System::ResourceManager* m_resourceManager;
+
+        // Font atlas materials.
+        // Materials share their atlases, which are retained along with them by recorded frames.
+        MaterialList m_materials;
+
+        // Queued text.
+        TextEntryList m_entries;
+        std::string m_text;
+
+        // Glyph sprites.
+        SpriteInfoList m_spriteInfo;
+        SpriteDataList m_spriteData;
+        std::size_t m_glyphCount;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
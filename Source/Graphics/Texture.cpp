@@ -1,5 +1,9 @@
 #include "Precompiled.hpp"
 #include "Texture.hpp"
+#include "Image.hpp"
+#include "TextureContainer.hpp"
+#include "TextureUploader.hpp"
+#include "StateCache.hpp"
 using namespace Graphics;
 
 namespace
@@ -7,13 +11,74 @@ namespace
     // Invalid types.
     const GLuint InvalidHandle = 0;
     const GLenum InvalidEnum = 0;
+
+    // Calculates the memory usage of a texture with a mipmap chain.
+    // Drivers commonly pad three channel texels to four bytes.
+    std::size_t CalculateMemoryUsage(int width, int height, GLenum format, int levelCount)
+    {
+        std::size_t texelSize = 4;
+
+        if(format == GL_RED)
+        {
+            texelSize = 1;
+        }
+        else if(format == GL_RG)
+        {
+            texelSize = 2;
+        }
+
+        std::size_t size = 0;
+
+        for(int i = 0; i < levelCount; ++i)
+        {
+            size += (std::size_t)width * height * texelSize;
+
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+
+        return size;
+    }
+
+    // Gets the number of levels of a full mipmap chain.
+    int CalculateLevelCount(int width, int height)
+    {
+        int levelCount = 1;
+        int size = std::max(width, height);
+
+        while(size > 1)
+        {
+            size /= 2;
+            ++levelCount;
+        }
+
+        return levelCount;
+    }
+
+    // Checks if the driver supports a compressed internal format.
+    bool IsCompressedFormatSupported(GLenum internalFormat)
+    {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &formatCount);
+
+        std::vector<GLint> formats(formatCount);
+
+        if(formatCount > 0)
+        {
+            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+        }
+
+        return std::find(formats.begin(), formats.end(), (GLint)internalFormat) != formats.end();
+    }
 }
 
 Texture::Texture() :
     m_handle(InvalidHandle),
     m_format(InvalidEnum),
     m_width(0),
-    m_height(0)
+    m_height(0),
+    m_memoryUsage(0),
+    m_pending(false)
 {
 }
 
@@ -28,6 +93,7 @@ void Texture::DestroyHandle()
     if(m_handle != InvalidHandle)
     {
         glDeleteTextures(1, &m_handle);
+        GetStateCache()->OnTextureDeleted(m_handle);
         m_handle = InvalidHandle;
     }
 }
@@ -39,215 +105,170 @@ bool Texture::Load(std::string filepath)
     // Check if handle has been already created.
     Verify(m_handle == InvalidHandle, "Texture instance has been already initialized!");
 
-    // Validate arguments.
-    if(filepath.empty())
-    {
-        LogError() << "Invalid argument - \"filepath\" is empty!";
-        return false;
-    }
+    // Read the whole file at once.
+    std::vector<char> content = Utility::GetBinaryFileContent(Build::GetWorkingDir() + filepath);
 
-    // Open the file stream.
-    std::ifstream file(Build::GetWorkingDir() + filepath, std::ios::binary);
-
-    if(!file.is_open())
+    if(content.empty())
     {
-        LogError() << "Could not open the file!";
+        LogError() << "Could not read the file!";
         return false;
     }
 
-    // Validate the file header.
-    const size_t png_sig_size = 8;
-    png_byte png_sig[png_sig_size];
+    // Create the texture straight from a cooked container.
+    if(TextureContainer::IsContainer(content.data(), content.size()))
+    {
+        TextureContainer container;
+        std::string error;
 
-    file.read((char*)png_sig, png_sig_size);
+        if(!container.Parse(std::move(content), &error))
+        {
+            LogError() << "Could not load the texture container! " << error;
+            return false;
+        }
 
-    if(png_sig_cmp(png_sig, 0, png_sig_size) != 0)
-    {
-        LogError() << "Filepath does not contain a valid PNG file!";
-        return false;
+        if(!this->Create(container))
+        {
+            LogError() << "Texture could not be created!";
+            return false;
+        }
     }
+    else
+    {
+        // Decode the image data.
+        Image image;
+        std::string error;
 
-    // Create format decoder structures.
-    png_structp png_read_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if(!image.Decode(content.data(), content.size(), &error))
+        {
+            LogError() << "Could not load the image! " << error;
+            return false;
+        }
 
-    if(png_read_ptr == nullptr)
-    {
-        LogError() << "Could not create PNG read structure!";
-        return false;
+        // Call the initialization method.
+        if(!this->Create(image.GetWidth(), image.GetHeight(), image.GetFormat(), image.GetData()))
+        {
+            LogError() << "Texture could not be created!";
+            return false;
+        }
     }
 
-    png_infop png_info_ptr = png_create_info_struct(png_read_ptr);
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+bool Texture::LoadAsync(std::string filepath, std::shared_ptr<const Texture> placeholder, TextureUploader* uploader)
+{
+    Log() << "Queuing texture load from \"" << filepath << "\" file..." << LogIndent();
 
-    if(png_info_ptr == nullptr)
+    // Check if handle has been already created.
+    Verify(m_handle == InvalidHandle, "Texture instance has been already initialized!");
+    Verify(!m_pending, "Texture instance is already being loaded!");
+
+    // Validate arguments.
+    if(filepath.empty())
     {
-        LogError() << "Could not create PNG info structure!";
+        LogError() << "Invalid argument - \"filepath\" is empty!";
         return false;
     }
 
-    SCOPE_GUARD_BEGIN();
+    if(placeholder == nullptr || !placeholder->IsValid())
     {
-        png_destroy_read_struct(&png_read_ptr, &png_info_ptr, nullptr);
+        LogError() << "Invalid argument - \"placeholder\" is invalid!";
+        return false;
     }
-    SCOPE_GUARD_END();
 
-    // Declare file read function.
-    auto png_read_function = [](png_structp png_ptr, png_bytep data, png_size_t length) -> void
-    {
-        std::ifstream* stream = (std::ifstream*)png_get_io_ptr(png_ptr);
-        stream->read((char*)data, length);
-    };
-
-    // Declare image buffers.
-    png_bytep* png_row_ptrs = nullptr;
-    png_byte* png_data_ptr = nullptr;
-
-    SCOPE_GUARD_BEGIN();
-    {
-        delete[] png_row_ptrs;
-        delete[] png_data_ptr;
-    }
-    SCOPE_GUARD_END();
-
-    // Setup the error handling routine.
-    // Apparently a standard way of handling errors with libpng...
-    // Library jumps here if one of its functions encounters an error!!!
-    // This is the reason why scope guards and other objects are declared
-    // before this call. Be aware of how dangerous it is to do in C++.
-    // For e.g. objects created past this line will not have their
-    // destructors called if the library jumps back here on an error.
-    if(setjmp(png_jmpbuf(png_read_ptr)))
+    if(uploader == nullptr)
     {
-        LogError() << "Error occurred while reading the file!";
+        LogError() << "Invalid argument - \"uploader\" is null!";
         return false;
     }
 
-    // Setup the file read function.
-    png_set_read_fn(png_read_ptr, (png_voidp)&file, png_read_function);
+    // Stand in for the placeholder until uploaded.
+    m_placeholder = placeholder;
+    m_pending = true;
 
-    // Set the amount of already read signature bytes.
-    png_set_sig_bytes(png_read_ptr, png_sig_size);
+    // Queue decoding and upload of the image.
+    // Uploader keeps the texture alive until it is finished.
+    uploader->Queue(this->shared_from_this(), filepath);
 
-    // Read image info.
-    png_read_info(png_read_ptr, png_info_ptr);
-
-    png_uint_32 width = png_get_image_width(png_read_ptr, png_info_ptr);
-    png_uint_32 height = png_get_image_height(png_read_ptr, png_info_ptr);
-    png_uint_32 depth = png_get_bit_depth(png_read_ptr, png_info_ptr);
-    png_uint_32 channels = png_get_channels(png_read_ptr, png_info_ptr);
-    png_uint_32 format = png_get_color_type(png_read_ptr, png_info_ptr);
+    return true;
+}
 
-    // Process different format types.
-    switch(format)
-    {
-    case PNG_COLOR_TYPE_GRAY:
-    case PNG_COLOR_TYPE_GRAY_ALPHA:
-        if(depth < 8)
-        {
-            // Convert gray scale image to single 8bit channel.
-            png_set_expand_gray_1_2_4_to_8(png_read_ptr);
-            depth = 8;
-        }
-        break;
+void Texture::FinishPending()
+{
+    Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
 
-    case PNG_COLOR_TYPE_PALETTE:
-        {
-            // Convert indexed palette to RGB.
-            png_set_palette_to_rgb(png_read_ptr);
-            channels = 3;
+    m_pending.store(false, std::memory_order_release);
+}
 
-            // Create alpha channel if pallete has transparency.
-            if(png_get_valid(png_read_ptr, png_info_ptr, PNG_INFO_tRNS))
-            {
-                png_set_tRNS_to_alpha(png_read_ptr);
-                channels += 1;
-            }
-        }
-        break;
+bool Texture::Create(int width, int height, GLenum format, const void* data)
+{
+    Log() << "Creating texture..." << LogIndent();
 
-    case PNG_COLOR_TYPE_RGB:
-    case PNG_COLOR_TYPE_RGBA:
-        break;
+    // Check if handle has been already created.
+    Verify(m_handle == InvalidHandle, "Texture instance has been already initialized!");
 
-    default:
-        LogError() << "Unsupported image format!";
-        return false;
-    }
+    // Setup a cleanup guard.
+    bool initialized = false;
 
-    // Make sure we only get 8bits per channel.
-    if(depth == 16)
+    // Validate arguments.
+    if(width <= 0)
     {
-        png_set_strip_16(png_read_ptr);
+        LogError() << "Invalid argument - \"width\" is invalid.";
+        return false;
     }
 
-    if(depth != 8)
+    if(height <= 0)
     {
-        LogError() << "Unsupported image depth size!";
+        LogError() << "Invalid argument - \"height\" is invalid.";
         return false;
     }
 
-    // Allocate image buffers.
-    png_row_ptrs = new png_bytep[height];
-    png_data_ptr = new png_byte[width * height * channels];
+    // Create a texture handle.
+    SCOPE_GUARD_IF(!initialized, this->DestroyHandle());
 
-    // Setup an array of row pointers to the actual data buffer.
-    png_uint_32 png_stride = width * channels;
+    glGenTextures(1, &m_handle);
 
-    for(png_uint_32 i = 0; i < height; ++i)
+    if(m_handle == InvalidHandle)
     {
-        // Reverse the order of rows to flip the image.
-        // This is done because OpenGL's texture coordinates are also flipped.
-        png_uint_32 png_row_index = height - i - 1;
-
-        // Assemble an array of row pointers.
-        png_uint_32 png_offset = i * png_stride;
-        png_row_ptrs[png_row_index] = png_data_ptr + png_offset;
+        LogError() << "Could not create a texture!";
+        return false;
     }
 
-    // Read image data.
-    png_read_image(png_read_ptr, png_row_ptrs);
-
-    // Determine the texture format.
-    GLenum textureFormat = GL_NONE;
+    // Bind the texture.
+    GetStateCache()->BindTexture(GL_TEXTURE_2D, m_handle);
 
-    switch(channels)
+    // Set packing aligment for provided data.
+    /*
+    if(format == GL_R || format == GL_RED)
     {
-    case 1:
-        textureFormat = GL_R;
-        break;
-
-    case 2:
-        textureFormat = GL_RG;
-        break;
-
-    case 3:
-        textureFormat = GL_RGB;
-        break;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+    */
 
-    case 4:
-        textureFormat = GL_RGBA;
-        break;
+    // Allocated a texture surface on the hardware.
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 
-    default:
-        LogError() << "Unsupported number of channels!";
-        return false;
-    }
+    // Generate texture mipmap.
+    glGenerateMipmap(GL_TEXTURE_2D);
 
-    // Call the initialization method.
-    if(!this->Create(width, height, textureFormat, png_data_ptr))
-    {
-        LogError() << "Texture could not be created!";
-        return false;
-    }
+    // Save texture parameters.
+    m_format = format;
+    m_width = width;
+    m_height = height;
+    m_memoryUsage = CalculateMemoryUsage(width, height, format, CalculateLevelCount(width, height));
 
     // Success!
     LogInfo() << "Success!";
 
-    return true;
+    return initialized = true;
 }
 
-bool Texture::Create(int width, int height, GLenum format, const void* data)
+bool Texture::Create(const TextureContainer& container)
 {
-    Log() << "Creating texture..." << LogIndent();
+    Log() << "Creating texture from container..." << LogIndent();
 
     // Check if handle has been already created.
     Verify(m_handle == InvalidHandle, "Texture instance has been already initialized!");
@@ -256,15 +277,15 @@ bool Texture::Create(int width, int height, GLenum format, const void* data)
     bool initialized = false;
 
     // Validate arguments.
-    if(width <= 0)
+    if(!container.IsValid())
     {
-        LogError() << "Invalid argument - \"width\" is invalid.";
+        LogError() << "Invalid argument - \"container\" is invalid!";
         return false;
     }
 
-    if(height <= 0)
+    if(container.IsCompressed() && !IsCompressedFormatSupported(container.GetInternalFormat()))
     {
-        LogError() << "Invalid argument - \"height\" is invalid.";
+        LogError() << "Compressed format of the container is not supported!";
         return false;
     }
 
@@ -280,29 +301,64 @@ bool Texture::Create(int width, int height, GLenum format, const void* data)
     }
 
     // Bind the texture.
-    glBindTexture(GL_TEXTURE_2D, m_handle);
+    GetStateCache()->BindTexture(GL_TEXTURE_2D, m_handle);
 
-    // Set packing aligment for provided data.
-    /*
-    if(format == GL_R || format == GL_RED)
+    // Allocate immutable storage for all levels at once if supported.
+    const GLenum internalFormat = container.GetInternalFormat();
+    const GLenum format = container.GetFormat();
+    const int levelCount = container.GetLevelCount();
+
+    const bool immutable = GLEW_ARB_texture_storage != GL_FALSE;
+
+    if(immutable)
     {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, container.GetWidth(), container.GetHeight());
     }
-    */
 
-    // Allocated a texture surface on the hardware.
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    // Upload cooked levels as they are.
+    // Rows of levels are tightly packed.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    // Generate texture mipmap.
-    glGenerateMipmap(GL_TEXTURE_2D);
+    for(int i = 0; i < levelCount; ++i)
+    {
+        const TextureContainer::Level& level = container.GetLevel(i);
 
-    // Unbind the texture.
-    glBindTexture(GL_TEXTURE_2D, 0);
+        if(container.IsCompressed())
+        {
+            if(immutable)
+            {
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, internalFormat, (GLsizei)level.size, level.data);
+            }
+            else
+            {
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, (GLsizei)level.size, level.data);
+            }
+        }
+        else
+        {
+            if(immutable)
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, format, GL_UNSIGNED_BYTE, level.data);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, format, GL_UNSIGNED_BYTE, level.data);
+            }
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Sample only levels present in the container.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
 
     // Save texture parameters.
-    m_format = format;
-    m_width = width;
-    m_height = height;
+    // Compressed textures cannot be updated, so they have no pixel format.
+    m_format = container.IsCompressed() ? InvalidEnum : format;
+    m_width = container.GetWidth();
+    m_height = container.GetHeight();
+    m_memoryUsage = container.IsCompressed() ? container.GetDataSize() :
+        CalculateMemoryUsage(m_width, m_height, format, levelCount);
 
     // Success!
     LogInfo() << "Success!";
@@ -313,16 +369,35 @@ bool Texture::Create(int width, int height, GLenum format, const void* data)
 void Texture::Update(const void* data)
 {
     Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
+    Verify(m_format != InvalidEnum, "Compressed texture cannot be updated!");
     Verify(data != nullptr, "Invalid argument - \"data\" is null!");
 
     // Upload new texture data.
-    glBindTexture(GL_TEXTURE_2D, m_handle);
+    GetStateCache()->BindTexture(GL_TEXTURE_2D, m_handle);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, m_format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::UpdateRegion(int x, int y, int width, int height, const void* data)
+{
+    Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
+    Verify(m_format != InvalidEnum, "Compressed texture cannot be updated!");
+    Verify(data != nullptr, "Invalid argument - \"data\" is null!");
+    Verify(x >= 0 && y >= 0 && x + width <= m_width && y + height <= m_height, "Region is out of texture bounds!");
+
+    // Upload new data of the region.
+    // Rows of narrow regions are not aligned to four bytes.
+    GetStateCache()->BindTexture(GL_TEXTURE_2D, m_handle);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, m_format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
 GLuint Texture::GetHandle() const
 {
+    if(m_pending.load(std::memory_order_acquire))
+        return m_placeholder->GetHandle();
+
     Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
 
     return m_handle;
@@ -330,6 +405,9 @@ GLuint Texture::GetHandle() const
 
 int Texture::GetWidth() const
 {
+    if(m_pending.load(std::memory_order_acquire))
+        return m_placeholder->GetWidth();
+
     Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
 
     return m_width;
@@ -337,12 +415,28 @@ int Texture::GetWidth() const
 
 int Texture::GetHeight() const
 {
+    if(m_pending.load(std::memory_order_acquire))
+        return m_placeholder->GetHeight();
+
     Verify(m_handle != InvalidHandle, "Texture handle has not been created!");
 
     return m_height;
 }
 
+std::size_t Texture::GetMemoryUsage() const
+{
+    return m_memoryUsage;
+}
+
 bool Texture::IsValid() const
 {
+    if(m_pending.load(std::memory_order_acquire))
+        return true;
+
     return m_handle != InvalidHandle;
 }
+
+bool Texture::IsPending() const
+{
+    return m_pending.load(std::memory_order_acquire);
+}
@@ -6,7 +6,14 @@
     Graphics Texture
     
     Encapsulates an OpenGL texture object.
-    Can also load images from PNG files.
+    Can also load images from PNG files and texture containers cooked
+    offline, which are detected by their signature. Cooked containers
+    skip image decoding and mipmap generation at runtime.
+
+    Textures loaded asynchronously stand in for a placeholder texture
+    until their image is decoded on a worker thread and uploaded by the
+    texture uploader. Getters return the placeholder's values meanwhile,
+    so pending textures can be drawn right away.
     
     void ExampleGraphicsTexture()
     {
@@ -17,13 +24,27 @@
         // Retrieve the OpenGL handle.
         GLuint handle = texture.GetHandle();
     }
+
+    void ExampleGraphicsTextureAsync(System::ResourceManager& resourceManager, Graphics::TextureUploader& uploader)
+    {
+        // Start loading a texture that is drawn as the default one until uploaded.
+        auto texture = resourceManager.LoadAsync<Graphics::Texture>("image.png", &uploader);
+    }
 */
 
 namespace Graphics
 {
+    // Forward declarations.
+    class TextureUploader;
+    class TextureContainer;
+
     // Texture class.
-    class Texture
+    class Texture : public std::enable_shared_from_this<Texture>
     {
+    public:
+        // Friend declarations.
+        friend TextureUploader;
+
     public:
         Texture();
         ~Texture();
@@ -31,12 +52,23 @@ namespace Graphics
         // Loads the texture from a file.
         bool Load(std::string filepath);
 
+        // Starts loading the texture from a file in the background.
+        // Texture has to be owned by a shared pointer and stands in for the placeholder until uploaded.
+        bool LoadAsync(std::string filepath, std::shared_ptr<const Texture> placeholder, TextureUploader* uploader);
+
         // Initializes the texture instance.
         bool Create(int width, int height, GLenum format, const void* data);
 
+        // Initializes the texture instance from a cooked container.
+        bool Create(const TextureContainer& container);
+
         // Updates the texture data.
         void Update(const void* data);
 
+        // Updates a rectangular region of the texture data.
+        // Data has to match the texture's format and be tightly packed.
+        void UpdateRegion(int x, int y, int width, int height, const void* data);
+
         // Gets the texture's handle.
         GLuint GetHandle() const;
 
@@ -46,13 +78,24 @@ namespace Graphics
         // Gets the texture's height.
         int GetHeight() const;
 
+        // Gets the estimated video memory usage in bytes, including mipmaps.
+        // Pending textures do not use any memory until uploaded.
+        std::size_t GetMemoryUsage() const;
+
         // Checks if the texture instance is valid.
         bool IsValid() const;
 
+        // Checks if the texture is still waiting for its asynchronous upload.
+        bool IsPending() const;
+
     private:
         // Destroys the internal handle.
         void DestroyHandle();
 
+        // Stops standing in for the placeholder.
+        // Called by the uploader once the uploaded texture is visible to other contexts.
+        void FinishPending();
+
     private:
         // Texture handle.
         GLuint m_handle;
@@ -61,6 +104,11 @@ namespace Graphics
         GLenum m_format;
         int m_width;
         int m_height;
-        
+        std::size_t m_memoryUsage;
+
+        // Asynchronous loading state.
+        // Render thread reads the pending flag while the main thread finishes the upload.
+        std::shared_ptr<const Texture> m_placeholder;
+        std::atomic<bool> m_pending;
     };
 }
@@ -0,0 +1,447 @@
+#include "Precompiled.hpp"
+#include "TextureContainer.hpp"
+#include "Image.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Invalid types.
+    const GLenum InvalidEnum = 0;
+
+    // File format constants.
+    const char Signature[4] = { 'T', 'E', 'X', 'C' };
+    const uint32_t Version = 1;
+    const uint32_t MaxLevelCount = 32;
+
+    // File header structure.
+    // Pixel format is zero for compressed levels.
+    struct FileHeader
+    {
+        char signature[4];
+        uint32_t version;
+        uint32_t internalFormat;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+        uint32_t reserved;
+    };
+
+    // File level structure.
+    // Offset is relative to the beginning of the file.
+    struct FileLevel
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    // Gets the number of channels of a pixel format.
+    int GetFormatChannels(GLenum format)
+    {
+        switch(format)
+        {
+        case GL_RED:
+            return 1;
+
+        case GL_RG:
+            return 2;
+
+        case GL_RGB:
+            return 3;
+
+        case GL_RGBA:
+            return 4;
+        }
+
+        return 0;
+    }
+
+    // Gets the sized internal format of a pixel format.
+    GLenum GetSizedFormat(GLenum format)
+    {
+        switch(format)
+        {
+        case GL_RED:
+            return GL_R8;
+
+        case GL_RG:
+            return GL_RG8;
+
+        case GL_RGB:
+            return GL_RGB8;
+
+        case GL_RGBA:
+            return GL_RGBA8;
+        }
+
+        return InvalidEnum;
+    }
+
+    // Sets an error message if requested.
+    bool SetError(std::string* error, const char* message)
+    {
+        if(error != nullptr)
+        {
+            *error = message;
+        }
+
+        return false;
+    }
+}
+
+TextureContainer::TextureContainer() :
+    m_internalFormat(InvalidEnum),
+    m_format(InvalidEnum),
+    m_width(0),
+    m_height(0)
+{
+}
+
+TextureContainer::~TextureContainer()
+{
+}
+
+void TextureContainer::Reset()
+{
+    m_content.clear();
+    m_levels.clear();
+
+    m_internalFormat = InvalidEnum;
+    m_format = InvalidEnum;
+    m_width = 0;
+    m_height = 0;
+}
+
+bool TextureContainer::Load(std::string filepath)
+{
+    Log() << "Loading texture container from \"" << filepath << "\" file..." << LogIndent();
+
+    // Check if container has been already created.
+    Verify(!this->IsValid(), "Texture container instance has been already initialized!");
+
+    // Validate arguments.
+    if(filepath.empty())
+    {
+        LogError() << "Invalid argument - \"filepath\" is empty!";
+        return false;
+    }
+
+    // Read the whole file at once.
+    std::vector<char> content = Utility::GetBinaryFileContent(Build::GetWorkingDir() + filepath);
+
+    if(content.empty())
+    {
+        LogError() << "Could not read the file!";
+        return false;
+    }
+
+    // Parse the file content.
+    std::string error;
+
+    if(!this->Parse(std::move(content), &error))
+    {
+        LogError() << error;
+        return false;
+    }
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+bool TextureContainer::Parse(std::vector<char> content, std::string* error)
+{
+    // Check if container has been already created.
+    Verify(!this->IsValid(), "Texture container instance has been already initialized!");
+
+    // Setup a cleanup guard.
+    bool initialized = false;
+
+    SCOPE_GUARD_IF(!initialized, this->Reset());
+
+    // Read the file header.
+    if(!IsContainer(content.data(), content.size()) || content.size() < sizeof(FileHeader))
+        return SetError(error, "File is not a texture container!");
+
+    FileHeader header;
+    std::memcpy(&header, content.data(), sizeof(FileHeader));
+
+    if(header.version != Version)
+        return SetError(error, "Texture container version is not supported!");
+
+    if(header.width == 0 || header.height == 0 || header.internalFormat == InvalidEnum)
+        return SetError(error, "Texture container header is invalid!");
+
+    if(header.levelCount == 0 || header.levelCount > MaxLevelCount)
+        return SetError(error, "Texture container has invalid number of levels!");
+
+    bool compressed = header.format == InvalidEnum;
+    int channels = GetFormatChannels(header.format);
+
+    if(!compressed && channels == 0)
+        return SetError(error, "Texture container has unsupported pixel format!");
+
+    // Read the level table.
+    std::size_t tableEnd = sizeof(FileHeader) + header.levelCount * sizeof(FileLevel);
+
+    if(content.size() < tableEnd)
+        return SetError(error, "Texture container level table is truncated!");
+
+    m_levels.reserve(header.levelCount);
+
+    for(uint32_t i = 0; i < header.levelCount; ++i)
+    {
+        FileLevel entry;
+        std::memcpy(&entry, content.data() + sizeof(FileHeader) + i * sizeof(FileLevel), sizeof(FileLevel));
+
+        // Check that the level lies within the file.
+        if(entry.width == 0 || entry.height == 0)
+            return SetError(error, "Texture container level has invalid dimensions!");
+
+        if((uint64_t)entry.offset + entry.size > content.size())
+            return SetError(error, "Texture container level is out of file bounds!");
+
+        // Check that uncompressed levels have tightly packed rows.
+        if(!compressed && (uint64_t)entry.width * entry.height * channels != entry.size)
+            return SetError(error, "Texture container level has invalid size!");
+
+        // Level data points into the content, which is moved without reallocation.
+        Level level;
+        level.width = (int)entry.width;
+        level.height = (int)entry.height;
+        level.data = reinterpret_cast<const uint8_t*>(content.data()) + entry.offset;
+        level.size = entry.size;
+
+        m_levels.push_back(level);
+    }
+
+    // Save container parameters.
+    m_content = std::move(content);
+    m_internalFormat = header.internalFormat;
+    m_format = header.format;
+    m_width = (int)header.width;
+    m_height = (int)header.height;
+
+    return initialized = true;
+}
+
+bool TextureContainer::Cook(const Image& image, bool mipmaps)
+{
+    Log() << "Cooking texture container..." << LogIndent();
+
+    // Check if container has been already created.
+    Verify(!this->IsValid(), "Texture container instance has been already initialized!");
+
+    // Validate arguments.
+    if(!image.IsValid())
+    {
+        LogError() << "Invalid argument - \"image\" is invalid!";
+        return false;
+    }
+
+    // Determine the number of levels.
+    const int channels = image.GetChannels();
+
+    uint32_t levelCount = 1;
+
+    if(mipmaps)
+    {
+        int size = std::max(image.GetWidth(), image.GetHeight());
+
+        while(size > 1)
+        {
+            size /= 2;
+            ++levelCount;
+        }
+    }
+
+    // Lay out the file.
+    // Levels are aligned to four bytes, following the header and the level table.
+    std::vector<FileLevel> entries(levelCount);
+
+    std::size_t offset = sizeof(FileHeader) + levelCount * sizeof(FileLevel);
+    int width = image.GetWidth();
+    int height = image.GetHeight();
+
+    for(FileLevel& entry : entries)
+    {
+        offset = (offset + 3) & ~(std::size_t)3;
+
+        entry.width = (uint32_t)width;
+        entry.height = (uint32_t)height;
+        entry.offset = (uint32_t)offset;
+        entry.size = (uint32_t)(width * height * channels);
+
+        offset += entry.size;
+
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    if(offset > std::numeric_limits<uint32_t>::max())
+    {
+        LogError() << "Image is too large for a texture container!";
+        return false;
+    }
+
+    // Write the header and the level table.
+    std::vector<char> content(offset, 0);
+
+    FileHeader header;
+    std::memcpy(header.signature, Signature, sizeof(Signature));
+    header.version = Version;
+    header.internalFormat = GetSizedFormat(image.GetFormat());
+    header.format = image.GetFormat();
+    header.width = (uint32_t)image.GetWidth();
+    header.height = (uint32_t)image.GetHeight();
+    header.levelCount = levelCount;
+    header.reserved = 0;
+
+    std::memcpy(content.data(), &header, sizeof(FileHeader));
+    std::memcpy(content.data() + sizeof(FileHeader), entries.data(), entries.size() * sizeof(FileLevel));
+
+    // Copy the base level.
+    // Image rows are already stored from the bottom to the top.
+    std::memcpy(content.data() + entries[0].offset, image.GetData(), entries[0].size);
+
+    // Downsample each level from the previous one.
+    // Odd rows and columns are folded into the last texel.
+    for(uint32_t i = 1; i < levelCount; ++i)
+    {
+        const FileLevel& source = entries[i - 1];
+        const FileLevel& target = entries[i];
+
+        const uint8_t* sourceData = reinterpret_cast<const uint8_t*>(content.data()) + source.offset;
+        uint8_t* targetData = reinterpret_cast<uint8_t*>(content.data()) + target.offset;
+
+        for(uint32_t y = 0; y < target.height; ++y)
+        {
+            uint32_t y0 = std::min(y * 2, source.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+
+            for(uint32_t x = 0; x < target.width; ++x)
+            {
+                uint32_t x0 = std::min(x * 2, source.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+
+                for(int c = 0; c < channels; ++c)
+                {
+                    uint32_t sum = sourceData[(y0 * source.width + x0) * channels + c] +
+                        sourceData[(y0 * source.width + x1) * channels + c] +
+                        sourceData[(y1 * source.width + x0) * channels + c] +
+                        sourceData[(y1 * source.width + x1) * channels + c];
+
+                    targetData[(y * target.width + x) * channels + c] = (uint8_t)((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    // Parse the written content, which also validates it.
+    std::string error;
+
+    if(!this->Parse(std::move(content), &error))
+    {
+        LogError() << error;
+        return false;
+    }
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+bool TextureContainer::Save(std::string filepath) const
+{
+    Log() << "Saving texture container to \"" << filepath << "\" file..." << LogIndent();
+
+    Verify(this->IsValid(), "Texture container has not been initialized!");
+
+    // Write the whole content at once.
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+
+    if(!file)
+    {
+        LogError() << "Could not open the file!";
+        return false;
+    }
+
+    file.write(m_content.data(), m_content.size());
+
+    if(!file)
+    {
+        LogError() << "Could not write the file!";
+        return false;
+    }
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return true;
+}
+
+bool TextureContainer::IsContainer(const void* data, std::size_t size)
+{
+    if(data == nullptr || size < sizeof(Signature))
+        return false;
+
+    return std::memcmp(data, Signature, sizeof(Signature)) == 0;
+}
+
+const TextureContainer::Level& TextureContainer::GetLevel(int index) const
+{
+    Verify(index >= 0 && index < (int)m_levels.size(), "Invalid argument - \"index\" is out of range!");
+
+    return m_levels[index];
+}
+
+int TextureContainer::GetLevelCount() const
+{
+    return (int)m_levels.size();
+}
+
+std::size_t TextureContainer::GetDataSize() const
+{
+    std::size_t size = 0;
+
+    for(const Level& level : m_levels)
+    {
+        size += level.size;
+    }
+
+    return size;
+}
+
+GLenum TextureContainer::GetInternalFormat() const
+{
+    return m_internalFormat;
+}
+
+GLenum TextureContainer::GetFormat() const
+{
+    return m_format;
+}
+
+int TextureContainer::GetWidth() const
+{
+    return m_width;
+}
+
+int TextureContainer::GetHeight() const
+{
+    return m_height;
+}
+
+bool TextureContainer::IsCompressed() const
+{
+    return this->IsValid() && m_format == InvalidEnum;
+}
+
+bool TextureContainer::IsValid() const
+{
+    return !m_levels.empty();
+}
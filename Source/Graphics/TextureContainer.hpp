@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    Graphics Texture Container
+
+    Holds texture data in a GPU ready file format produced offline by
+    the texture cooker. File starts with a header describing the sized
+    internal format, followed by a table of mipmap levels. Levels are
+    stored with tightly packed rows, already flipped to match OpenGL's
+    texture coordinates, so they can be passed to the driver as they are.
+    Levels can also hold compressed blocks produced by external tools.
+
+    void ExampleGraphicsTextureContainer()
+    {
+        // Cook a container from an image.
+        Graphics::Image image;
+        image.Load("image.png");
+
+        Graphics::TextureContainer container;
+        container.Cook(image, true);
+        container.Save("image.tex");
+
+        // Create a texture from a cooked container.
+        Graphics::TextureContainer cooked;
+        cooked.Load("image.tex");
+
+        Graphics::Texture texture;
+        texture.Create(cooked);
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class Image;
+
+    // Texture container class.
+    class TextureContainer
+    {
+    public:
+        // Mipmap level structure.
+        // Data points into the file content held by the container.
+        struct Level
+        {
+            int width;
+            int height;
+            const uint8_t* data;
+            std::size_t size;
+        };
+
+    public:
+        TextureContainer();
+        ~TextureContainer();
+
+        // Loads the container from a file.
+        bool Load(std::string filepath);
+
+        // Parses the container from file content.
+        // Does not log, so it can be called from worker threads.
+        bool Parse(std::vector<char> content, std::string* error = nullptr);
+
+        // Cooks the container from an image.
+        // Builds the whole mipmap chain with a box filter if requested.
+        bool Cook(const Image& image, bool mipmaps);
+
+        // Saves the container to a file.
+        bool Save(std::string filepath) const;
+
+        // Checks if file content starts with the container signature.
+        static bool IsContainer(const void* data, std::size_t size);
+
+        // Gets a mipmap level.
+        const Level& GetLevel(int index) const;
+
+        // Gets the number of mipmap levels.
+        int GetLevelCount() const;
+
+        // Gets the size of all mipmap levels in bytes.
+        std::size_t GetDataSize() const;
+
+        // Gets the sized internal format.
+        GLenum GetInternalFormat() const;
+
+        // Gets the pixel format of uncompressed levels.
+        GLenum GetFormat() const;
+
+        // Gets the width of the base level.
+        int GetWidth() const;
+
+        // Gets the height of the base level.
+        int GetHeight() const;
+
+        // Checks if levels hold compressed blocks.
+        bool IsCompressed() const;
+
+        // Checks if the container instance is valid.
+        bool IsValid() const;
+
+    private:
+        // Releases container data.
+        void Reset();
+
+    private:
+        // File content.
+        std::vector<char> m_content;
+
+        // Mipmap levels.
+        std::vector<Level> m_levels;
+
+        // Texture parameters.
+        GLenum m_internalFormat;
+        GLenum m_format;
+        int m_width;
+        int m_height;
+    };
+}
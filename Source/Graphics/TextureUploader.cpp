@@ -0,0 +1,272 @@
+#include "Precompiled.hpp"
+#include "TextureUploader.hpp"
+#include "Texture.hpp"
+#include "StateCache.hpp"
+#include "System/ThreadPool.hpp"
+using namespace Graphics;
+
+namespace
+{
+    // Invalid types.
+    const GLuint InvalidHandle = 0;
+}
+
+TextureUploaderInfo::TextureUploaderInfo() :
+    threadPool(nullptr),
+    uploadBudget(4 * 1024 * 1024)
+{
+}
+
+TextureUploader::TextureUploader() :
+    m_threadPool(nullptr),
+    m_pixelBuffer(InvalidHandle),
+    m_uploadBudget(0),
+    m_uploadedBytes(0),
+    m_initialized(false)
+{
+}
+
+TextureUploader::~TextureUploader()
+{
+    // Wait for workers that still decode images.
+    for(Upload& upload : m_decoding)
+    {
+        if(upload.decoded.valid())
+        {
+            upload.decoded.wait();
+        }
+    }
+
+    this->DestroyObjects();
+}
+
+void TextureUploader::DestroyObjects()
+{
+    // Delete fences of unfinished uploads.
+    for(Upload& upload : m_uploaded)
+    {
+        glDeleteSync(upload.fence);
+    }
+
+    m_uploaded.clear();
+
+    // Delete the pixel buffer.
+    if(m_pixelBuffer != InvalidHandle)
+    {
+        glDeleteBuffers(1, &m_pixelBuffer);
+        m_pixelBuffer = InvalidHandle;
+    }
+}
+
+bool TextureUploader::Initialize(const TextureUploaderInfo& info)
+{
+    Log() << "Initializing texture uploader..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Texture uploader instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.threadPool == nullptr)
+    {
+        LogError() << "Invalid argument - \"threadPool\" is null!";
+        return false;
+    }
+
+    if(info.uploadBudget == 0)
+    {
+        LogError() << "Invalid argument - \"uploadBudget\" is zero!";
+        return false;
+    }
+
+    // Create a pixel buffer.
+    // Its storage is allocated for each upload.
+    glGenBuffers(1, &m_pixelBuffer);
+
+    if(m_pixelBuffer == InvalidHandle)
+    {
+        LogError() << "Could not create a pixel buffer!";
+        return false;
+    }
+
+    SCOPE_GUARD_IF(!m_initialized, this->DestroyObjects());
+
+    // Save instance references.
+    m_threadPool = info.threadPool;
+    m_uploadBudget = info.uploadBudget;
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void TextureUploader::Queue(std::shared_ptr<Texture> texture, std::string filepath)
+{
+    Verify(m_initialized, "Texture uploader has not been initialized!");
+    Verify(texture != nullptr, "Invalid argument - \"texture\" is null!");
+
+    // Decode the image on a worker thread.
+    // Workers cannot log, so errors are reported once the result is collected.
+    std::string path = Build::GetWorkingDir() + filepath;
+
+    Upload upload;
+    upload.texture = std::move(texture);
+    upload.filepath = std::move(filepath);
+    upload.fence = nullptr;
+    upload.decoded = m_threadPool->Submit([path]()
+    {
+        auto decoded = std::make_unique<DecodedImage>();
+
+        std::vector<char> content = Utility::GetBinaryFileContent(path);
+
+        if(content.empty())
+        {
+            decoded->error = "Could not read the file!";
+        }
+        else if(TextureContainer::IsContainer(content.data(), content.size()))
+        {
+            decoded->container.Parse(std::move(content), &decoded->error);
+        }
+        else
+        {
+            decoded->image.Decode(content.data(), content.size(), &decoded->error);
+        }
+
+        return decoded;
+    });
+
+    m_decoding.push_back(std::move(upload));
+}
+
+void TextureUploader::Update()
+{
+    Verify(m_initialized, "Texture uploader has not been initialized!");
+
+    // Finish textures that have been uploaded in previous updates.
+    // Flushing makes sure that fences get signaled eventually.
+    auto it = m_uploaded.begin();
+
+    while(it != m_uploaded.end())
+    {
+        GLenum result = glClientWaitSync(it->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+        if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        {
+            glDeleteSync(it->fence);
+            it->texture->FinishPending();
+
+            it = m_uploaded.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Upload decoded images in order of requests within the budget.
+    m_uploadedBytes = 0;
+
+    while(!m_decoding.empty())
+    {
+        Upload& upload = m_decoding.front();
+
+        // Collect the decoded image.
+        // Stop at the first image that is still being decoded.
+        if(upload.result == nullptr)
+        {
+            if(upload.decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                break;
+
+            upload.result = upload.decoded.get();
+        }
+
+        const Image& image = upload.result->image;
+        const TextureContainer& container = upload.result->container;
+
+        if(!image.IsValid() && !container.IsValid())
+        {
+            // Failed textures keep standing in for their placeholders.
+            LogError() << "Could not load texture from \"" << upload.filepath << "\" file! " << upload.result->error;
+
+            m_decoding.pop_front();
+            continue;
+        }
+
+        // Defer the upload to the next update if it does not fit in the remaining budget.
+        // Images larger than the whole budget are uploaded alone.
+        std::size_t imageBytes = container.IsValid() ? container.GetDataSize() :
+            image.GetWidth() * image.GetHeight() * image.GetChannels();
+
+        if(m_uploadedBytes != 0 && m_uploadedBytes + imageBytes > m_uploadBudget)
+            break;
+
+        // Upload the image and place a fence after it.
+        // Cooked levels are uploaded straight from the container, as they need no conversion.
+        bool uploaded = container.IsValid() ? upload.texture->Create(container) : this->UploadImage(*upload.texture, image);
+
+        if(uploaded)
+        {
+            LogInfo() << "Uploaded texture from \"" << upload.filepath << "\" file.";
+
+            upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            upload.result = nullptr;
+
+            m_uploaded.push_back(std::move(upload));
+        }
+        else
+        {
+            LogError() << "Could not upload texture from \"" << upload.filepath << "\" file!";
+        }
+
+        m_uploadedBytes += imageBytes;
+        m_decoding.pop_front();
+    }
+}
+
+bool TextureUploader::UploadImage(Texture& texture, const Image& image)
+{
+    StateCache* stateCache = GetStateCache();
+    std::size_t imageBytes = image.GetWidth() * image.GetHeight() * image.GetChannels();
+
+    // Orphan the previous storage, so the driver does not wait for earlier uploads to finish.
+    stateCache->BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, imageBytes, nullptr, GL_STREAM_DRAW);
+
+    // Copy pixels into the buffer.
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, imageBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if(mapped == nullptr)
+    {
+        stateCache->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    std::memcpy(mapped, image.GetData(), imageBytes);
+
+    if(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE)
+    {
+        stateCache->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    // Create the texture from the bound buffer.
+    // Rows of images with less than four channels are not aligned to four bytes.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    bool created = texture.Create(image.GetWidth(), image.GetHeight(), image.GetFormat(), nullptr);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Unbind the buffer, so other uploads read from client memory again.
+    stateCache->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return created;
+}
+
+std::size_t TextureUploader::GetPendingCount() const
+{
+    return m_decoding.size() + m_uploaded.size();
+}
+
+std::size_t TextureUploader::GetUploadedBytes() const
+{
+    return m_uploadedBytes;
+}
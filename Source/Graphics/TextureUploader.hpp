@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Precompiled.hpp"
+#include "Image.hpp"
+#include "TextureContainer.hpp"
+
+// Forward declarations.
+namespace System
+{
+    class ThreadPool;
+}
+
+/*
+    Graphics Texture Uploader
+
+    Finishes asynchronous texture loads. Image files are read and decoded
+    on worker threads, while uploads are issued from the thread that owns
+    the loader context through a pixel buffer object. Only a limited
+    number of bytes is uploaded per update, so a burst of loaded textures
+    is spread over multiple frames instead of stalling one of them.
+    Textures keep standing in for their placeholders until a fence placed
+    after their upload is signaled, as other contexts may not see the
+    uploaded data before that. Cooked texture containers are parsed on
+    workers too and their levels are uploaded as they are.
+
+    void ExampleGraphicsTextureUploader(System::ResourceManager& resourceManager, System::ThreadPool& threadPool)
+    {
+        // Create a texture uploader.
+        Graphics::TextureUploaderInfo uploaderInfo;
+        uploaderInfo.threadPool = &threadPool;
+        uploaderInfo.uploadBudget = 4 * 1024 * 1024;
+
+        Graphics::TextureUploader uploader;
+        uploader.Initialize(uploaderInfo);
+
+        // Start loading a texture.
+        auto texture = resourceManager.LoadAsync<Graphics::Texture>("Data/Textures/Level.png", &uploader);
+
+        // Upload decoded textures once per frame.
+        uploader.Update();
+    }
+*/
+
+namespace Graphics
+{
+    // Forward declarations.
+    class Texture;
+
+    // Texture uploader info structure.
+    struct TextureUploaderInfo
+    {
+        TextureUploaderInfo();
+
+        System::ThreadPool* threadPool;
+
+        // Maximum number of bytes uploaded per update.
+        // Larger textures are uploaded alone when nothing else was uploaded.
+        std::size_t uploadBudget;
+    };
+
+    // Texture uploader class.
+    class TextureUploader : private NonCopyable
+    {
+    public:
+        TextureUploader();
+        ~TextureUploader();
+
+        // Initializes the texture uploader.
+        bool Initialize(const TextureUploaderInfo& info);
+
+        // Queues a texture to be decoded from a file and uploaded.
+        void Queue(std::shared_ptr<Texture> texture, std::string filepath);
+
+        // Uploads decoded textures within the budget and finishes the ones visible to other contexts.
+        // Has to be called where the loader context is current.
+        void Update();
+
+        // Gets the number of textures that have not been finished yet.
+        std::size_t GetPendingCount() const;
+
+        // Gets the number of bytes uploaded by the last update.
+        std::size_t GetUploadedBytes() const;
+
+    private:
+        // Decoded image structure.
+        // Holds either an image or a cooked container.
+        struct DecodedImage
+        {
+            Image image;
+            TextureContainer container;
+            std::string error;
+        };
+
+        // Upload entry structure.
+        struct Upload
+        {
+            std::shared_ptr<Texture> texture;
+            std::string filepath;
+            std::future<std::unique_ptr<DecodedImage>> decoded;
+            std::unique_ptr<DecodedImage> result;
+            GLsync fence;
+        };
+
+        // Type declarations.
+        typedef std::deque<Upload> UploadQueue;
+        typedef std::vector<Upload> UploadList;
+
+    private:
+        // Uploads an image to the texture through the pixel buffer.
+        bool UploadImage(Texture& texture, const Image& image);
+
+        // Destroys the pixel buffer and pending fences.
+        void DestroyObjects();
+
+    private:
+        // Instance references.
+        System::ThreadPool* m_threadPool;
+
+        // Textures being decoded, in order of requests.
+        UploadQueue m_decoding;
+
+        // Uploaded textures waiting for their fences.
+        UploadList m_uploaded;
+
+        // Pixel buffer used as the upload staging area.
+        GLuint m_pixelBuffer;
+
+        // Upload budget.
+        std::size_t m_uploadBudget;
+        std::size_t m_uploadedBytes;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+}
@@ -1,6 +1,7 @@
 #include "Precompiled.hpp"
 #include "VertexInput.hpp"
 #include "Buffer.hpp"
+#include "StateCache.hpp"
 using namespace Graphics;
 
 namespace
@@ -25,6 +26,9 @@ namespace
         case VertexAttributeTypes::Float4x4:
             return 4;
 
+        case VertexAttributeTypes::UByte4Norm:
+            return 4;
+
         default:
             Verify(false, "Unknown attribute type!");
             return 0;
@@ -40,6 +44,7 @@ namespace
         case VertexAttributeTypes::Float2:
         case VertexAttributeTypes::Float3:
         case VertexAttributeTypes::Float4:
+        case VertexAttributeTypes::UByte4Norm:
             return 1;
 
         case VertexAttributeTypes::Float4x4:
@@ -71,6 +76,9 @@ namespace
         case VertexAttributeTypes::Float4x4:
             return sizeof(float) * 4;
 
+        case VertexAttributeTypes::UByte4Norm:
+            return sizeof(uint8_t) * 4;
+
         default:
             Verify(false, "Unknown attribute type!");
             return 0;
@@ -89,12 +97,21 @@ namespace
         case VertexAttributeTypes::Float4x4:
             return GL_FLOAT;
 
+        case VertexAttributeTypes::UByte4Norm:
+            return GL_UNSIGNED_BYTE;
+
         default:
             Verify(false, "Unknown attribute type!");
             return GL_INVALID_ENUM;
         }
     }
 
+    // Checks if a vertex attribute type is normalized.
+    GLboolean IsVertexAttributeTypeNormalized(VertexAttributeTypes type)
+    {
+        return type == VertexAttributeTypes::UByte4Norm ? GL_TRUE : GL_FALSE;
+    }
+
     // Constant definitions.
     const GLuint InvalidHandle = 0;
 }
@@ -136,8 +153,11 @@ void VertexInput::DestroyHandle()
     if(m_handle != InvalidHandle)
     {
         glDeleteVertexArrays(1, &m_handle);
+        GetStateCache()->OnVertexArrayDeleted(m_handle);
         m_handle = InvalidHandle;
     }
+
+    m_locations.clear();
 }
 
 bool VertexInput::Create(const VertexInputInfo& info)
@@ -203,16 +223,9 @@ bool VertexInput::Create(const VertexInputInfo& info)
         return false;
     }
 
-    // Prepare a cleanup guard.
-    SCOPE_GUARD_BEGIN();
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-    }
-    SCOPE_GUARD_END();
-
     // Bind the vertex array handle.
-    glBindVertexArray(m_handle);
+    StateCache* stateCache = GetStateCache();
+    stateCache->BindVertexArray(m_handle);
 
     // Set the vertex array's state.
     const Buffer* currentBuffer = nullptr;
@@ -227,7 +240,7 @@ bool VertexInput::Create(const VertexInputInfo& info)
         // Bind the vertex buffer.
         if(currentBuffer != attribute.buffer)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, attribute.buffer->GetHandle());
+            stateCache->BindBuffer(GL_ARRAY_BUFFER, attribute.buffer->GetHandle());
 
             currentBuffer = attribute.buffer;
             currentOffset = 0;
@@ -236,17 +249,29 @@ bool VertexInput::Create(const VertexInputInfo& info)
         // Setup vertex attributes for each used vertex location.
         for(int l = 0; l < GetVertexAttributeTypeRowCount(attribute.type); ++l)
         {
+            // Describe the attribute location.
+            AttributeLocation location;
+            location.buffer = attribute.buffer;
+            location.location = currentLocation;
+            location.size = GetVertexAttributeTypeRowSize(attribute.type);
+            location.type = GetVertexAttributeTypeEnum(attribute.type);
+            location.normalized = IsVertexAttributeTypeNormalized(attribute.type);
+            location.stride = attribute.buffer->GetElementSize();
+            location.offset = currentOffset;
+
+            m_locations.push_back(location);
+
             // Enable vertex attribute.
             glEnableVertexAttribArray(currentLocation);
 
             // Set vertex attribute pointer.
             glVertexAttribPointer(
-                currentLocation,
-                GetVertexAttributeTypeRowSize(attribute.type),
-                GetVertexAttributeTypeEnum(attribute.type),
-                GL_FALSE,
-                attribute.buffer->GetElementSize(),
-                (void*)currentOffset
+                location.location,
+                location.size,
+                location.type,
+                location.normalized,
+                location.stride,
+                (void*)location.offset
             );
 
             // Make vertex location instanced.
@@ -269,6 +294,28 @@ bool VertexInput::Create(const VertexInputInfo& info)
     return initialized = true;
 }
 
+void VertexInput::SetElementOffset(const Buffer* buffer, std::size_t elementOffset) const
+{
+    Verify(m_handle != InvalidHandle, "Vertex array handle has not been created!");
+    Verify(buffer != nullptr, "Invalid argument - \"buffer\" is null!");
+
+    // Respecify pointers of locations sourced from the buffer.
+    for(const AttributeLocation& location : m_locations)
+    {
+        if(location.buffer != buffer)
+            continue;
+
+        glVertexAttribPointer(
+            location.location,
+            location.size,
+            location.type,
+            location.normalized,
+            location.stride,
+            (void*)(elementOffset * location.stride + location.offset)
+        );
+    }
+}
+
 GLuint VertexInput::GetHandle() const
 {
     Verify(m_handle != InvalidHandle, "Vertex array handle has not been created!");
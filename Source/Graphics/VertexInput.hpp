@@ -47,6 +47,9 @@ namespace Graphics
 
         Float4x4,
 
+        // Four unsigned bytes read as normalized floats.
+        UByte4Norm,
+
         Count,
     };
 
@@ -80,12 +83,34 @@ namespace Graphics
         // Initializes the vertex input instance.
         bool Create(const VertexInputInfo& info);
 
+        // Points attributes of a buffer at an element offset.
+        // Attributes source the buffer bound to the array target instead, which has to share the layout.
+        // Vertex input has to be bound.
+        void SetElementOffset(const Buffer* buffer, std::size_t elementOffset) const;
+
         // Gets the vertex array object handle.
         GLuint GetHandle() const;
 
         // Checks if instance is valid.
         bool IsValid() const;
 
+    private:
+        // Attribute location structure.
+        // Holds the pointer state of a single location.
+        struct AttributeLocation
+        {
+            const Buffer* buffer;
+            GLuint location;
+            GLint size;
+            GLenum type;
+            GLboolean normalized;
+            GLsizei stride;
+            std::size_t offset;
+        };
+
+        // Type declarations.
+        typedef std::vector<AttributeLocation> AttributeLocationList;
+
     private:
         // Destroys the internal handle.
         void DestroyHandle();
@@ -93,5 +118,8 @@ namespace Graphics
     private:
         // Vertex array handle.
         GLuint m_handle;
+
+        // Layout of attribute locations.
+        AttributeLocationList m_locations;
     };
 }
\ No newline at end of file
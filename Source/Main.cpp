@@ -11,8 +11,14 @@
 #include "System/Window.hpp"
 #include "System/InputState.hpp"
 #include "System/ResourceManager.hpp"
+#include "System/ThreadPool.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/TextureUploader.hpp"
+#include "Graphics/Framebuffer.hpp"
 #include "Graphics/BasicRenderer.hpp"
+#include "Graphics/RenderThread.hpp"
+#include "Graphics/FrameCapture.hpp"
+#include "Graphics/Font.hpp"
 #include "Scripting/State.hpp"
 #include "Scripting/Reference.hpp"
 #include "Scripting/Helpers.hpp"
@@ -24,11 +30,128 @@
 #include "Game/ScriptComponent.hpp"
 #include "Game/RenderSystem.hpp"
 #include "Game/RenderComponent.hpp"
+#include "Game/ParticleSystem.hpp"
+#include "Game/AnimationSystem.hpp"
 
 namespace
 {
     // Log error messages.
     #define LogFatalError() "Fatal error has been encountered! "
+
+    // Headless benchmark frame record.
+    struct BenchmarkFrame
+    {
+        float frameTime;
+        float extractTime;
+        float sortTime;
+        float submitTime;
+        float gpuTime;
+        unsigned int drawCalls;
+    };
+
+    // Checks if a flag has been passed on the command line.
+    bool HasCommandLineFlag(int argc, char* argv[], const char* flag)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            if(std::strcmp(argv[i], flag) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Writes headless benchmark results to a file.
+    bool WriteBenchmarkResults(const std::string& filepath, const std::vector<BenchmarkFrame>& frames, int width, int height)
+    {
+        std::ofstream file(Build::GetWorkingDir() + filepath);
+
+        if(!file.is_open())
+            return false;
+
+        // Calculate frame time summary.
+        float frameTimeTotal = 0.0f;
+        float frameTimeMin = std::numeric_limits<float>::max();
+        float frameTimeMax = 0.0f;
+        float extractTimeTotal = 0.0f;
+        float sortTimeTotal = 0.0f;
+        float submitTimeTotal = 0.0f;
+        float gpuTimeTotal = 0.0f;
+        int gpuTimeCount = 0;
+
+        for(const BenchmarkFrame& frame : frames)
+        {
+            frameTimeTotal += frame.frameTime;
+            frameTimeMin = std::min(frameTimeMin, frame.frameTime);
+            frameTimeMax = std::max(frameTimeMax, frame.frameTime);
+            extractTimeTotal += frame.extractTime;
+            sortTimeTotal += frame.sortTime;
+            submitTimeTotal += frame.submitTime;
+
+            if(frame.gpuTime >= 0.0f)
+            {
+                gpuTimeTotal += frame.gpuTime;
+                gpuTimeCount += 1;
+            }
+        }
+
+        float frameCount = static_cast<float>(std::max<std::size_t>(frames.size(), 1));
+
+        // Calculate frame time percentiles to quantify stutter.
+        std::vector<float> frameTimes;
+        frameTimes.reserve(frames.size());
+
+        for(const BenchmarkFrame& frame : frames)
+        {
+            frameTimes.push_back(frame.frameTime);
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+
+        auto CalculatePercentile = [&frameTimes](float percentile) -> float
+        {
+            if(frameTimes.empty())
+                return 0.0f;
+
+            std::size_t rank = std::max<std::size_t>((std::size_t)std::ceil(frameTimes.size() * percentile), 1);
+            return frameTimes[rank - 1];
+        };
+
+        // Write the summary as comment lines.
+        file << "# resolution " << width << "x" << height << "\n";
+        file << "# frames " << frames.size() << "\n";
+        file << "# frame time avg " << frameTimeTotal / frameCount << " ms, min " << (frames.empty() ? 0.0f : frameTimeMin) << " ms, max " << frameTimeMax << " ms\n";
+        file << "# frame time p50 " << CalculatePercentile(0.5f) << " ms, p99 " << CalculatePercentile(0.99f) << " ms\n";
+        file << "# cpu extract avg " << extractTimeTotal / frameCount << " ms, sort avg " << sortTimeTotal / frameCount << " ms, submit avg " << submitTimeTotal / frameCount << " ms\n";
+
+        if(gpuTimeCount != 0)
+        {
+            file << "# gpu frame avg " << gpuTimeTotal / gpuTimeCount << " ms\n";
+        }
+        else
+        {
+            file << "# gpu frame unavailable\n";
+        }
+
+        // Write per frame results.
+        // Missing GPU times are written as negative values.
+        file << "frame,frameTime,extractTime,sortTime,submitTime,gpuTime,drawCalls\n";
+
+        for(std::size_t i = 0; i < frames.size(); ++i)
+        {
+            const BenchmarkFrame& frame = frames[i];
+
+            file << i << ","
+                << frame.frameTime << ","
+                << frame.extractTime << ","
+                << frame.sortTime << ","
+                << frame.submitTime << ","
+                << frame.gpuTime << ","
+                << frame.drawCalls << "\n";
+        }
+
+        return file.good();
+    }
 }
 
 int main(int argc, char* argv[])
@@ -62,17 +185,38 @@ int main(int argc, char* argv[])
     System::Config config;
     config.Load("Game.cfg");
 
+    // Read headless benchmark parameters.
+    // Headless mode renders a fixed number of frames offscreen and writes timing results to a file.
+    bool headless = config.GetParameter<bool>("Headless.Enabled", false) || HasCommandLineFlag(argc, argv, "--headless");
+    int headlessWidth = config.GetParameter<int>("Headless.Width", 1920);
+    int headlessHeight = config.GetParameter<int>("Headless.Height", 1080);
+    int headlessFrames = config.GetParameter<int>("Headless.Frames", 1000);
+    int headlessWarmupFrames = config.GetParameter<int>("Headless.WarmupFrames", 10);
+    std::string headlessOutput = config.GetParameter<std::string>("Headless.Output", "Benchmark.csv");
+
     // Create a timer.
     System::Timer timer;
     timer.SetMaxFrameDelta(1.0f);
 
+    // Pace frames to the target frame rate, which also stops spinning the CPU with vsync disabled.
+    // Headless benchmarks run as fast as possible.
+    float targetFrameRate = std::max(config.GetParameter<float>("Timer.TargetFrameRate", 0.0f), 0.0f);
+    timer.SetTargetFrameRate(headless ? 0.0f : targetFrameRate);
+
     // Create a window.
+    // Headless mode uses a hidden window only to own the OpenGL context.
     System::WindowInfo windowInfo;
     windowInfo.title = config.GetParameter<std::string>("Window.Title", "Game");
     windowInfo.width = config.GetParameter<int>("Window.Width", 1024);
     windowInfo.height = config.GetParameter<int>("Window.Height", 576);
     windowInfo.vsync = config.GetParameter<bool>("Window.Vsync", true);
 
+    if(headless)
+    {
+        windowInfo.vsync = false;
+        windowInfo.visible = false;
+    }
+
     System::Window window;
     if(!window.Open(windowInfo))
     {
@@ -96,21 +240,152 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    // Create a thread pool.
+    System::ThreadPool threadPool;
+    if(!threadPool.Initialize())
+    {
+        Log() << LogFatalError() << "Could not initialize a thread pool.";
+        return -1;
+    }
+
     // Create a resource manager.
     System::ResourceManager resourceManager;
 
+    // Create a render thread.
+    // Render thread takes over the window's context and executes recorded frames.
+    auto basicRenderer = std::make_unique<Graphics::BasicRenderer>();
+
+    Graphics::RenderThreadInfo renderThreadInfo;
+    renderThreadInfo.window = &window;
+    renderThreadInfo.basicRenderer = basicRenderer.get();
+    renderThreadInfo.threaded = config.GetParameter<bool>("Renderer.Threaded", true);
+
+    Graphics::RenderThread renderThread;
+    if(!renderThread.Initialize(renderThreadInfo))
+    {
+        Log() << LogFatalError() << "Could not initialize a render thread.";
+        return -1;
+    }
+
     // Create a basic renderer.
+    // Vertex arrays cannot be shared between contexts, so it is created with the window's context.
     Graphics::BasicRendererInfo basicRendererInfo;
     basicRendererInfo.resourceManager = &resourceManager;
     basicRendererInfo.spriteBatchSize = 128;
 
-    Graphics::BasicRenderer basicRenderer;
-    if(!basicRenderer.Initialize(basicRendererInfo))
+    bool basicRendererInitialized = false;
+
+    renderThread.Invoke([&]()
+    {
+        basicRendererInitialized = basicRenderer->Initialize(basicRendererInfo);
+    });
+
+    // Destroy the basic renderer with the window's context before the render thread stops.
+    // Its vertex arrays and timer queries cannot be shared between contexts.
+    SCOPE_GUARD_BEGIN();
+    {
+        renderThread.Invoke([&]()
+        {
+            basicRenderer = nullptr;
+        });
+    }
+    SCOPE_GUARD_END();
+
+    if(!basicRendererInitialized)
     {
         Log() << LogFatalError() << "Could not initialize a basic renderer.";
         return -1;
     }
 
+    // Create an offscreen framebuffer for headless mode.
+    // Framebuffers cannot be shared between contexts either, so it is also destroyed with the window's context.
+    std::unique_ptr<Graphics::Framebuffer> headlessFramebuffer;
+
+    SCOPE_GUARD_BEGIN(headlessFramebuffer != nullptr);
+    {
+        renderThread.Invoke([&]()
+        {
+            headlessFramebuffer = nullptr;
+        });
+    }
+    SCOPE_GUARD_END();
+
+    if(headless)
+    {
+        Graphics::FramebufferInfo framebufferInfo;
+        framebufferInfo.width = headlessWidth;
+        framebufferInfo.height = headlessHeight;
+
+        bool framebufferCreated = false;
+
+        renderThread.Invoke([&]()
+        {
+            headlessFramebuffer = std::make_unique<Graphics::Framebuffer>();
+            framebufferCreated = headlessFramebuffer->Create(framebufferInfo);
+        });
+
+        if(!framebufferCreated)
+        {
+            Log() << LogFatalError() << "Could not create a headless framebuffer.";
+            return -1;
+        }
+    }
+
+    // Create a default texture.
+    // It stands in for textures that failed to load or are still being loaded in the background.
+    {
+        const uint8_t pixels[2 * 2 * 4] =
+        {
+            255, 255, 255, 255,  255, 255, 255, 255,
+            255, 255, 255, 255,  255, 255, 255, 255,
+        };
+
+        auto defaultTexture = std::make_shared<Graphics::Texture>();
+        if(!defaultTexture->Create(2, 2, GL_RGBA, &pixels[0]))
+        {
+            Log() << LogFatalError() << "Could not create a default texture.";
+            return -1;
+        }
+
+        resourceManager.SetDefault<Graphics::Texture>(defaultTexture);
+    }
+
+    // Set the texture memory budget.
+    // Unused textures stay cached until the budget is exceeded.
+    std::size_t textureMemoryBudget = std::max(config.GetParameter<int>("Renderer.TextureMemoryBudgetMB", 512), 0);
+    resourceManager.GetPool<Graphics::Texture>()->SetMemoryBudget(textureMemoryBudget * 1024 * 1024);
+
+    // Create a texture uploader.
+    // Uploads are issued with the context current on the main thread.
+    Graphics::TextureUploaderInfo textureUploaderInfo;
+    textureUploaderInfo.threadPool = &threadPool;
+    textureUploaderInfo.uploadBudget = std::max(config.GetParameter<int>("Renderer.TextureUploadBudget", 4 * 1024 * 1024), 0);
+
+    Graphics::TextureUploader textureUploader;
+    if(!textureUploader.Initialize(textureUploaderInfo))
+    {
+        Log() << LogFatalError() << "Could not initialize a texture uploader.";
+        return -1;
+    }
+
+    // Create a frame capture.
+    // Frames are captured periodically if an interval is configured.
+    int captureInterval = std::max(config.GetParameter<int>("Capture.Interval", 0), 0);
+    std::string capturePrefix = config.GetParameter<std::string>("Capture.Prefix", "Capture");
+    std::string captureFormat = config.GetParameter<std::string>("Capture.Format", "png");
+
+    Graphics::FrameCaptureInfo frameCaptureInfo;
+    frameCaptureInfo.renderThread = &renderThread;
+    frameCaptureInfo.threadPool = &threadPool;
+    frameCaptureInfo.format = captureFormat == "raw" ? Graphics::FrameCaptureFormats::Raw : Graphics::FrameCaptureFormats::Png;
+
+    Graphics::FrameCapture frameCapture;
+    if(!frameCapture.Initialize(frameCaptureInfo))
+    {
+        Log() << LogFatalError() << "Could not initialize a frame capture.";
+        return -1;
+    }
+
     // Create an entity system.
     Game::EntitySystem entitySystem;
 
@@ -122,11 +397,25 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    // Create an animation system.
+    Game::AnimationSystemInfo animationSystemInfo;
+    animationSystemInfo.entitySystem = &entitySystem;
+    animationSystemInfo.componentSystem = &componentSystem;
+    animationSystemInfo.threadPool = &threadPool;
+
+    Game::AnimationSystem animationSystem;
+    if(!animationSystem.Initialize(animationSystemInfo))
+    {
+        Log() << LogFatalError() << "Could not initialize an animation system.";
+        return -1;
+    }
+
     // Create a script system.
     Game::ScriptSystemInfo scriptSystemInfo;
     scriptSystemInfo.scriptingState = &scriptingState;
     scriptSystemInfo.entitySystem = &entitySystem;
     scriptSystemInfo.componentSystem = &componentSystem;
+    scriptSystemInfo.animationSystem = &animationSystem;
 
     Game::ScriptSystem scriptSystem;
     if(!scriptSystem.Initialize(scriptSystemInfo))
@@ -135,22 +424,41 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    Game::ScriptBindings::References scriptBindingsReferences;
-    scriptBindingsReferences.inputState = &inputState;
-    scriptBindingsReferences.componentSystem = &componentSystem;
+    // Create a particle system.
+    Game::ParticleSystemInfo particleSystemInfo;
+    particleSystemInfo.entitySystem = &entitySystem;
+    particleSystemInfo.componentSystem = &componentSystem;
+    particleSystemInfo.threadPool = &threadPool;
 
-    if(!Game::ScriptBindings::Register(&scriptingState, scriptBindingsReferences))
+    Game::ParticleSystem particleSystem;
+    if(!particleSystem.Initialize(particleSystemInfo))
     {
-        Log() << LogFatalError() << "Could not register script bindings.";
+        Log() << LogFatalError() << "Could not initialize a particle system.";
         return -1;
     }
 
     // Create a render system.
     Game::RenderSystemInfo renderSystemInfo;
     renderSystemInfo.window = &window;
-    renderSystemInfo.basicRenderer = &basicRenderer;
+    renderSystemInfo.resourceManager = &resourceManager;
+    renderSystemInfo.renderThread = &renderThread;
     renderSystemInfo.entitySystem = &entitySystem;
     renderSystemInfo.componentSystem = &componentSystem;
+    renderSystemInfo.framebuffer = headlessFramebuffer.get();
+    renderSystemInfo.frameCapture = &frameCapture;
+
+    // Headless benchmarks always draw at the full resolution, so their results stay comparable.
+    renderSystemInfo.dynamicResolution = !headless && config.GetParameter<bool>("Renderer.DynamicResolution", true);
+    renderSystemInfo.targetFrameTime = config.GetParameter<float>("Renderer.TargetFrameTime", 16.6f);
+    renderSystemInfo.minResolutionScale = config.GetParameter<float>("Renderer.MinResolutionScale", 0.5f);
+
+    // Load a font of the frame stats overlay if one is configured.
+    std::string overlayFont = config.GetParameter<std::string>("Debug.OverlayFont", "");
+
+    if(!overlayFont.empty())
+    {
+        renderSystemInfo.overlayFont = resourceManager.Load<Graphics::Font>(overlayFont);
+    }
 
     Game::RenderSystem renderSystem;
     if(!renderSystem.Initialize(renderSystemInfo))
@@ -158,7 +466,20 @@ int main(int argc, char* argv[])
         Log() << LogFatalError() << "Could not initialize a render system.";
         return -1;
     }
-    
+
+    // Register script bindings.
+    Game::ScriptBindings::References scriptBindingsReferences;
+    scriptBindingsReferences.inputState = &inputState;
+    scriptBindingsReferences.componentSystem = &componentSystem;
+    scriptBindingsReferences.renderSystem = &renderSystem;
+    scriptBindingsReferences.debugDraw = &renderSystem.GetDebugDraw();
+
+    if(!Game::ScriptBindings::Register(&scriptingState, scriptBindingsReferences))
+    {
+        Log() << LogFatalError() << "Could not register script bindings.";
+        return -1;
+    }
+
     // Create an example entity.
     Game::EntityHandle entity = entitySystem.CreateEntity();
 
@@ -176,6 +497,26 @@ int main(int argc, char* argv[])
         render->SetRectangleFromTexture();
     }
 
+    // Read the interval of periodic frame stats logging.
+    float frameStatsInterval = config.GetParameter<float>("Debug.FrameStatsInterval", 0.0f);
+    float frameStatsTime = 0.0f;
+
+    // Allocate headless benchmark frame records.
+    std::vector<BenchmarkFrame> benchmarkFrames;
+
+    if(headless)
+    {
+        Log() << "Running headless benchmark of " << headlessFrames << " frames at " << headlessWidth << "x" << headlessHeight << "...";
+
+        benchmarkFrames.reserve(std::max(headlessFrames, 0));
+    }
+
+    int frameIndex = 0;
+
+    // Reset the timer, so the first frame does not include initialization.
+    timer.Reset();
+    timer.ResetFrameTimeStats();
+
     // Main loop.
     while(window.IsOpen())
     {
@@ -183,7 +524,9 @@ int main(int argc, char* argv[])
         Logger::AdvanceFrameReference();
 
         // Calculate frame delta time.
-        float timeDelta = timer.CalculateFrameDelta();
+        // Simulation advances by a smoothed delta, while headless mode uses a fixed time step to make runs reproducible.
+        float frameTime = timer.CalculateFrameDelta();
+        float timeDelta = headless ? 1.0f / 60.0f : timer.GetSimulationDelta();
 
         // Prepare input state for incoming events.
         inputState.Prepare();
@@ -191,17 +534,130 @@ int main(int argc, char* argv[])
         // Process window events.
         window.ProcessEvents();
 
+        // Upload textures decoded in the background.
+        textureUploader.Update();
+
         // Process entity commands.
         entitySystem.ProcessCommands();
 
         // Update the script system.
         scriptSystem.Update(timeDelta);
 
+        // Update the animation system.
+        animationSystem.Update(timeDelta);
+
+        // Update the particle system.
+        particleSystem.Update(timeDelta);
+
+        // Request a capture of the frame periodically.
+        if(captureInterval > 0 && frameIndex % captureInterval == 0)
+        {
+            std::ostringstream capturePath;
+            capturePath << capturePrefix << "_" << std::setw(6) << std::setfill('0') << frameIndex;
+            capturePath << (frameCaptureInfo.format == Graphics::FrameCaptureFormats::Raw ? ".raw" : ".png");
+
+            frameCapture.Request(capturePath.str());
+        }
+
         // Draw the scene.
         renderSystem.Draw();
 
-        // Present to the window.
-        window.Present();
+        // Log frame stats periodically.
+        if(frameStatsInterval > 0.0f)
+        {
+            frameStatsTime += timeDelta;
+
+            if(frameStatsTime >= frameStatsInterval)
+            {
+                const Game::FrameStats& frameStats = renderSystem.GetFrameStats();
+                const System::ResourcePoolStats& textureStats = resourceManager.GetPool<Graphics::Texture>()->GetStats();
+                const System::FrameTimeStats frameTimeStats = timer.GetFrameTimeStats();
+
+                std::ostringstream message;
+                message << "frame time p50 " << frameTimeStats.p50 << " ms, "
+                    << "p99 " << frameTimeStats.p99 << " ms, "
+                    << "max " << frameTimeStats.max << " ms, "
+                    << frameStats.spritesVisible << "/" << frameStats.spritesSubmitted << " sprites visible, "
+                    << frameStats.renderer.batches << " batches, "
+                    << frameStats.renderer.drawCalls << " draw calls, "
+                    << frameStats.renderer.textureSwitches << " texture switches, "
+                    << frameStats.renderer.instanceBytes << " instance bytes, "
+                    << frameStats.stateCallsSkipped << " state calls skipped, "
+                    << "resolution scale " << frameStats.resolutionScale << ", "
+                    << "cpu extract " << frameStats.extractTime << " ms, "
+                    << "cpu sort " << frameStats.sortTime << " ms, "
+                    << "cpu submit " << frameStats.submitTime << " ms, "
+                    << frameStats.commandCount << " render commands, "
+                    << "queue depth " << frameStats.queueDepth << ", "
+                    << "render stall " << frameStats.stallTime << " ms, "
+                    << "render execute " << frameStats.executeTime << " ms, "
+                    << "render present " << frameStats.presentTime << " ms, "
+                    << textureStats.residentCount << " textures resident, "
+                    << textureStats.residentBytes << " texture bytes, "
+                    << textureStats.evictedCount << " textures evicted";
+
+                if(frameStats.gpuTimesAvailable)
+                {
+                    for(const auto& result : frameStats.gpuTimes)
+                    {
+                        message << ", gpu " << result.name << " " << result.time << " ms";
+                    }
+
+                    if(frameStats.gpuScopesDropped > 0)
+                    {
+                        message << ", " << frameStats.gpuScopesDropped << " gpu scopes dropped";
+                    }
+                }
+                else
+                {
+                    message << ", gpu unavailable";
+                }
+
+                Log() << "Frame stats: " << message.str() << ".";
+
+                timer.ResetFrameTimeStats();
+                frameStatsTime = 0.0f;
+            }
+        }
+
+        // Record headless benchmark results.
+        if(headless)
+        {
+            // Skip warmup frames, which include shader compilation and resource uploads.
+            if(frameIndex > headlessWarmupFrames)
+            {
+                const Game::FrameStats& frameStats = renderSystem.GetFrameStats();
+
+                BenchmarkFrame frame;
+                frame.frameTime = frameTime * 1000.0f;
+                frame.extractTime = frameStats.extractTime;
+                frame.sortTime = frameStats.sortTime;
+                frame.submitTime = frameStats.submitTime;
+                frame.gpuTime = -1.0f;
+                frame.drawCalls = frameStats.renderer.drawCalls;
+
+                for(const auto& result : frameStats.gpuTimes)
+                {
+                    if(std::strcmp(result.name, "Frame") == 0)
+                    {
+                        frame.gpuTime = result.time;
+                    }
+                }
+
+                benchmarkFrames.push_back(frame);
+            }
+
+            if(benchmarkFrames.size() >= static_cast<std::size_t>(std::max(headlessFrames, 0)))
+            {
+                window.Close();
+            }
+        }
+
+        ++frameIndex;
+
+        // Submit the frame to the render thread.
+        // Waits for the previous frame, while the submitted one is executed and presented in the background.
+        renderThread.Submit();
 
         // Clean the scripting state.
         scriptingState.CleanStack();
@@ -214,6 +670,31 @@ int main(int argc, char* argv[])
         timer.Tick();
     }
 
+    // Wait for the render thread to finish the last frame.
+    renderThread.Flush();
+
+    // Wait for captured frames to be written.
+    if(captureInterval > 0)
+    {
+        frameCapture.Flush();
+
+        Graphics::FrameCaptureStats captureStats = frameCapture.GetStats();
+        Log() << "Captured " << captureStats.saved << " of " << captureStats.requested << " requested frames, "
+            << captureStats.failed << " failed.";
+    }
+
+    // Write headless benchmark results.
+    if(headless)
+    {
+        if(!WriteBenchmarkResults(headlessOutput, benchmarkFrames, headlessWidth, headlessHeight))
+        {
+            Log() << LogFatalError() << "Could not write benchmark results to \"" << headlessOutput << "\" file.";
+            return -1;
+        }
+
+        Log() << "Benchmark results have been written to \"" << headlessOutput << "\" file.";
+    }
+
     Log() << "Quitting application...";
 
     return 0;
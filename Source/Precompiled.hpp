@@ -5,6 +5,7 @@
 */
 
 #include <cctype>
+#include <cstring>
 #include <typeinfo>
 #include <typeindex>
 #include <memory>
@@ -17,10 +18,18 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <list>
+#include <deque>
 #include <queue>
 #include <map>
 #include <unordered_map>
 #include <optional>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 
 /*
     External
@@ -33,6 +42,12 @@
     #include <windows.h>
 #endif
 
+// SSE
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define SSE_AVAILABLE
+    #include <xmmintrin.h>
+#endif
+
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
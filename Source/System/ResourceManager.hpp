@@ -52,7 +52,7 @@ namespace System
 
         // Sets the default resource.
         template<typename Type>
-        void SetDefault(std::shared_ptr<const Type> default);
+        void SetDefault(std::shared_ptr<const Type> resource);
 
         // Gets the default resource.
         template<typename Type>
@@ -64,6 +64,12 @@ namespace System
         template<typename Type, typename... Arguments>
         std::shared_ptr<const Type> Load(std::string name, Arguments... arguments);
 
+        // Starts loading a resource in the background.
+        // Returned resource stands in for the default one until loaded.
+        // Resource type must have LoadAsync(std::string, std::shared_ptr<const Type>, ...) method implemented.
+        template<typename Type, typename... Arguments>
+        std::shared_ptr<const Type> LoadAsync(std::string name, Arguments... arguments);
+
         // Releases unused resources of all types.
         void ReleaseUnused();
 
@@ -83,14 +89,14 @@ namespace System
 
     // Template definitions.
     template<typename Type>
-    void ResourceManager::SetDefault(std::shared_ptr<const Type> default)
+    void ResourceManager::SetDefault(std::shared_ptr<const Type> resource)
     {
         // Get a resource pool.
         ResourcePool<Type>* pool = this->GetPool<Type>();
         Assert(pool != nullptr, "Could not retrieve a resource pool!");
 
         // Set the default resource.
-        pool->SetDefault(default);
+        pool->SetDefault(resource);
     }
 
     template<typename Type>
@@ -115,6 +121,17 @@ namespace System
         return pool->Load(name, std::forward<Arguments>(arguments)...);
     }
 
+    template<typename Type, typename... Arguments>
+    std::shared_ptr<const Type> ResourceManager::LoadAsync(std::string name, Arguments... arguments)
+    {
+        // Get a resource pool.
+        ResourcePool<Type>* pool = this->GetPool<Type>();
+        Assert(pool != nullptr, "Could not retrieve a resource pool!");
+
+        // Delegate call to the resource pool, which will provide its default resource as a placeholder.
+        return pool->LoadAsync(name, std::forward<Arguments>(arguments)...);
+    }
+
     template<typename Type>
     ResourcePool<Type>* ResourceManager::CreatePool()
     {
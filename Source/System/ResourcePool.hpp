@@ -30,10 +30,59 @@
         // Release resources that are no longer referenced.
         resourceManager.ReleaseUnused();
     }
+
+    Resource types that report their memory usage with GetMemoryUsage()
+    method can be kept cached within a memory budget. Unused resources
+    are then released in least recently used order, only when resources
+    of the pool exceed the budget.
 */
 
 namespace System
 {
+    // Resource memory usage helper.
+    // Resource types without GetMemoryUsage() method do not report their memory usage.
+    template<typename Type, typename Enable = void>
+    struct ResourceMemoryUsage
+    {
+        static const bool Reported = false;
+
+        static std::size_t Get(const Type&)
+        {
+            return 0;
+        }
+    };
+
+    template<typename Type>
+    struct ResourceMemoryUsage<Type, std::void_t<decltype(std::declval<const Type&>().GetMemoryUsage())>>
+    {
+        static const bool Reported = true;
+
+        static std::size_t Get(const Type& resource)
+        {
+            return resource.GetMemoryUsage();
+        }
+    };
+
+    // Resource pool stats structure.
+    struct ResourcePoolStats
+    {
+        ResourcePoolStats() :
+            residentCount(0),
+            residentBytes(0),
+            evictedCount(0),
+            evictedBytes(0)
+        {
+        }
+
+        // Resources held by the pool.
+        std::size_t residentCount;
+        std::size_t residentBytes;
+
+        // Resources released by the last release of unused resources.
+        std::size_t evictedCount;
+        std::size_t evictedBytes;
+    };
+
     // Resource pool interface.
     class ResourcePoolInterface
     {
@@ -55,10 +104,17 @@ namespace System
     class ResourcePool : public ResourcePoolInterface
     {
     public:
+        // Resource entry structure.
+        struct ResourceEntry
+        {
+            std::shared_ptr<Type> resource;
+            uint64_t lastUsedFrame;
+        };
+
         // Type declarations.
-        typedef std::shared_ptr<Type>                        ResourcePtr;
-        typedef std::unordered_map<std::string, ResourcePtr> ResourceList;
-        typedef typename ResourceList::value_type            ResourceListPair;
+        typedef std::shared_ptr<Type>                          ResourcePtr;
+        typedef std::unordered_map<std::string, ResourceEntry> ResourceList;
+        typedef typename ResourceList::value_type              ResourceListPair;
 
     public:
         ResourcePool();
@@ -76,24 +132,55 @@ namespace System
         template<typename... Arguments>
         std::shared_ptr<const Type> Load(std::string name, Arguments... arguments);
 
+        // Starts loading a resource by name in the background.
+        // Returned resource stands in for the default one until loaded.
+        // Resource type must have LoadAsync(std::string, std::shared_ptr<const Type>, ...) method implemented.
+        template<typename... Arguments>
+        std::shared_ptr<const Type> LoadAsync(std::string name, Arguments... arguments);
+
+        // Sets the memory budget of resources.
+        // Unused resources are cached until the budget is exceeded.
+        // Zero budget releases unused resources right away.
+        void SetMemoryBudget(std::size_t bytes);
+
         // Releases unused resources.
+        // Has to be called once per frame, as resource usage is tracked in frames.
         void ReleaseUnused();
 
         // Releases all resources.
         void ReleaseAll();
 
+        // Gets the pool stats.
+        const ResourcePoolStats& GetStats() const;
+
+    private:
+        // Adds a loaded resource to the list.
+        std::shared_ptr<const Type> AddResource(std::string name, ResourcePtr resource);
+
+        // Releases a resource and prints a log message.
+        typename ResourceList::iterator ReleaseResource(typename ResourceList::iterator it);
+
     private:
         // Default resource.
         std::shared_ptr<const Type> m_default;
 
         // List of resources.
         ResourceList m_resources;
+
+        // Memory budget.
+        std::size_t m_memoryBudget;
+        uint64_t m_frameIndex;
+
+        // Pool stats.
+        ResourcePoolStats m_stats;
     };
 
     // Template definitions.
     template<typename Type>
     ResourcePool<Type>::ResourcePool() :
-        m_default(std::make_shared<Type>())
+        m_default(std::make_shared<Type>()),
+        m_memoryBudget(0),
+        m_frameIndex(0)
     {
     }
 
@@ -107,7 +194,7 @@ namespace System
     template<typename Type>
     void ResourcePool<Type>::SetDefault(std::shared_ptr<const Type> resource)
     {
-        Verify(it->second != nullptr, "Default resource cannot be null!");
+        Verify(resource != nullptr, "Default resource cannot be null!");
 
         m_default = resource;
     }
@@ -115,7 +202,7 @@ namespace System
     template<typename Type>
     std::shared_ptr<const Type> ResourcePool<Type>::GetDefault() const
     {
-        Verify(it->second != nullptr, "Default resource is null!");
+        Verify(m_default != nullptr, "Default resource is null!");
 
         return m_default;
     }
@@ -128,10 +215,10 @@ namespace System
         auto it = m_resources.find(name);
         if(it != m_resources.end())
         {
-            Assert(it->second != nullptr, "Found resource is null!");
+            Assert(it->second.resource != nullptr, "Found resource is null!");
 
             // Return found resource.
-            return it->second;
+            return it->second.resource;
         }
 
         // Create and load a new resource instance.
@@ -140,36 +227,146 @@ namespace System
             return m_default;
 
         // Add resource to the list.
-        auto result = m_resources.emplace(name, std::move(resource));
+        return this->AddResource(name, std::move(resource));
+    }
+
+    template<typename Type>
+    template<typename... Arguments>
+    std::shared_ptr<const Type> ResourcePool<Type>::LoadAsync(std::string name, Arguments... arguments)
+    {
+        // Return an existing resource if loaded or being loaded.
+        auto it = m_resources.find(name);
+        if(it != m_resources.end())
+        {
+            Assert(it->second.resource != nullptr, "Found resource is null!");
+
+            // Return found resource.
+            return it->second.resource;
+        }
+
+        // Create a new resource instance that starts loading in the background.
+        std::shared_ptr<Type> resource = std::make_shared<Type>();
+        if(!resource->LoadAsync(name, m_default, std::forward<Arguments>(arguments)...))
+            return m_default;
+
+        // Add resource to the list.
+        return this->AddResource(name, std::move(resource));
+    }
+
+    template<typename Type>
+    std::shared_ptr<const Type> ResourcePool<Type>::AddResource(std::string name, ResourcePtr resource)
+    {
+        // Add resource to the list.
+        ResourceEntry entry;
+        entry.resource = std::move(resource);
+        entry.lastUsedFrame = m_frameIndex;
+
+        auto result = m_resources.emplace(name, std::move(entry));
         Assert(result.second, "Failed to emplace a new resource in the resource pool!");
 
         // Return the resource pointer.
-        return result.first->second;
+        return result.first->second.resource;
+    }
+
+    template<typename Type>
+    typename ResourcePool<Type>::ResourceList::iterator ResourcePool<Type>::ReleaseResource(typename ResourceList::iterator it)
+    {
+        // Retrieve the name to print it later.
+        std::string name = it->first;
+
+        // Release the resource.
+        it = m_resources.erase(it);
+
+        // Print a log message.
+        LogInfo() << "Released \"" << name << "\" resource.";
+
+        return it;
+    }
+
+    template<typename Type>
+    void ResourcePool<Type>::SetMemoryBudget(std::size_t bytes)
+    {
+        static_assert(ResourceMemoryUsage<Type>::Reported, "Resource type does not report its memory usage.");
+
+        m_memoryBudget = bytes;
     }
 
     template<typename Type>
     void ResourcePool<Type>::ReleaseUnused()
     {
-        // Release unused resources.
-        auto it = m_resources.begin();
-        while(it != m_resources.end())
+        // Resources used by the last frames may still be referenced by frames in flight.
+        const uint64_t InFlightFrames = 2;
+
+        ++m_frameIndex;
+
+        m_stats.evictedCount = 0;
+        m_stats.evictedBytes = 0;
+
+        // Release unused resources right away without a budget.
+        if(m_memoryBudget == 0)
         {
-            if(it->second.use_count() == 1)
+            auto it = m_resources.begin();
+            while(it != m_resources.end())
             {
-                // Retrieve the name to print it later.
-                std::string name = it->first;
+                if(it->second.resource.use_count() == 1)
+                {
+                    m_stats.evictedCount += 1;
+                    m_stats.evictedBytes += ResourceMemoryUsage<Type>::Get(*it->second.resource);
+
+                    it = this->ReleaseResource(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
 
-                // Release the resource.
-                it = m_resources.erase(it);
+        // Track resource usage and sum their memory.
+        // Resources referenced outside of the pool are considered used.
+        std::vector<typename ResourceList::iterator> unused;
+        std::size_t residentBytes = 0;
 
-                // Print a log message.
-                LogInfo() << "Released \"" << name << "\" resource.";
+        for(auto it = m_resources.begin(); it != m_resources.end(); ++it)
+        {
+            ResourceEntry& entry = it->second;
+            residentBytes += ResourceMemoryUsage<Type>::Get(*entry.resource);
+
+            if(entry.resource.use_count() != 1)
+            {
+                entry.lastUsedFrame = m_frameIndex;
             }
-            else
+            else if(m_frameIndex - entry.lastUsedFrame >= InFlightFrames)
             {
-                ++it;
+                unused.push_back(it);
             }
         }
+
+        // Release least recently used resources until they fit in the budget.
+        if(residentBytes > m_memoryBudget)
+        {
+            std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b)
+            {
+                return a->second.lastUsedFrame < b->second.lastUsedFrame;
+            });
+
+            for(auto it : unused)
+            {
+                if(residentBytes <= m_memoryBudget)
+                    break;
+
+                std::size_t bytes = ResourceMemoryUsage<Type>::Get(*it->second.resource);
+                residentBytes -= bytes;
+
+                m_stats.evictedCount += 1;
+                m_stats.evictedBytes += bytes;
+
+                this->ReleaseResource(it);
+            }
+        }
+
+        m_stats.residentCount = m_resources.size();
+        m_stats.residentBytes = residentBytes;
     }
 
     template<typename Type>
@@ -179,16 +376,15 @@ namespace System
         auto it = m_resources.begin();
         while(it != m_resources.end())
         {
-            // Retrieve the name to print it later.
-            std::string name = it->first;
-
-            // Release the resource.
-            it = m_resources.erase(it);
-
-            // Print a log message.
-            LogInfo() << "Released \"" << name << "\" resource.";
+            it = this->ReleaseResource(it);
         }
 
         Assert(m_resources.empty(), "Resource pool is not empty after releasing all resources!");
     }
+
+    template<typename Type>
+    const ResourcePoolStats& ResourcePool<Type>::GetStats() const
+    {
+        return m_stats;
+    }
 }
@@ -0,0 +1,325 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    System Resource Registry
+
+    Assigns compact 32-bit handles to shared resources. Registry keeps a
+    resource alive while any handle references it, with reference counts
+    kept in tables apart from resource pointers, so resolving a handle in
+    hot loops only reads a tightly packed array. Handles are assigned in
+    registration order and reused after release, which makes them stable
+    keys for sorting, unlike resource addresses. Each resource type has
+    a single global registry that has to be used from the main thread.
+
+    void ExampleSystemResourceRegistry(std::shared_ptr<const Texture> texture)
+    {
+        // Create a handle referencing a texture.
+        System::ResourceHandle<Texture> handle(texture);
+
+        // Resolve the handle in a hot loop.
+        const Texture* pointer = handle.Get();
+        uint32_t identifier = handle.GetIdentifier();
+    }
+*/
+
+namespace System
+{
+    // Resource registry class.
+    template<typename Type>
+    class ResourceRegistry : private NonCopyable
+    {
+    public:
+        // Type declarations.
+        typedef std::shared_ptr<const Type> ResourcePtr;
+
+        // Invalid identifier.
+        // Identifier of a null resource, which always resolves to null.
+        static const uint32_t InvalidIdentifier = 0;
+
+    public:
+        ResourceRegistry();
+        ~ResourceRegistry();
+
+        // Acquires a reference to a resource.
+        // Registers the resource if it has not been referenced yet.
+        uint32_t Acquire(const ResourcePtr& resource);
+
+        // Acquires another reference to a registered resource.
+        void Acquire(uint32_t identifier);
+
+        // Releases a reference to a registered resource.
+        // Resource is unregistered when its last reference is released.
+        void Release(uint32_t identifier);
+
+        // Resolves a resource pointer.
+        const Type* Get(uint32_t identifier) const;
+
+        // Resolves a shared resource.
+        const ResourcePtr& GetResource(uint32_t identifier) const;
+
+        // Gets the number of registered resources.
+        std::size_t GetResourceCount() const;
+
+        // Gets the global registry of the resource type.
+        static ResourceRegistry& GetGlobal();
+
+    private:
+        // Type declarations.
+        typedef std::vector<const Type*> PointerList;
+        typedef std::vector<ResourcePtr> ResourceList;
+        typedef std::vector<uint32_t> ReferenceCountList;
+        typedef std::vector<uint32_t> FreeList;
+        typedef std::unordered_map<const Type*, uint32_t> IdentifierMap;
+
+    private:
+        // Resource pointers resolved by hot loops.
+        PointerList m_pointers;
+
+        // Resources and their reference counts.
+        ResourceList m_resources;
+        ReferenceCountList m_referenceCounts;
+
+        // Released identifiers.
+        FreeList m_freeList;
+
+        // Identifiers of registered resources.
+        IdentifierMap m_identifiers;
+    };
+
+    // Resource handle class.
+    // Holds a reference to a resource in the global registry.
+    template<typename Type>
+    class ResourceHandle
+    {
+    public:
+        // Type declarations.
+        typedef ResourceRegistry<Type> Registry;
+        typedef typename Registry::ResourcePtr ResourcePtr;
+
+    public:
+        ResourceHandle();
+        ResourceHandle(const ResourcePtr& resource);
+        ResourceHandle(const ResourceHandle& other);
+        ResourceHandle(ResourceHandle&& other);
+        ~ResourceHandle();
+
+        // Assignment operators.
+        ResourceHandle& operator=(const ResourceHandle& other);
+        ResourceHandle& operator=(ResourceHandle&& other);
+
+        // Resolves the resource pointer.
+        const Type* Get() const;
+
+        // Resolves the shared resource.
+        const ResourcePtr& GetResource() const;
+
+        // Gets the identifier of the resource.
+        uint32_t GetIdentifier() const;
+
+        // Checks if the handle references a resource.
+        bool IsValid() const;
+
+    private:
+        // Resource identifier.
+        uint32_t m_identifier;
+    };
+
+    // Template definitions.
+    template<typename Type>
+    ResourceRegistry<Type>::ResourceRegistry()
+    {
+        // Reserve the invalid identifier for the null resource.
+        m_pointers.push_back(nullptr);
+        m_resources.push_back(nullptr);
+        m_referenceCounts.push_back(0);
+    }
+
+    template<typename Type>
+    ResourceRegistry<Type>::~ResourceRegistry()
+    {
+    }
+
+    template<typename Type>
+    uint32_t ResourceRegistry<Type>::Acquire(const ResourcePtr& resource)
+    {
+        if(resource == nullptr)
+            return InvalidIdentifier;
+
+        // Reference an already registered resource.
+        auto it = m_identifiers.find(resource.get());
+
+        if(it != m_identifiers.end())
+        {
+            m_referenceCounts[it->second] += 1;
+            return it->second;
+        }
+
+        // Register the resource under a released or a new identifier.
+        uint32_t identifier;
+
+        if(!m_freeList.empty())
+        {
+            identifier = m_freeList.back();
+            m_freeList.pop_back();
+
+            m_pointers[identifier] = resource.get();
+            m_resources[identifier] = resource;
+            m_referenceCounts[identifier] = 1;
+        }
+        else
+        {
+            identifier = (uint32_t)m_pointers.size();
+
+            m_pointers.push_back(resource.get());
+            m_resources.push_back(resource);
+            m_referenceCounts.push_back(1);
+        }
+
+        m_identifiers.emplace(resource.get(), identifier);
+
+        return identifier;
+    }
+
+    template<typename Type>
+    void ResourceRegistry<Type>::Acquire(uint32_t identifier)
+    {
+        if(identifier == InvalidIdentifier)
+            return;
+
+        Assert(identifier < m_referenceCounts.size() && m_referenceCounts[identifier] != 0, "Resource identifier is not registered!");
+
+        m_referenceCounts[identifier] += 1;
+    }
+
+    template<typename Type>
+    void ResourceRegistry<Type>::Release(uint32_t identifier)
+    {
+        if(identifier == InvalidIdentifier)
+            return;
+
+        Assert(identifier < m_referenceCounts.size() && m_referenceCounts[identifier] != 0, "Resource identifier is not registered!");
+
+        if(--m_referenceCounts[identifier] != 0)
+            return;
+
+        // Unregister the resource.
+        m_identifiers.erase(m_pointers[identifier]);
+
+        m_pointers[identifier] = nullptr;
+        m_resources[identifier] = nullptr;
+        m_freeList.push_back(identifier);
+    }
+
+    template<typename Type>
+    const Type* ResourceRegistry<Type>::Get(uint32_t identifier) const
+    {
+        Assert(identifier < m_pointers.size(), "Resource identifier is out of range!");
+
+        return m_pointers[identifier];
+    }
+
+    template<typename Type>
+    const typename ResourceRegistry<Type>::ResourcePtr& ResourceRegistry<Type>::GetResource(uint32_t identifier) const
+    {
+        Assert(identifier < m_resources.size(), "Resource identifier is out of range!");
+
+        return m_resources[identifier];
+    }
+
+    template<typename Type>
+    std::size_t ResourceRegistry<Type>::GetResourceCount() const
+    {
+        return m_identifiers.size();
+    }
+
+    template<typename Type>
+    ResourceRegistry<Type>& ResourceRegistry<Type>::GetGlobal()
+    {
+        static ResourceRegistry registry;
+        return registry;
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>::ResourceHandle() :
+        m_identifier(Registry::InvalidIdentifier)
+    {
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>::ResourceHandle(const ResourcePtr& resource) :
+        m_identifier(Registry::GetGlobal().Acquire(resource))
+    {
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>::ResourceHandle(const ResourceHandle& other) :
+        m_identifier(other.m_identifier)
+    {
+        Registry::GetGlobal().Acquire(m_identifier);
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>::ResourceHandle(ResourceHandle&& other) :
+        m_identifier(other.m_identifier)
+    {
+        other.m_identifier = Registry::InvalidIdentifier;
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>::~ResourceHandle()
+    {
+        Registry::GetGlobal().Release(m_identifier);
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>& ResourceHandle<Type>::operator=(const ResourceHandle& other)
+    {
+        // Acquire first, in case both handles reference the same resource.
+        Registry::GetGlobal().Acquire(other.m_identifier);
+        Registry::GetGlobal().Release(m_identifier);
+
+        m_identifier = other.m_identifier;
+
+        return *this;
+    }
+
+    template<typename Type>
+    ResourceHandle<Type>& ResourceHandle<Type>::operator=(ResourceHandle&& other)
+    {
+        if(this != &other)
+        {
+            Registry::GetGlobal().Release(m_identifier);
+
+            m_identifier = other.m_identifier;
+            other.m_identifier = Registry::InvalidIdentifier;
+        }
+
+        return *this;
+    }
+
+    template<typename Type>
+    const Type* ResourceHandle<Type>::Get() const
+    {
+        return Registry::GetGlobal().Get(m_identifier);
+    }
+
+    template<typename Type>
+    const typename ResourceHandle<Type>::ResourcePtr& ResourceHandle<Type>::GetResource() const
+    {
+        return Registry::GetGlobal().GetResource(m_identifier);
+    }
+
+    template<typename Type>
+    uint32_t ResourceHandle<Type>::GetIdentifier() const
+    {
+        return m_identifier;
+    }
+
+    template<typename Type>
+    bool ResourceHandle<Type>::IsValid() const
+    {
+        return m_identifier != Registry::InvalidIdentifier;
+    }
+}
@@ -0,0 +1,190 @@
+#include "Precompiled.hpp"
+#include "ThreadPool.hpp"
+using namespace System;
+
+namespace
+{
+    // Parallel for state structure.
+    // Shared with helper tasks, which may start after the calling thread has returned.
+    struct ParallelForState
+    {
+        ParallelForState() :
+            nextIndex(0),
+            completedCount(0)
+        {
+        }
+
+        std::atomic<std::size_t> nextIndex;
+        std::atomic<std::size_t> completedCount;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+}
+
+ThreadPoolInfo::ThreadPoolInfo() :
+    threadCount(0)
+{
+}
+
+ThreadPool::ThreadPool() :
+    m_stop(false),
+    m_initialized(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->DestroyThreads();
+}
+
+void ThreadPool::DestroyThreads()
+{
+    // Signal worker threads to finish remaining tasks and exit.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+
+    // Wait for worker threads to exit.
+    for(std::thread& thread : m_threads)
+    {
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    m_threads.clear();
+    m_stop = false;
+}
+
+bool ThreadPool::Initialize(const ThreadPoolInfo& info)
+{
+    Log() << "Initializing thread pool..." << LogIndent();
+
+    // Check if instance has been already initialized.
+    Verify(!m_initialized, "Thread pool instance has been already initialized!");
+
+    // Validate arguments.
+    if(info.threadCount < 0)
+    {
+        LogError() << "Invalid argument - \"threadCount\" cannot be negative!";
+        return false;
+    }
+
+    // Determine the number of worker threads.
+    // Main thread also executes work, so one hardware thread is left for it.
+    int threadCount = info.threadCount;
+
+    if(threadCount == 0)
+    {
+        threadCount = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+    }
+
+    // Start worker threads.
+    SCOPE_GUARD_IF(!m_initialized, this->DestroyThreads());
+
+    for(int i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+
+    LogInfo() << "Started " << threadCount << " worker threads.";
+
+    // Success!
+    LogInfo() << "Success!";
+
+    return m_initialized = true;
+}
+
+void ThreadPool::Enqueue(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerMain()
+{
+    while(true)
+    {
+        Task task;
+
+        // Wait for a task or a stop request.
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]()
+            {
+                return m_stop || !m_tasks.empty();
+            });
+
+            if(m_stop && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        // Execute the task.
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const ParallelTask& function)
+{
+    if(count == 0)
+        return;
+
+    // Indices are claimed one at a time by all participating threads.
+    // Function is only called for claimed indices, so helpers that start late never touch it.
+    auto state = std::make_shared<ParallelForState>();
+
+    auto ProcessIndices = [state, &function, count]()
+    {
+        std::size_t index;
+
+        while((index = state->nextIndex.fetch_add(1)) < count)
+        {
+            function(index);
+
+            // Wake up the calling thread once the last index has been processed.
+            if(state->completedCount.fetch_add(1) + 1 == count)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->condition.notify_all();
+            }
+        }
+    };
+
+    // Start helper tasks on worker threads.
+    // Helpers share the queue with other tasks, so they are not waited for.
+    std::size_t helperCount = std::min(m_threads.size(), count - 1);
+
+    for(std::size_t i = 0; i < helperCount; ++i)
+    {
+        this->Enqueue(ProcessIndices);
+    }
+
+    // Take part in processing and wait until all indices have been processed.
+    // Calling thread may process all of them if workers are busy with other tasks.
+    ProcessIndices();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    state->condition.wait(lock, [&state, count]()
+    {
+        return state->completedCount.load() == count;
+    });
+}
+
+int ThreadPool::GetThreadCount() const
+{
+    return (int)m_threads.size();
+}
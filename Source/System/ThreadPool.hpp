@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Precompiled.hpp"
+
+/*
+    System Thread Pool
+
+    Runs tasks on a fixed set of worker threads. Tasks must not
+    call OpenGL functions, as contexts are only current on the
+    main and render threads.
+
+    void ExampleSystemThreadPool()
+    {
+        // Create a thread pool instance.
+        System::ThreadPoolInfo threadPoolInfo;
+        threadPoolInfo.threadCount = 4;
+
+        System::ThreadPool threadPool;
+        threadPool.Initialize(threadPoolInfo);
+
+        // Submit a task and wait for its result.
+        std::future<int> result = threadPool.Submit([]()
+        {
+            return 42;
+        });
+
+        Log() << "Result: " << result.get();
+
+        // Process elements in parallel.
+        threadPool.ParallelFor(elements.size(), [&](std::size_t index)
+        {
+            Process(elements[index]);
+        });
+    }
+*/
+
+namespace System
+{
+    // Thread pool info structure.
+    struct ThreadPoolInfo
+    {
+        ThreadPoolInfo();
+
+        // Number of worker threads.
+        // Zero picks one thread less than the number of hardware threads.
+        int threadCount;
+    };
+
+    // Thread pool class.
+    class ThreadPool : private NonCopyable
+    {
+    public:
+        // Type declarations.
+        typedef std::function<void()> Task;
+        typedef std::function<void(std::size_t)> ParallelTask;
+
+    public:
+        ThreadPool();
+        ~ThreadPool();
+
+        // Initializes the thread pool.
+        bool Initialize(const ThreadPoolInfo& info = ThreadPoolInfo());
+
+        // Submits a task to be executed on a worker thread.
+        // Task is executed on the calling thread if the pool has not been initialized.
+        template<typename Function>
+        std::future<std::invoke_result_t<Function>> Submit(Function function);
+
+        // Calls a function for each index in parallel and waits for completion.
+        // Calling thread takes part in the work and only waits for indices claimed by workers.
+        // Should not be called from worker threads.
+        void ParallelFor(std::size_t count, const ParallelTask& function);
+
+        // Gets the number of worker threads.
+        int GetThreadCount() const;
+
+    private:
+        // Adds a task to the queue.
+        void Enqueue(Task task);
+
+        // Runs the loop of a worker thread.
+        void WorkerMain();
+
+        // Stops and joins worker threads.
+        void DestroyThreads();
+
+    private:
+        // Worker threads.
+        std::vector<std::thread> m_threads;
+
+        // Task queue.
+        std::queue<Task> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stop;
+
+        // Initialization state.
+        bool m_initialized;
+    };
+
+    // Template definitions.
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> ThreadPool::Submit(Function function)
+    {
+        typedef std::invoke_result_t<Function> ResultType;
+
+        // Packaged task is not copyable, so it has to be shared with the queued function.
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::move(function));
+        std::future<ResultType> result = task->get_future();
+
+        if(m_initialized)
+        {
+            this->Enqueue([task]()
+            {
+                (*task)();
+            });
+        }
+        else
+        {
+            (*task)();
+        }
+
+        return result;
+    }
+}
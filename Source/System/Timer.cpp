@@ -2,11 +2,78 @@
 #include "Timer.hpp"
 using namespace System;
 
+#ifdef WIN32
+    #include <mmsystem.h>
+#endif
+
+namespace
+{
+    // Frame time histogram resolution.
+    // Longer frame times are counted in the last bucket.
+    const float HistogramBucketSize = 0.1f;
+    const std::size_t HistogramBucketCount = 1000;
+
+    // Weight of a new frame delta in the smoothed simulation delta.
+    const float SimulationSmoothing = 0.2f;
+
+    // Relative distance from the target frame time that simulation delta is snapped from.
+    const float SimulationSnapTolerance = 0.1f;
+
+    // Fraction of the accumulated drift that is fed back into each simulation delta.
+    const float SimulationDriftCorrection = 0.1f;
+
+    // Initial estimate of the longest sleep in seconds.
+    const double InitialSleepEstimate = 0.002;
+
+    // Divisor of the target frame time that limits the sleep estimate.
+    const uint64_t SleepEstimateLimitDivisor = 2;
+
+    // Calculates a histogram percentile in milliseconds.
+    float CalculatePercentile(const std::vector<uint32_t>& histogram, std::size_t count, float percentile)
+    {
+        if(count == 0)
+            return 0.0f;
+
+        // Find the bucket that contains the frame at the percentile rank.
+        std::size_t rank = std::max<std::size_t>((std::size_t)std::ceil(count * percentile), 1);
+        std::size_t accumulated = 0;
+
+        for(std::size_t i = 0; i < histogram.size(); ++i)
+        {
+            accumulated += histogram[i];
+
+            if(accumulated >= rank)
+                return (i + 0.5f) * HistogramBucketSize;
+        }
+
+        return histogram.size() * HistogramBucketSize;
+    }
+}
+
+FrameTimeStats::FrameTimeStats() :
+    frameCount(0),
+    p50(0.0f),
+    p99(0.0f),
+    max(0.0f)
+{
+}
+
 Timer::Timer() :
     m_timerFrequency(glfwGetTimerFrequency()),
     m_currentTimeCounter(glfwGetTimerValue()),
     m_previousTimeCounter(m_currentTimeCounter),
-    m_maxFrameDeltaSeconds(std::numeric_limits<float>::max())
+    m_maxFrameDeltaSeconds(std::numeric_limits<float>::max()),
+    m_targetFrameRate(0.0f),
+    m_targetFrameCounter(0),
+    m_frameDeadline(m_currentTimeCounter),
+    m_sleepEstimate((uint64_t)(m_timerFrequency * InitialSleepEstimate)),
+    m_sleepResolutionRaised(false),
+    m_smoothedDelta(0.0f),
+    m_simulationDelta(0.0f),
+    m_simulationDrift(0.0f),
+    m_histogram(HistogramBucketCount, 0),
+    m_histogramCount(0),
+    m_frameTimeMax(0.0f)
 {
     // Check if the timer's frequency is valid.
     // Assertion's failure may indicate improperly initialized GLFW library.
@@ -15,6 +82,7 @@ Timer::Timer() :
 
 Timer::~Timer()
 {
+    this->SetSleepResolution(false);
 }
 
 void Timer::Reset()
@@ -24,15 +92,120 @@ void Timer::Reset()
     // Reset internal timer values.
     m_currentTimeCounter = glfwGetTimerValue();
     m_previousTimeCounter = m_currentTimeCounter;
+    m_frameDeadline = m_currentTimeCounter;
+
+    // Start the simulation at the target frame time, as the first frame has no measured delta.
+    float targetDelta = m_targetFrameRate > 0.0f ? 1.0f / m_targetFrameRate : 0.0f;
+
+    m_smoothedDelta = targetDelta;
+    m_simulationDelta = std::min(targetDelta, m_maxFrameDeltaSeconds);
+    m_simulationDrift = 0.0f;
 }
 
 void Timer::Tick()
 {
     Assert(m_timerFrequency != 0, "Timer frequency is invalid!");
 
+    // Pace the frame to the target frame rate.
+    if(m_targetFrameCounter != 0)
+    {
+        this->WaitForFrame();
+    }
+
     // Remember time points of the two last ticks.
     m_previousTimeCounter = m_currentTimeCounter;
     m_currentTimeCounter = glfwGetTimerValue();
+
+    // Record the frame time.
+    this->RecordFrame();
+}
+
+void Timer::WaitForFrame()
+{
+    // Schedule the deadline a frame after the previous one.
+    // Frames that finish slightly late are caught up with, but not ones that fell behind by a whole frame.
+    uint64_t timeCounter = glfwGetTimerValue();
+
+    m_frameDeadline += m_targetFrameCounter;
+
+    if(timeCounter > m_frameDeadline + m_targetFrameCounter)
+    {
+        m_frameDeadline = timeCounter;
+        return;
+    }
+
+    // Let the sleep estimate decay once per frame.
+    // Estimate is limited to a part of the frame, so a single overshooting sleep cannot turn pacing into spinning.
+    uint64_t sleepEstimateLimit = m_targetFrameCounter / SleepEstimateLimitDivisor;
+
+    m_sleepEstimate -= m_sleepEstimate / 64;
+    m_sleepEstimate = std::min(m_sleepEstimate, sleepEstimateLimit);
+
+    // Sleep while the deadline is further away than the longest sleep.
+    // Estimate jumps up to longer sleeps.
+    while(timeCounter < m_frameDeadline && m_frameDeadline - timeCounter > m_sleepEstimate)
+    {
+        uint64_t sleepStart = timeCounter;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        timeCounter = glfwGetTimerValue();
+
+        m_sleepEstimate = std::max(m_sleepEstimate, timeCounter - sleepStart);
+        m_sleepEstimate = std::min(m_sleepEstimate, sleepEstimateLimit);
+    }
+
+    // Spin for the remaining time.
+    while(timeCounter < m_frameDeadline)
+    {
+        std::this_thread::yield();
+
+        timeCounter = glfwGetTimerValue();
+    }
+}
+
+void Timer::RecordFrame()
+{
+    // Calculate the frame time of the last tick.
+    float frameDelta = this->CalculateFrameDelta();
+    float frameTime = static_cast<float>((m_currentTimeCounter - m_previousTimeCounter) * (1000.0 / m_timerFrequency));
+
+    // Add the frame time to the histogram.
+    std::size_t bucket = std::min((std::size_t)(frameTime / HistogramBucketSize), HistogramBucketCount - 1);
+
+    m_histogram[bucket] += 1;
+    m_histogramCount += 1;
+    m_frameTimeMax = std::max(m_frameTimeMax, frameTime);
+
+    // Smooth the measured delta.
+    if(m_smoothedDelta == 0.0f)
+    {
+        m_smoothedDelta = frameDelta;
+    }
+    else
+    {
+        m_smoothedDelta += (frameDelta - m_smoothedDelta) * SimulationSmoothing;
+    }
+
+    // Snap the simulation delta to the target frame time if close to it.
+    float simulationDelta = m_smoothedDelta;
+
+    if(m_targetFrameRate > 0.0f)
+    {
+        float targetDelta = 1.0f / m_targetFrameRate;
+
+        if(std::abs(m_smoothedDelta - targetDelta) <= targetDelta * SimulationSnapTolerance)
+        {
+            simulationDelta = targetDelta;
+        }
+    }
+
+    // Feed back a part of the time lost or gained so far.
+    // Simulated time converges to measured time, even if frames settle off the target.
+    simulationDelta += m_simulationDrift * SimulationDriftCorrection;
+
+    m_simulationDelta = Utility::Clamp(simulationDelta, 0.0f, m_maxFrameDeltaSeconds);
+    m_simulationDrift += frameDelta - m_simulationDelta;
 }
 
 float Timer::CalculateFrameDelta()
@@ -53,6 +226,13 @@ float Timer::CalculateFrameDelta()
     return frameDeltaSeconds;
 }
 
+float Timer::GetSimulationDelta() const
+{
+    Assert(m_timerFrequency != 0, "Timer frequency is invalid!");
+
+    return m_simulationDelta;
+}
+
 void Timer::SetMaxFrameDelta(float value)
 {
     Assert(m_timerFrequency != 0, "Timer frequency is invalid!");
@@ -66,3 +246,64 @@ float Timer::GetMaxFrameDelta() const
 
     return m_maxFrameDeltaSeconds;
 }
+
+void Timer::SetTargetFrameRate(float frameRate)
+{
+    Assert(m_timerFrequency != 0, "Timer frequency is invalid!");
+    Verify(frameRate >= 0.0f, "Invalid argument - \"frameRate\" is negative!");
+
+    m_targetFrameRate = frameRate;
+    m_targetFrameCounter = frameRate > 0.0f ? (uint64_t)(m_timerFrequency / (double)frameRate) : 0;
+
+    // Start pacing from the last tick.
+    m_frameDeadline = m_currentTimeCounter;
+
+    // Keep sleeps fine enough for pacing while it is enabled.
+    this->SetSleepResolution(m_targetFrameCounter != 0);
+}
+
+void Timer::SetSleepResolution(bool raised)
+{
+    if(m_sleepResolutionRaised == raised)
+        return;
+
+    // Sleeps are rounded up to the system timer period, which is too coarse for pacing on Windows by default.
+    #ifdef WIN32
+        if(raised)
+        {
+            timeBeginPeriod(1);
+        }
+        else
+        {
+            timeEndPeriod(1);
+        }
+    #endif
+
+    m_sleepResolutionRaised = raised;
+}
+
+float Timer::GetTargetFrameRate() const
+{
+    Assert(m_timerFrequency != 0, "Timer frequency is invalid!");
+
+    return m_targetFrameRate;
+}
+
+FrameTimeStats Timer::GetFrameTimeStats() const
+{
+    FrameTimeStats stats;
+    stats.frameCount = m_histogramCount;
+    stats.p50 = CalculatePercentile(m_histogram, m_histogramCount, 0.5f);
+    stats.p99 = CalculatePercentile(m_histogram, m_histogramCount, 0.99f);
+    stats.max = m_frameTimeMax;
+
+    return stats;
+}
+
+void Timer::ResetFrameTimeStats()
+{
+    std::fill(m_histogram.begin(), m_histogram.end(), 0);
+
+    m_histogramCount = 0;
+    m_frameTimeMax = 0.0f;
+}
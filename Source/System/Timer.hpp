@@ -8,11 +8,21 @@
     Keeps track of time and provides utilities such as automatic
     calculation of delta time between ticks and frame rate measurement.
 
+    Ticks can be paced to a target frame rate. Timer sleeps while the
+    next frame is far away and spins for the last stretch, as sleeps are
+    too coarse to hit the deadline. Deadlines follow each other by the
+    target frame time, so waiting errors do not accumulate. Simulation
+    delta is smoothed and snapped to the target frame time, so jitter of
+    measured time does not leak into movement. Time lost or gained by
+    snapping is carried forward, so simulation keeps up with real time.
+    Frame times are collected in a histogram to quantify stutter.
+
     void ExampleSystemTimer()
     {
         // Create a timer instance.
         // This also makes the timer tick once.
         System::Timer timer;
+        timer.SetTargetFrameRate(60.0f);
 
         // Run a loop that will measure delta time.
         while(true)
@@ -22,7 +32,8 @@
             Log() << "Current delta time: " << dt;
 
             // Perform some calculations over a frame and tick the timer.
-            Sleep(1000);
+            // Tick waits until the target frame time elapses.
+            Update(timer.GetSimulationDelta());
             timer.Tick();
         }
     }
@@ -30,6 +41,18 @@
 
 namespace System
 {
+    // Frame time stats structure.
+    // Times are in milliseconds.
+    struct FrameTimeStats
+    {
+        FrameTimeStats();
+
+        std::size_t frameCount;
+        float p50;
+        float p99;
+        float max;
+    };
+
     // Timer class.
     class Timer
     {
@@ -41,17 +64,48 @@ namespace System
         void Reset();
 
         // Ticks the timer.
+        // Waits until the target frame time elapses since the previous tick, if set.
         void Tick();
 
         // Calculates a frame delta time in seconds between last two ticks.
         float CalculateFrameDelta();
 
+        // Gets a smoothed frame delta time in seconds for advancing simulation.
+        float GetSimulationDelta() const;
+
         // Sets the maximum frame delta in seconds that can be returned.
         void SetMaxFrameDelta(float value);
 
         // Gets the maximum frame delta in seconds that can be returned.
         float GetMaxFrameDelta() const;
 
+        // Sets the target frame rate that ticks are paced to.
+        // Zero disables pacing.
+        void SetTargetFrameRate(float frameRate);
+
+        // Gets the target frame rate.
+        float GetTargetFrameRate() const;
+
+        // Gets frame time stats collected since the last reset.
+        FrameTimeStats GetFrameTimeStats() const;
+
+        // Resets collected frame time stats.
+        void ResetFrameTimeStats();
+
+    private:
+        // Waits until the deadline of the next frame.
+        void WaitForFrame();
+
+        // Records a frame time of the last tick.
+        void RecordFrame();
+
+        // Raises or restores the resolution of system sleeps.
+        void SetSleepResolution(bool raised);
+
+    private:
+        // Type declarations.
+        typedef std::vector<uint32_t> HistogramBuckets;
+
     private:
         // Internal timer values.
         uint64_t m_timerFrequency;
@@ -60,5 +114,24 @@ namespace System
 
         // Maximum accumulated frame delta.
         float m_maxFrameDeltaSeconds;
+
+        // Frame pacing values.
+        // Sleep estimate tracks the longest recent sleep, which the deadline has to be further away than.
+        float m_targetFrameRate;
+        uint64_t m_targetFrameCounter;
+        uint64_t m_frameDeadline;
+        uint64_t m_sleepEstimate;
+        bool m_sleepResolutionRaised;
+
+        // Simulation delta values.
+        // Drift accumulates the difference between measured and simulated time.
+        float m_smoothedDelta;
+        float m_simulationDelta;
+        float m_simulationDrift;
+
+        // Frame time histogram.
+        HistogramBuckets m_histogram;
+        std::size_t m_histogramCount;
+        float m_frameTimeMax;
     };
 }
@@ -8,6 +8,8 @@ WindowInfo::WindowInfo() :
     width(1024),
     height(576),
     vsync(true),
+    visible(true),
+    shareContext(nullptr),
     minWidth(GLFW_DONT_CARE),
     minHeight(GLFW_DONT_CARE),
     maxWidth(GLFW_DONT_CARE),
@@ -74,9 +76,14 @@ bool Window::Open(const WindowInfo& info)
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    // Hidden windows still provide a context, but nothing is shown on the screen.
+    glfwWindowHint(GLFW_VISIBLE, info.visible ? GLFW_TRUE : GLFW_FALSE);
+
     // Create a window.
     // This function call can randomly take twice as much memory after a system call to SetPixelFormat().
-    m_window = glfwCreateWindow(info.width, info.height, info.title.c_str(), nullptr, nullptr);
+    GLFWwindow* shareContext = info.shareContext != nullptr ? info.shareContext->GetPrivateHandle() : nullptr;
+
+    m_window = glfwCreateWindow(info.width, info.height, info.title.c_str(), nullptr, shareContext);
 
     if(m_window == nullptr)
     {
@@ -151,6 +158,17 @@ void Window::MakeContextCurrent()
     glfwMakeContextCurrent(m_window);
 }
 
+void Window::ReleaseContext()
+{
+    Verify(m_window != nullptr, "Window instance is not initialized!");
+
+    // Detach the context from the calling thread, so it can be made current on another.
+    if(glfwGetCurrentContext() == m_window)
+    {
+        glfwMakeContextCurrent(nullptr);
+    }
+}
+
 void Window::ProcessEvents()
 {
     Verify(m_window != nullptr, "Window instance is not initialized!");
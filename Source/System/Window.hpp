@@ -46,6 +46,9 @@
 
 namespace System
 {
+    // Forward declarations.
+    class Window;
+
     // Window info structure.
     struct WindowInfo
     {
@@ -55,6 +58,10 @@ namespace System
         int width;
         int height;
         bool vsync;
+        bool visible;
+
+        // Optional window whose context will share objects with the new one.
+        Window* shareContext;
 
         int minWidth;
         int minHeight;
@@ -75,6 +82,9 @@ namespace System
         // Makes window's context current.
         void MakeContextCurrent();
 
+        // Releases window's context if it is current on the calling thread.
+        void ReleaseContext();
+
         // Processes window events.
         void ProcessEvents();
 
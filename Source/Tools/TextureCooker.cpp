@@ -0,0 +1,92 @@
+/*
+    Author: Piotr Doan <doanpiotr@gmail.com>
+    Website: https://github.com/gunstarpl/
+    Copyright: All rights reserved, 2017-2018
+*/
+
+#include "Precompiled.hpp"
+#include "Graphics/Image.hpp"
+#include "Graphics/TextureContainer.hpp"
+
+/*
+    Texture Cooker
+
+    Converts PNG images into texture containers that can be loaded
+    without decoding, channel expansion and mipmap generation at runtime.
+
+    Usage: TextureCooker <input.png> <output.tex> [--no-mipmaps]
+*/
+
+namespace
+{
+    // Log error messages.
+    #define LogFatalError() "Fatal error has been encountered! "
+}
+
+int main(int argc, char* argv[])
+{
+    // Initialize debug routines.
+    Debug::Initialize();
+
+    // Initialize logging system.
+    Logger::Initialize();
+
+    // Read command line arguments.
+    std::string inputPath;
+    std::string outputPath;
+    bool mipmaps = true;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+
+        if(argument == "--no-mipmaps")
+        {
+            mipmaps = false;
+        }
+        else if(inputPath.empty())
+        {
+            inputPath = argument;
+        }
+        else if(outputPath.empty())
+        {
+            outputPath = argument;
+        }
+        else
+        {
+            Log() << LogFatalError() << "Unknown argument \"" << argument << "\".";
+            return -1;
+        }
+    }
+
+    if(inputPath.empty() || outputPath.empty())
+    {
+        Log() << "Usage: TextureCooker <input.png> <output.tex> [--no-mipmaps]";
+        return -1;
+    }
+
+    // Load the source image.
+    Graphics::Image image;
+    if(!image.Load(inputPath))
+    {
+        Log() << LogFatalError() << "Could not load the source image.";
+        return -1;
+    }
+
+    // Cook the texture container.
+    Graphics::TextureContainer container;
+    if(!container.Cook(image, mipmaps))
+    {
+        Log() << LogFatalError() << "Could not cook the texture container.";
+        return -1;
+    }
+
+    // Save the texture container.
+    if(!container.Save(outputPath))
+    {
+        Log() << LogFatalError() << "Could not save the texture container.";
+        return -1;
+    }
+
+    return 0;
+}